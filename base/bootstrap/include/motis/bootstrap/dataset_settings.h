@@ -26,12 +26,19 @@ struct dataset_settings : public conf::configuration,
     param(read_graph_, "read_graph", "Read binary schedule graph");
     param(read_graph_mmap_, "read_graph_mmap", "Read using memory mapped file");
     param(cache_graph_, "cache_graph", "Cache binary schedule graph");
+    param(compress_graph_, "compress_graph",
+          "Write the graph as chunked compressed file (decompressed in "
+          "parallel on read, read_graph_mmap does not apply). Writing needs "
+          "the uncompressed graph size as temporary disk space, reading "
+          "needs it in memory");
     param(apply_rules_, "apply_rules",
           "Apply special rules (through-services, merge-split-services)");
     param(adjust_footpaths_, "adjust_footpaths",
           "Remove footpaths if they do not fit an assumed average speed");
     param(expand_footpaths_, "expand_footpaths",
           "Calculate expanded footpaths");
+    param(max_footpath_length_, "max_footpath_length",
+          "Max. duration of expanded footpaths (minutes)");
     param(use_platforms_, "use_platforms",
           "Use separate interchange times for trips stopping at the same "
           "platform");
@@ -46,6 +53,10 @@ struct dataset_settings : public conf::configuration,
     param(wzr_matrix_path_, "wzr_matrix_path", "waiting time matrix");
     param(no_local_transport_, "no_local_transport",
           "don't load local transport");
+    param(landmarks_, "landmarks",
+          "landmark station ids for ALT lower bounds (routing)");
+    param(landmark_count_, "landmark_count",
+          "number of landmarks (selected farthest-first after the given ones)");
   }
 };
 
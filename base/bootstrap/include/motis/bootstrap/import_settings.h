@@ -17,6 +17,11 @@ struct import_settings : conf::configuration {
     param(data_directory_, "data_dir", "directory for preprocessing output");
     param(require_successful_, "require_successful",
           "exit if import is not successful for all modules");
+    param(num_threads_, "num_threads",
+          "number of imports running concurrently (1 = sequential)");
+    param(thread_budget_, "thread_budget",
+          "threads reserved by a module import, format: module:threads "
+          "(default: 1)");
   }
 
   import_settings(import_settings const&) = delete;
@@ -28,6 +33,8 @@ struct import_settings : conf::configuration {
   std::vector<std::string> import_paths_;
   std::string data_directory_{"data"};
   bool require_successful_{true};
+  unsigned num_threads_{1U};
+  std::vector<std::string> thread_budget_;
 };
 
 }  // namespace motis::bootstrap
\ No newline at end of file
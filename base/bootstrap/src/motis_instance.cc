@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <fstream>
 #include <iostream>
 
 #include "boost/filesystem.hpp"
@@ -22,6 +23,7 @@
 
 using namespace motis::module;
 using namespace motis::logging;
+namespace fs = boost::filesystem;
 
 namespace motis::bootstrap {
 
@@ -71,6 +73,15 @@ void motis_instance::import(module_settings const& module_opt,
   auto bars = utl::global_progress_bars{silent};
 
   auto dispatcher = import_dispatcher{};
+  dispatcher.num_threads_ = import_opt.num_threads_;
+  for (auto const& budget : import_opt.thread_budget_) {
+    auto const sep = budget.find(':');
+    utl::verify(sep != std::string::npos,
+                "invalid import thread budget {} (expected module:threads)",
+                budget);
+    dispatcher.set_thread_budget(budget.substr(0, sep),
+                                 std::stoul(budget.substr(sep + 1)));
+  }
 
   register_import_files(dispatcher);
   register_import_schedule(*this, dispatcher, dataset_opt,
@@ -91,6 +102,13 @@ void motis_instance::import(module_settings const& module_opt,
   dispatcher.publish(make_file_event(import_opt.import_paths_));
   dispatcher.run();
 
+  {
+    auto const logs_path = fs::path{import_opt.data_directory_} / "log";
+    fs::create_directories(logs_path);
+    std::ofstream out{(logs_path / "import_timeline.txt").generic_string()};
+    dispatcher.print_timeline(out);
+  }
+
   registry_.reset();
 
   utl::verify(includes(to_res_id(global_res_id::SCHEDULE)),
@@ -0,0 +1,106 @@
+// Compares cold cache load times and file sizes of a serialized graph:
+// raw mmap (+ touching all pages), raw read and chunked compressed read.
+//
+// usage: motis-graph-bench <graph> [chunk size (MiB)] [compression level]
+//
+// The page cache is dropped for the files before every run (Linux only,
+// posix_fadvise). Writes the compressed copy to <graph>.cz.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "boost/filesystem.hpp"
+
+#include "cista/mmap.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "motis/core/common/compressed_file.h"
+#include "motis/core/common/timing.h"
+#include "motis/core/schedule/serialization.h"
+
+namespace fs = boost::filesystem;
+using namespace motis;
+
+namespace {
+
+void drop_page_cache(std::string const& path) {
+#ifdef __linux__
+  auto const fd = open(path.c_str(), O_RDONLY);
+  if (fd != -1) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#else
+  std::cerr << "warning: page cache not dropped (" << path << ")\n";
+#endif
+}
+
+template <typename Fn>
+void run(char const* name, std::string const& path, Fn&& fn) {
+  drop_page_cache(path);
+  MOTIS_START_TIMING(load);
+  fn();
+  MOTIS_STOP_TIMING(load);
+  std::cout << name << ": " << fs::file_size(path) / (1024 * 1024) << " MiB, "
+            << MOTIS_TIMING_MS(load) << " ms\n";
+}
+
+}  // namespace
+
+int main(int argc, char const** argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <graph> [chunk size (MiB)] [compression level]\n";
+    return 1;
+  }
+
+  auto const graph_path = std::string{argv[1]};
+  auto const compressed_path = graph_path + ".cz";
+  auto const chunk_size =
+      argc > 2 ? std::stoul(argv[2]) << 20U : DEFAULT_COMPRESSED_CHUNK_SIZE;
+  auto const level = argc > 3 ? std::stoi(argv[3]) : 1;
+
+  {
+    auto const raw =
+        cista::mmap{graph_path.c_str(), cista::mmap::protection::READ};
+    MOTIS_START_TIMING(compress);
+    write_compressed_file(
+        compressed_path,
+        std::string_view{reinterpret_cast<char const*>(raw.data()),
+                         raw.size()},
+        chunk_size, level);
+    MOTIS_STOP_TIMING(compress);
+    std::cout << "compression (chunk size " << (chunk_size >> 20U)
+              << " MiB, level " << level << "): " << MOTIS_TIMING_MS(compress)
+              << " ms\n";
+  }
+
+  run("raw mmap", graph_path, [&]() {
+    cista::memory_holder mem;
+    auto const sched = read_graph(graph_path, mem, true);
+    auto const& buf = std::get<cista::buf<cista::mmap>>(mem);
+    auto volatile sum = 0U;
+    for (auto i = 0U; i < buf.size(); i += 4096U) {
+      sum += buf[i];
+    }
+  });
+
+  run("raw read", graph_path, [&]() {
+    cista::memory_holder mem;
+    auto const sched = read_graph(graph_path, mem, false);
+  });
+
+  run("compressed", compressed_path, [&]() {
+    cista::memory_holder mem;
+    auto const sched = read_graph(compressed_path, mem, false);
+  });
+
+  return 0;
+}
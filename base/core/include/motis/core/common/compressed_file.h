@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "cista/buffer.h"
+
+namespace motis {
+
+// Chunked compressed file (deflate, miniz):
+//   header | compressed chunk sizes (uint64_t each) | chunks
+// Chunks are compressed and decompressed independently (in parallel).
+struct compressed_file_header {
+  static constexpr auto const MAGIC = uint64_t{0x315A435349544F4D};  // MOTISCZ1
+
+  uint64_t magic_{MAGIC};
+  uint64_t raw_size_{0U};
+  uint64_t chunk_size_{0U};
+  uint64_t chunk_count_{0U};
+};
+
+constexpr auto const DEFAULT_COMPRESSED_CHUNK_SIZE = std::size_t{16U} << 20U;
+
+bool is_compressed_file(std::string const& path);
+
+void write_compressed_file(
+    std::string const& path, std::string_view data,
+    std::size_t chunk_size = DEFAULT_COMPRESSED_CHUNK_SIZE, int level = 1);
+
+cista::buffer read_compressed_file(std::string const& path);
+
+}  // namespace motis
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cinttypes>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace motis {
+
+// Default size of a cache entry: the capacity is a number of entries.
+struct lru_entry_count {
+  template <typename V>
+  std::size_t operator()(V const&) const {
+    return 1U;
+  }
+};
+
+struct lru_cache_stats {
+  std::size_t entries_{0U};
+  std::size_t size_{0U};
+  uint64_t hits_{0U}, misses_{0U}, evictions_{0U};
+};
+
+// Thread safe least recently used cache.
+// Entries are evicted once the summed Size(value) exceeds the capacity
+// (Size: V const& -> std::size_t, e.g. bytes). Capacity 0 disables caching.
+template <typename K, typename V, typename Size = lru_entry_count,
+          typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+struct lru_cache {
+  explicit lru_cache(std::size_t const capacity, Size size = Size{})
+      : capacity_{capacity}, size_fn_{std::move(size)} {}
+
+  std::optional<V> get(K const& key) {
+    return get(key, [](V const&) { return true; });
+  }
+
+  // Only entries for which accept(value) holds count as hit.
+  template <typename Accept>
+  std::optional<V> get(K const& key, Accept&& accept) {
+    std::lock_guard const lock{mutex_};
+    auto const it = entries_.find(key);
+    if (it == end(entries_) || !accept(it->second.value_)) {
+      ++misses_;
+      return std::nullopt;
+    }
+    lru_.splice(begin(lru_), lru_, it->second.lru_pos_);
+    ++hits_;
+    return it->second.value_;
+  }
+
+  // Keeps an existing entry (e.g. computed concurrently by another request).
+  void put(K const& key, V value) { insert(key, std::move(value), false); }
+
+  // Replaces an existing entry.
+  void insert_or_assign(K const& key, V value) {
+    insert(key, std::move(value), true);
+  }
+
+  void clear() {
+    std::lock_guard const lock{mutex_};
+    entries_.clear();
+    lru_.clear();
+    size_ = 0U;
+  }
+
+  lru_cache_stats stats() const {
+    std::lock_guard const lock{mutex_};
+    return {entries_.size(), size_, hits_, misses_, evictions_};
+  }
+
+  std::size_t capacity() const { return capacity_; }
+
+private:
+  struct entry {
+    V value_;
+    typename std::list<K>::iterator lru_pos_;
+  };
+
+  void insert(K const& key, V value, bool const replace) {
+    if (capacity_ == 0U) {
+      return;
+    }
+
+    std::lock_guard const lock{mutex_};
+    if (auto const it = entries_.find(key); it != end(entries_)) {
+      if (replace) {
+        size_ -= size_fn_(it->second.value_);
+        it->second.value_ = std::move(value);
+        size_ += size_fn_(it->second.value_);
+        lru_.splice(begin(lru_), lru_, it->second.lru_pos_);
+        evict();
+      }
+      return;
+    }
+
+    lru_.push_front(key);
+    auto const it =
+        entries_.emplace(key, entry{std::move(value), begin(lru_)}).first;
+    size_ += size_fn_(it->second.value_);
+    evict();
+  }
+
+  void evict() {
+    while (size_ > capacity_ && !lru_.empty()) {
+      auto const it = entries_.find(lru_.back());
+      size_ -= size_fn_(it->second.value_);
+      entries_.erase(it);
+      lru_.pop_back();
+      ++evictions_;
+    }
+  }
+
+  std::size_t capacity_;
+  Size size_fn_;
+
+  mutable std::mutex mutex_;
+  std::list<K> lru_;  // most recently used first
+  std::unordered_map<K, entry, Hash, Eq> entries_;
+  std::size_t size_{0U};
+
+  uint64_t hits_{0U}, misses_{0U}, evictions_{0U};
+};
+
+}  // namespace motis
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cinttypes>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "cista/hash.h"
+
+#include "motis/core/common/lru_cache.h"
+#include "motis/core/common/timing.h"
+#include "motis/core/statistics/statistics.h"
+
+namespace motis {
+
+// Size-bounded LRU cache for rendered (already compressed) vector tiles.
+// Empty tiles are cached as nullptr.
+struct tile_cache {
+  using tile_ptr = std::shared_ptr<std::string const>;
+  using key_t = std::tuple<uint32_t, uint32_t, uint32_t>;  // z, x, y
+
+  explicit tile_cache(std::size_t const max_bytes) : cache_{max_bytes} {}
+
+  // Render: () -> std::optional<std::string>
+  template <typename Render>
+  tile_ptr get_or_render(uint32_t const z, uint32_t const x, uint32_t const y,
+                         Render&& render) {
+    auto const key = key_t{z, x, y};
+    if (auto tile = cache_.get(key); tile.has_value()) {
+      return *tile;
+    }
+
+    MOTIS_START_TIMING(render_timing);
+    auto rendered = render();
+    MOTIS_STOP_TIMING(render_timing);
+    render_time_us_ += static_cast<uint64_t>(MOTIS_TIMING_US(render_timing));
+    ++rendered_;
+
+    auto tile = rendered.has_value()
+                    ? std::make_shared<std::string const>(std::move(*rendered))
+                    : tile_ptr{};
+    rendered_bytes_ += tile_size{}(tile);
+    cache_.put(key, tile);  // keeps a tile rendered concurrently
+    return tile;
+  }
+
+  stats_category get_stats(std::string const& name) const {
+    auto const stats = cache_.stats();
+    return stats_category{name,
+                          {{"entries", stats.entries_},
+                           {"bytes", stats.size_},
+                           {"hits", stats.hits_},
+                           {"misses", stats.misses_},
+                           {"evictions", stats.evictions_},
+                           {"rendered", rendered_},
+                           {"rendered_bytes", rendered_bytes_},
+                           {"render_time_us", render_time_us_}}};
+  }
+
+private:
+  struct key_hash {
+    std::size_t operator()(key_t const& k) const {
+      return cista::hash_combine(cista::BASE_HASH, std::get<0>(k),
+                                 std::get<1>(k), std::get<2>(k));
+    }
+  };
+
+  struct tile_size {
+    std::size_t operator()(tile_ptr const& tile) const {
+      return tile == nullptr ? 0U : tile->size();
+    }
+  };
+
+  lru_cache<key_t, tile_ptr, tile_size, key_hash> cache_;
+
+  std::atomic_uint64_t rendered_{0U}, rendered_bytes_{0U}, render_time_us_{0U};
+};
+
+}  // namespace motis
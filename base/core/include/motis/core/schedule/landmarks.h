@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "motis/vector.h"
+
+#include "motis/core/schedule/time.h"
+
+namespace motis {
+
+// Station graph distances from/to a small set of landmark stations
+// (ALT lower bounds). Stored station-major: [station_idx * count() + i].
+struct landmarks {
+  static constexpr auto const MAX_DIST = duration{4U * 1440U};
+  static constexpr auto const INVALID_DIST =
+      std::numeric_limits<duration>::max();  // > MAX_DIST
+
+  std::size_t count() const { return stations_.size(); }
+  bool empty() const { return stations_.empty(); }
+
+  // Number of stations with landmark distances. Stations added later (RT)
+  // are not covered.
+  std::size_t station_count() const {
+    return empty() ? 0U : to_landmark_.size() / count();
+  }
+
+  // Called when the travel time lower bound graph gets shorter (RT):
+  // the stored distances would no longer yield admissible bounds.
+  void invalidate() {
+    stations_.clear();
+    to_landmark_.clear();
+    from_landmark_.clear();
+  }
+
+  duration to_landmark(uint32_t const station_idx, std::size_t const i) const {
+    return to_landmark_[station_idx * count() + i];
+  }
+
+  duration from_landmark(uint32_t const station_idx,
+                         std::size_t const i) const {
+    return from_landmark_[station_idx * count() + i];
+  }
+
+  mcd::vector<uint32_t> stations_;
+  mcd::vector<duration> to_landmark_;
+  mcd::vector<duration> from_landmark_;
+};
+
+}  // namespace motis
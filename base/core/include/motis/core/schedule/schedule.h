@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <ctime>
 
 #include "cista/hash.h"
@@ -19,6 +21,7 @@
 #include "motis/core/schedule/delay_info.h"
 #include "motis/core/schedule/event.h"
 #include "motis/core/schedule/free_text.h"
+#include "motis/core/schedule/landmarks.h"
 #include "motis/core/schedule/nodes.h"
 #include "motis/core/schedule/provider.h"
 #include "motis/core/schedule/station.h"
@@ -51,6 +54,7 @@ struct schedule {
   constant_graph travel_time_lower_bounds_bwd_;
   constant_graph transfers_lower_bounds_fwd_;
   constant_graph transfers_lower_bounds_bwd_;
+  landmarks landmarks_;
   node_id_t next_node_id_{0U};
   node_id_t non_station_node_offset_{1'000'000U};
   uint32_t route_count_{0U};
@@ -93,8 +97,18 @@ using schedule_ptr = mcd::unique_ptr<schedule>;
 struct schedule_data {
   schedule_data(cista::memory_holder&& buf, schedule_ptr&& sched)
       : schedule_buf_{std::move(buf)}, schedule_{std::move(sched)} {}
+
+  static uint64_t next_generation() {
+    static std::atomic<uint64_t> generation{0U};
+    return ++generation;
+  }
+
   cista::memory_holder schedule_buf_;
   schedule_ptr schedule_;
+
+  // Unique for every loaded/copied schedule in this process. Unlike the
+  // schedule address or its resource id, it is never reused.
+  uint64_t generation_{next_generation()};
 };
 
 }  // namespace motis
@@ -6,10 +6,16 @@
 
 namespace motis {
 
+// Compressed graphs (see compressed_file.h) are detected by their header and
+// decompressed into memory, read_mmap is ignored for them.
 schedule_ptr read_graph(std::string const& path, cista::memory_holder&,
                         bool read_mmap);
 
-void write_graph(std::string const& path, schedule const&);
+// compress: the uncompressed graph is serialized into a temporary file
+// (<path>.raw, removed afterwards) first, which needs the uncompressed graph
+// size as additional disk space. Only the compressed chunks are kept in memory.
+void write_graph(std::string const& path, schedule const&,
+                 bool compress = false);
 
 schedule_data copy_graph(schedule const& sched);
 
@@ -0,0 +1,116 @@
+#include "motis/core/common/compressed_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "miniz.h"
+
+#include "cista/mmap.h"
+
+#include "utl/parallel_for.h"
+#include "utl/verify.h"
+
+namespace motis {
+
+constexpr auto const kMaxDeflateRatio = uint64_t{1032U};
+
+bool is_compressed_file(std::string const& path) {
+  auto header = compressed_file_header{};
+  std::ifstream in{path, std::ios::binary};
+  return in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+         header.magic_ == compressed_file_header::MAGIC;
+}
+
+void write_compressed_file(std::string const& path, std::string_view data,
+                           std::size_t const chunk_size, int const level) {
+  utl::verify(chunk_size != 0U, "compressed file: chunk size 0");
+
+  auto header = compressed_file_header{};
+  header.raw_size_ = data.size();
+  header.chunk_size_ = chunk_size;
+  header.chunk_count_ = (data.size() + chunk_size - 1U) / chunk_size;
+
+  std::vector<std::vector<unsigned char>> chunks(header.chunk_count_);
+  utl::parallel_for_run(chunks.size(), [&](auto const i) {
+    auto const in = data.substr(i * chunk_size, chunk_size);
+    auto& out = chunks[i];
+    auto out_size = mz_compressBound(static_cast<mz_ulong>(in.size()));
+    out.resize(out_size);
+    auto const ret =
+        mz_compress2(out.data(), &out_size,
+                     reinterpret_cast<unsigned char const*>(in.data()),
+                     static_cast<mz_ulong>(in.size()), level);
+    utl::verify(ret == MZ_OK, "compressed file: compression failed ({})", ret);
+    out.resize(out_size);
+  });
+
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  utl::verify(out.is_open(), "compressed file: cannot open {}", path);
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  for (auto const& c : chunks) {
+    auto const size = static_cast<uint64_t>(c.size());
+    out.write(reinterpret_cast<char const*>(&size), sizeof(size));
+  }
+  for (auto const& c : chunks) {
+    out.write(reinterpret_cast<char const*>(c.data()),
+              static_cast<std::streamsize>(c.size()));
+  }
+  utl::verify(out.good(), "compressed file: write failed {}", path);
+}
+
+cista::buffer read_compressed_file(std::string const& path) {
+  auto const file = cista::mmap{path.c_str(), cista::mmap::protection::READ};
+  auto const file_size = file.size();
+
+  auto header = compressed_file_header{};
+  utl::verify(file_size >= sizeof(header), "compressed file: truncated {}",
+              path);
+  std::memcpy(&header, file.data(), sizeof(header));
+  utl::verify(header.magic_ == compressed_file_header::MAGIC,
+              "compressed file: bad magic {}", path);
+
+  // Validate the header before allocating or decompressing anything.
+  utl::verify(header.chunk_size_ != 0U, "compressed file: chunk size 0 {}",
+              path);
+  utl::verify(header.chunk_count_ ==
+                  header.raw_size_ / header.chunk_size_ +
+                      (header.raw_size_ % header.chunk_size_ != 0U ? 1U : 0U),
+              "compressed file: chunk count mismatch {}", path);
+  utl::verify(header.chunk_count_ <=
+                  (file_size - sizeof(header)) / sizeof(uint64_t),
+              "compressed file: truncated {}", path);
+  // deflate does not expand data by more than ~1:1032
+  utl::verify(header.raw_size_ / kMaxDeflateRatio <= file_size,
+              "compressed file: invalid raw size {}", path);
+
+  auto const table_end =
+      sizeof(header) + header.chunk_count_ * sizeof(uint64_t);
+  std::vector<uint64_t> offsets(header.chunk_count_ + 1U);
+  offsets[0] = table_end;
+  for (auto i = 0U; i != header.chunk_count_; ++i) {
+    auto size = uint64_t{};
+    std::memcpy(&size, file.data() + sizeof(header) + i * sizeof(uint64_t),
+                sizeof(size));
+    utl::verify(size <= file_size - offsets[i],
+                "compressed file: chunk {} out of bounds {}", i, path);
+    offsets[i + 1U] = offsets[i] + size;
+  }
+
+  auto buf = cista::buffer{header.raw_size_};
+  utl::parallel_for_run(header.chunk_count_, [&](auto const i) {
+    auto const raw_offset = i * header.chunk_size_;
+    auto const expected_size =
+        std::min(header.chunk_size_, header.raw_size_ - raw_offset);
+    auto out_size = static_cast<mz_ulong>(expected_size);
+    auto const ret = mz_uncompress(
+        buf.data() + raw_offset, &out_size, file.data() + offsets[i],
+        static_cast<mz_ulong>(offsets[i + 1U] - offsets[i]));
+    utl::verify(ret == MZ_OK && out_size == expected_size,
+                "compressed file: corrupt chunk {} ({})", i, ret);
+  });
+  return buf;
+}
+
+}  // namespace motis
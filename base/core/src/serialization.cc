@@ -1,7 +1,11 @@
 #include "motis/core/schedule/serialization.h"
 
+#include <cstdio>
+#include <string_view>
+
 #include "cista/serialization.h"
 
+#include "motis/core/common/compressed_file.h"
 #include "motis/core/common/dynamic_fws_multimap.h"
 #include "motis/core/common/logging.h"
 
@@ -132,7 +136,10 @@ overloaded(Ts...) -> overloaded<Ts...>;
 
 schedule_ptr read_graph(std::string const& path, cista::memory_holder& mem,
                         bool const read_mmap) {
-  if (read_mmap) {
+  if (is_compressed_file(path)) {
+    logging::scoped_timer t{"decompressing graph"};
+    mem = read_compressed_file(path);
+  } else if (read_mmap) {
     auto mmap = cista::mmap{path.c_str(), cista::mmap::protection::READ};
     mem = cista::buf<cista::mmap>(std::move(mmap));
   } else {
@@ -156,7 +163,28 @@ schedule_ptr read_graph(std::string const& path, cista::memory_holder& mem,
   return ptr;
 }
 
-void write_graph(std::string const& path, schedule const& sched) {
+void write_graph(std::string const& path, schedule const& sched,
+                 bool const compress) {
+  if (compress) {
+    logging::scoped_timer t{"writing compressed graph"};
+
+    // Serialize into a temporary memory mapped file instead of a heap buffer:
+    // the uncompressed graph is paged out to disk as needed and does not have
+    // to fit into memory next to the schedule.
+    auto const raw_path = path + ".raw";
+    {
+      auto writer = cista::buf<cista::mmap>(
+          cista::mmap{raw_path.c_str(), cista::mmap::protection::WRITE});
+      cista::serialize<MODE>(writer, sched);
+      write_compressed_file(
+          path,
+          std::string_view{reinterpret_cast<char const*>(writer.buf_.data()),
+                           writer.size()});
+    }
+    std::remove(raw_path.c_str());
+    return;
+  }
+
   auto mmap = cista::mmap{path.c_str(), cista::mmap::protection::WRITE};
   auto writer = cista::buf<cista::mmap>(std::move(mmap));
 
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "motis/core/common/compressed_file.h"
+
+namespace motis {
+
+TEST(core_compressed_file, roundtrip) {
+  auto const path = std::string{"core_compressed_file_test.bin"};
+
+  std::string data;
+  for (auto i = 0U; i != 10000U; ++i) {
+    data += std::to_string(i * i % 97);
+  }
+
+  // chunk size not a divisor of the size: last chunk is shorter
+  write_compressed_file(path, data, 1000U);
+  ASSERT_TRUE(is_compressed_file(path));
+
+  auto const buf = read_compressed_file(path);
+  EXPECT_EQ(data, std::string_view(reinterpret_cast<char const*>(buf.data()),
+                                   buf.size()));
+
+  std::remove(path.c_str());
+  EXPECT_FALSE(is_compressed_file(path));
+}
+
+namespace {
+
+void patch_u64(std::string const& path, std::size_t const offset,
+               uint64_t const value) {
+  std::fstream f{path, std::ios::binary | std::ios::in | std::ios::out};
+  f.seekp(static_cast<std::streamoff>(offset));
+  f.write(reinterpret_cast<char const*>(&value), sizeof(value));
+}
+
+}  // namespace
+
+TEST(core_compressed_file, corrupt_header) {
+  auto const path = std::string{"core_compressed_file_corrupt_test.bin"};
+  auto const data = std::string(5000U, 'x');
+  auto const chunk_count_offset = offsetof(compressed_file_header, chunk_count_);
+  auto const chunk_size_offset = offsetof(compressed_file_header, chunk_size_);
+  auto const raw_size_offset = offsetof(compressed_file_header, raw_size_);
+
+  auto const expect_throw = [&](std::size_t const offset,
+                                uint64_t const value) {
+    write_compressed_file(path, data, 1000U);
+    ASSERT_NO_THROW(read_compressed_file(path));
+    patch_u64(path, offset, value);
+    EXPECT_ANY_THROW(read_compressed_file(path));
+  };
+
+  expect_throw(chunk_size_offset, 0U);
+  expect_throw(chunk_count_offset, 4U);
+  expect_throw(chunk_count_offset, uint64_t{1U} << 62U);
+  expect_throw(raw_size_offset, uint64_t{1U} << 40U);
+  expect_throw(raw_size_offset, 4500U);  // last chunk decompresses to 1000
+  // first chunk size entry points past the end of the file
+  expect_throw(sizeof(compressed_file_header), uint64_t{1U} << 62U);
+  expect_throw(sizeof(compressed_file_header), ~uint64_t{0U});
+
+  std::remove(path.c_str());
+}
+
+}  // namespace motis
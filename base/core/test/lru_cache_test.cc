@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "motis/core/common/lru_cache.h"
+
+namespace motis {
+
+TEST(core_lru_cache, hit_miss_evict) {
+  lru_cache<int, std::string> cache{2U};
+
+  EXPECT_FALSE(cache.get(1).has_value());
+  cache.put(1, "a");
+  cache.put(2, "b");
+  EXPECT_EQ("a", cache.get(1));  // 1 is now the most recently used entry
+
+  cache.put(3, "c");  // evicts 2
+  EXPECT_FALSE(cache.get(2).has_value());
+  EXPECT_EQ("a", cache.get(1));
+  EXPECT_EQ("c", cache.get(3));
+
+  auto const stats = cache.stats();
+  EXPECT_EQ(2U, stats.entries_);
+  EXPECT_EQ(2U, stats.size_);
+  EXPECT_EQ(3U, stats.hits_);
+  EXPECT_EQ(2U, stats.misses_);
+  EXPECT_EQ(1U, stats.evictions_);
+}
+
+TEST(core_lru_cache, put_keeps_insert_or_assign_replaces) {
+  lru_cache<int, std::string> cache{2U};
+  cache.put(1, "a");
+  cache.put(1, "b");
+  EXPECT_EQ("a", cache.get(1));
+  cache.insert_or_assign(1, "c");
+  EXPECT_EQ("c", cache.get(1));
+  EXPECT_EQ(1U, cache.stats().entries_);
+}
+
+TEST(core_lru_cache, accept) {
+  lru_cache<int, int> cache{2U};
+  cache.put(1, -1);
+  EXPECT_FALSE(cache.get(1, [](int const v) { return v >= 0; }).has_value());
+  EXPECT_EQ(-1, cache.get(1));
+  EXPECT_EQ(1U, cache.stats().misses_);
+}
+
+TEST(core_lru_cache, size_bound) {
+  auto const bytes = [](std::string const& s) { return s.size(); };
+  lru_cache<int, std::string, decltype(bytes)> cache{10U, bytes};
+
+  cache.put(1, "1234");
+  cache.put(2, "5678");
+  EXPECT_EQ(8U, cache.stats().size_);
+
+  cache.put(3, "abcd");  // 12 bytes > 10: evicts 1
+  EXPECT_FALSE(cache.get(1).has_value());
+  EXPECT_EQ(8U, cache.stats().size_);
+
+  cache.insert_or_assign(2, "123456789");  // 13 bytes: evicts 3
+  EXPECT_FALSE(cache.get(3).has_value());
+  EXPECT_EQ("123456789", cache.get(2));
+  EXPECT_EQ(9U, cache.stats().size_);
+
+  cache.put(4, "too large for the cache");  // evicts everything
+  EXPECT_EQ(0U, cache.stats().entries_);
+  EXPECT_EQ(0U, cache.stats().size_);
+}
+
+TEST(core_lru_cache, disabled_and_clear) {
+  lru_cache<int, int> disabled{0U};
+  disabled.put(1, 1);
+  EXPECT_FALSE(disabled.get(1).has_value());
+
+  lru_cache<int, int> cache{4U};
+  cache.put(1, 1);
+  cache.put(2, 2);
+  cache.clear();
+  EXPECT_FALSE(cache.get(1).has_value());
+  EXPECT_EQ(0U, cache.stats().size_);
+}
+
+}  // namespace motis
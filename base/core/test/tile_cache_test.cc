@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+#include <optional>
+#include <string>
+
+#include "motis/core/common/tile_cache.h"
+
+namespace motis {
+
+TEST(core_tile_cache, hit_miss_evict) {
+  tile_cache cache{10};
+  auto renders = 0U;
+  auto const render = [&](std::string s) {
+    return [&renders, s]() -> std::optional<std::string> {
+      ++renders;
+      return s.empty() ? std::nullopt : std::optional{s};
+    };
+  };
+
+  EXPECT_EQ("abcd", *cache.get_or_render(1, 0, 0, render("abcd")));
+  EXPECT_EQ("abcd", *cache.get_or_render(1, 0, 0, render("xxxx")));
+  EXPECT_EQ(1U, renders);
+
+  EXPECT_EQ(nullptr, cache.get_or_render(1, 1, 0, render("")));
+  EXPECT_EQ(nullptr, cache.get_or_render(1, 1, 0, render("yyyy")));
+  EXPECT_EQ(2U, renders);
+
+  // 4 + 0 + 8 bytes > 10: least recently used tile (1, 0, 0) is evicted
+  EXPECT_EQ("12345678", *cache.get_or_render(2, 0, 0, render("12345678")));
+  EXPECT_EQ("new!", *cache.get_or_render(1, 0, 0, render("new!")));
+  EXPECT_EQ(4U, renders);
+}
+
+}  // namespace motis
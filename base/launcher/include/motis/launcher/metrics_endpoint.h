@@ -0,0 +1,10 @@
+#pragma once
+
+#include "motis/module/registry.h"
+
+namespace motis::launcher {
+
+// GET /metrics: request metrics of all operations (Prometheus text format)
+void register_metrics_endpoint(motis::module::registry&);
+
+}  // namespace motis::launcher
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "conf/configuration.h"
+
+namespace motis::launcher {
+
+struct query_recorder_settings : public conf::configuration {
+  query_recorder_settings()
+      : configuration("Slow Query Recorder Options", "slow_queries") {
+    param(path_, "path",
+          "record slow requests to this file (empty = disabled, replayable "
+          "with batch mode)");
+    param(threshold_, "threshold", "record requests taking longer (ms)");
+    param(sample_rate_, "sample_rate",
+          "additionally record this fraction of all requests (0 - 1)");
+    param(targets_, "targets", "targets to record (empty = all)");
+    param(max_file_size_, "max_file_size", "rotate after (MB)");
+    param(max_files_, "max_files", "number of files to keep (incl. current)");
+  }
+
+  std::string path_;
+  unsigned threshold_{1000U};
+  double sample_rate_{0.0};
+  std::vector<std::string> targets_{"/routing", "/intermodal"};
+  unsigned max_file_size_{100U};
+  unsigned max_files_{5U};
+};
+
+}  // namespace motis::launcher
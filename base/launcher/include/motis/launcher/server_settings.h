@@ -22,6 +22,8 @@ struct server_settings : public conf::configuration {
     param(api_key_, "api_key", "API key (empty = no protection)");
     param(log_path_, "log_path", "log requests to file (empty = no logging)");
     param(static_path_, "static_path", "path to ui/web (compiled)");
+    param(metrics_, "metrics",
+          "serve request metrics at /metrics (Prometheus text format)");
   }
 
   std::string host_{"0.0.0.0"}, port_{"8080"};
@@ -32,6 +34,7 @@ struct server_settings : public conf::configuration {
   std::string api_key_;
   std::string log_path_;
   std::string static_path_;
+  bool metrics_{true};
 };
 
 }  // namespace motis::launcher
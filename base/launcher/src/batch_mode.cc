@@ -50,13 +50,15 @@ public:
   }
 
 private:
+  // Skips empty lines and comments (e.g. slow query recorder metadata).
   msg_ptr next_query() {
-    if (in_.eof() || in_.peek() == EOF) {
-      return nullptr;
-    }
-
     std::string json;
-    std::getline(in_, json);
+    while (json.empty() || json.front() == '#') {
+      if (in_.eof() || in_.peek() == EOF) {
+        return nullptr;
+      }
+      std::getline(in_, json);
+    }
     return make_msg(json);
   }
 
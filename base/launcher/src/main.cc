@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -26,6 +27,8 @@
 #include "motis/bootstrap/remote_settings.h"
 #include "motis/launcher/batch_mode.h"
 #include "motis/launcher/launcher_settings.h"
+#include "motis/launcher/metrics_endpoint.h"
+#include "motis/launcher/query_recorder_settings.h"
 #include "motis/launcher/server_settings.h"
 #include "motis/launcher/web_server.h"
 
@@ -59,10 +62,11 @@ int main(int argc, char const** argv) {
   module_settings module_opt(instance.module_names());
   remote_settings remote_opt;
   launcher_settings launcher_opt;
+  query_recorder_settings recorder_opt;
 
-  std::vector<conf::configuration*> confs = {&server_opt,  &import_opt,
-                                             &dataset_opt, &module_opt,
-                                             &remote_opt,  &launcher_opt};
+  std::vector<conf::configuration*> confs = {
+      &server_opt, &import_opt,   &dataset_opt, &module_opt,
+      &remote_opt, &launcher_opt, &recorder_opt};
   for (auto const& module : instance.modules()) {
     confs.push_back(module);
   }
@@ -103,7 +107,21 @@ int main(int argc, char const** argv) {
     instance.init_modules(module_opt, launcher_opt.num_threads_);
     instance.init_remotes(remote_opt.get_remotes());
 
+    if (!recorder_opt.path_.empty()) {
+      instance.query_recorder_ =
+          std::make_unique<query_recorder>(query_recorder::config{
+              recorder_opt.path_,
+              std::chrono::milliseconds{recorder_opt.threshold_},
+              recorder_opt.sample_rate_, recorder_opt.targets_,
+              std::size_t{recorder_opt.max_file_size_} * 1024U * 1024U,
+              recorder_opt.max_files_});
+    }
+
     if (launcher_opt.mode_ == launcher_settings::motis_mode_t::SERVER) {
+      if (server_opt.metrics_) {
+        register_metrics_endpoint(instance);
+      }
+
       boost::system::error_code ec;
       server.listen(server_opt.host_, server_opt.port_,
 #if defined(NET_TLS)
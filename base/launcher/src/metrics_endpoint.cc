@@ -0,0 +1,34 @@
+#include "motis/launcher/metrics_endpoint.h"
+
+#include <sstream>
+#include <vector>
+
+#include "motis/module/message.h"
+
+using namespace motis::module;
+
+namespace motis::launcher {
+
+void register_metrics_endpoint(registry& reg) {
+  reg.register_op(
+      "/metrics",
+      [&reg](msg_ptr const&) {
+        std::stringstream ss;
+        reg.metrics_.write_prometheus(ss);
+
+        message_creator mc;
+        mc.create_and_finish(
+            MsgContent_HTTPResponse,
+            CreateHTTPResponse(
+                mc, HTTPStatus_OK,
+                mc.CreateVector(std::vector{CreateHTTPHeader(
+                    mc, mc.CreateString("Content-Type"),
+                    mc.CreateString("text/plain; version=0.0.4"))}),
+                mc.CreateString(ss.str()))
+                .Union());
+        return make_msg(mc);
+      },
+      {});
+}
+
+}  // namespace motis::launcher
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cinttypes>
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include "motis/hash_map.h"
@@ -13,6 +16,24 @@ namespace motis::loader {
 struct Schedule;  // NOLINT
 struct Station;  // NOLINT
 
+// Footpaths of one component: component-local station indices, adjacency
+// lists sorted by target.
+using footpath_component =
+    std::vector<std::vector<std::pair<uint32_t, motis::time>>>;
+
+// Called with (from, to, duration) for every shortest footpath (from != to,
+// duration <= max_length) in ascending (from, to) order.
+using closure_fn = std::function<void(uint32_t, uint32_t, motis::time)>;
+
+// Transitive closure with Floyd-Warshall: O(n^3), for small components.
+void close_footpaths_dense(footpath_component const&, motis::time max_length,
+                           closure_fn const&);
+
+// Transitive closure with one bounded Dijkstra per station:
+// O(n * m log n), for large (sparse) components.
+void close_footpaths_sparse(footpath_component const&, motis::time max_length,
+                            closure_fn const&);
+
 void build_footpaths(schedule&, loader_options const&,
                      mcd::hash_map<Station const*, station_node*> const&,
                      std::vector<Schedule const*> const&);
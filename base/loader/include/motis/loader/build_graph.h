@@ -3,6 +3,8 @@
 #include <ctime>
 #include <vector>
 
+#include "cista/hash.h"
+
 #include "motis/core/schedule/schedule.h"
 #include "motis/loader/loader_options.h"
 
@@ -10,6 +12,10 @@ namespace motis::loader {
 
 struct Schedule;  // NOLINT
 
+// Hash of the graph built from datasets with the given content hashes.
+cista::hash_t graph_hash(std::vector<cista::hash_t> const& dataset_hashes,
+                         loader_options const&);
+
 schedule_ptr build_graph(std::vector<Schedule const*> const&,
                          loader_options const&);
 
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "motis/core/schedule/schedule.h"
+
+#include "motis/loader/loader_options.h"
+
+namespace motis::loader {
+
+// Selects landmark stations (configured stations first, then farthest-first
+// until opt.landmark_count_ is reached) and computes the distances from/to
+// every station in the travel time lower bound graphs.
+void build_landmarks(schedule&, loader_options const&);
+
+}  // namespace motis::loader
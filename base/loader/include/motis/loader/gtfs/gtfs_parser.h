@@ -6,8 +6,12 @@ struct gtfs_parser : public format_parser {
   bool applicable(boost::filesystem::path const&) override;
   std::vector<std::string> missing_files(
       boost::filesystem::path const&) const override;
+  using format_parser::parse;
   void parse(boost::filesystem::path const& root,
-             flatbuffers64::FlatBufferBuilder&) override;
+             flatbuffers64::FlatBufferBuilder&,
+             cista::hash_t dataset_hash) override;
+  std::vector<boost::filesystem::path> input_files(
+      boost::filesystem::path const&) const override;
 };
 
 }  // namespace motis::loader::gtfs
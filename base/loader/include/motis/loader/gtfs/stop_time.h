@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <string>
 
@@ -8,6 +9,8 @@
 
 namespace motis::loader::gtfs {
 
-void read_stop_times(loaded_file const&, trip_map&, stop_map const&);
+// chunk_count: number of chunks parsed in parallel, 0 = based on file size
+void read_stop_times(loaded_file const&, trip_map&, stop_map const&,
+                     std::size_t chunk_count = 0U);
 
 }  // namespace motis::loader::gtfs
@@ -15,10 +15,18 @@ struct hrd_parser : public format_parser {
   static std::vector<std::string> missing_files(
       boost::filesystem::path const& hrd_root, config const& c);
 
+  using format_parser::parse;
   void parse(boost::filesystem::path const& hrd_root,
-             flatbuffers64::FlatBufferBuilder&) override;
+             flatbuffers64::FlatBufferBuilder&,
+             cista::hash_t dataset_hash) override;
   static void parse(boost::filesystem::path const& hrd_root,
-                    flatbuffers64::FlatBufferBuilder&, config const& c);
+                    flatbuffers64::FlatBufferBuilder&, config const& c,
+                    cista::hash_t dataset_hash);
+
+  std::vector<boost::filesystem::path> input_files(
+      boost::filesystem::path const& hrd_root) const override;
+  static std::vector<boost::filesystem::path> input_files(
+      boost::filesystem::path const& hrd_root, config const& c);
 };
 
 }  // namespace motis::loader::hrd
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ctime>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,6 +24,7 @@ struct loader_options {
   bool read_graph_{false};
   bool read_graph_mmap_{false};
   bool cache_graph_{false};
+  bool compress_graph_{false};
   bool apply_rules_{true};
   bool adjust_footpaths_{false};
   bool expand_trips_{true};
@@ -30,9 +32,12 @@ struct loader_options {
   bool use_platforms_{false};
   bool no_local_transport_{false};
   duration planned_transfer_delta_{30};
+  duration max_footpath_length_{std::numeric_limits<duration>::max()};
   std::string graph_path_{"default"};
   std::string wzr_classes_path_{};
   std::string wzr_matrix_path_{};
+  std::vector<std::string> landmarks_{};
+  unsigned landmark_count_{0U};
 };
 
 }  // namespace motis::loader
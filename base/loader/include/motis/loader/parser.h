@@ -5,6 +5,8 @@
 
 #include "boost/filesystem/path.hpp"
 
+#include "cista/hash.h"
+
 #include "flatbuffers/flatbuffers.h"
 
 namespace flatbuffers64 {
@@ -24,8 +26,27 @@ struct format_parser {
   virtual bool applicable(boost::filesystem::path const&) = 0;
   virtual std::vector<std::string> missing_files(
       boost::filesystem::path const&) const = 0;
+
+  // dataset_hash: hash(path), stored in the serialized schedule.
   virtual void parse(boost::filesystem::path const&,
-                     flatbuffers64::FlatBufferBuilder&) = 0;
+                     flatbuffers64::FlatBufferBuilder&,
+                     cista::hash_t dataset_hash) = 0;
+  void parse(boost::filesystem::path const& path,
+             flatbuffers64::FlatBufferBuilder& fbb) {
+    parse(path, fbb, hash(path));
+  }
+
+  // All (existing) input files read by parse.
+  virtual std::vector<boost::filesystem::path> input_files(
+      boost::filesystem::path const&) const = 0;
+
+  // Content hash of all input files of the dataset. Stored in the serialized
+  // schedule to detect whether it needs to be re-parsed.
+  cista::hash_t hash(boost::filesystem::path const&) const;
+
+  // Cheap key of all input files (names, sizes, modification times) to
+  // detect changes without reading the files.
+  cista::hash_t stamp(boost::filesystem::path const&) const;
 };
 
 }  // namespace motis::loader
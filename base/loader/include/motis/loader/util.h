@@ -12,6 +12,8 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+#include "cista/hash.h"
+
 #include "utl/to_vec.h"
 
 #include "utl/parser/buffer.h"
@@ -98,6 +100,14 @@ inline int yyyymmdd_day(int yyyymmdd) { return yyyymmdd % 100; }
 void write_schedule(flatbuffers64::FlatBufferBuilder& b,
                     boost::filesystem::path const& path);
 
+// Combines the content hash of the whole file and its size into the given
+// hash. Missing files do not change the hash.
+cista::hash_t hash_file(boost::filesystem::path const&, cista::hash_t);
+
+// Combines path, size and modification time of the file into the given hash
+// (without reading it). Missing files do not change the hash.
+cista::hash_t stamp_file(boost::filesystem::path const&, cista::hash_t);
+
 size_t collect_files(boost::filesystem::path const& root,
                      std::string const& file_extension,
                      std::vector<boost::filesystem::path>& files);
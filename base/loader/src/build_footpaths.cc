@@ -1,6 +1,10 @@
 #include "motis/loader/build_footpaths.h"
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <optional>
+#include <queue>
 #include <stack>
 
 #include "geo/latlng.h"
@@ -28,6 +32,81 @@ constexpr auto const kAdjustedMaxDuration = 15;  // [minutes]
 
 constexpr auto kNoComponent = std::numeric_limits<uint32_t>::max();
 
+// Components with at least this many stations are closed with one bounded
+// Dijkstra per station instead of Floyd-Warshall (O(n * m log n) vs. O(n^3)).
+constexpr auto const kSparseComponentThreshold = 128;
+
+void close_footpaths_dense(footpath_component const& component,
+                           motis::time const max_length,
+                           closure_fn const& fn) {
+  auto const size = component.size();
+
+  constexpr auto const kInvalidTime = std::numeric_limits<motis::time>::max();
+  auto mat = make_flat_matrix<motis::time>(size, kInvalidTime);
+  for (auto i = 0U; i < size; ++i) {
+    for (auto const& [j, duration] : component[i]) {
+      mat(i, j) = duration;
+    }
+  }
+
+  floyd_warshall(mat);
+
+  for (auto i = 0U; i < size; ++i) {
+    for (auto j = 0U; j < size; ++j) {
+      if (mat(i, j) == kInvalidTime || i == j || mat(i, j) > max_length) {
+        continue;
+      }
+      fn(i, j, mat(i, j));
+    }
+  }
+}
+
+void close_footpaths_sparse(footpath_component const& component,
+                            motis::time const max_length,
+                            closure_fn const& fn) {
+  auto const size = static_cast<uint32_t>(component.size());
+
+  constexpr auto const kInvalidTime = std::numeric_limits<uint32_t>::max();
+  using label = std::pair<uint32_t /* duration */, uint32_t /* node */>;
+  std::priority_queue<label, std::vector<label>, std::greater<>> pq;
+  std::vector<uint32_t> dist(size, kInvalidTime);
+  std::vector<uint32_t> reached;
+
+  for (auto i = 0U; i < size; ++i) {
+    dist[i] = 0U;
+    reached.emplace_back(i);
+    pq.emplace(0U, i);
+    while (!pq.empty()) {
+      auto const [d, node] = pq.top();
+      pq.pop();
+      if (d > dist[node]) {
+        continue;
+      }
+      for (auto const& [to, duration] : component[node]) {
+        auto const new_dist = d + duration;
+        if (new_dist > max_length || new_dist >= dist[to]) {
+          continue;
+        }
+        if (dist[to] == kInvalidTime) {
+          reached.emplace_back(to);
+        }
+        dist[to] = new_dist;
+        pq.emplace(new_dist, to);
+      }
+    }
+
+    // same output order as floyd warshall: ascending target station
+    std::sort(begin(reached), end(reached));
+    for (auto const j : reached) {
+      if (j != i && dist[j] < std::numeric_limits<motis::time>::max()) {
+        fn(i, j, static_cast<motis::time>(dist[j]));
+      }
+      dist[j] = kInvalidTime;
+    }
+    reached.clear();
+  }
+}
+
 // station_idx -> [footpath, ...]
 using footgraph = std::vector<std::vector<footpath>>;
 
@@ -215,6 +294,15 @@ struct footpath_builder {
         LOG(ml::error) << "footpath error: " << idx << " (" << e.what() << ")";
       }
     }
+
+    for (auto const& [name, stats] :
+         {std::pair{"floyd-warshall", &dense_stats_},
+          std::pair{"dijkstra", &sparse_stats_}}) {
+      LOG(ml::info) << "footpath closure " << name << ": "
+                    << stats->components_ << " components, "
+                    << stats->footpaths_ << " footpaths, "
+                    << stats->time_us_ / 1000 << "ms (summed over threads)";
+    }
   }
 
   void make_station_equivalents_unique() {
@@ -329,38 +417,57 @@ struct footpath_builder {
     }
     utl::verify(size > 2, "invalid size {}", size);
 
-    constexpr auto const kInvalidTime = std::numeric_limits<motis::time>::max();
-    auto mat = make_flat_matrix<motis::time>(size, kInvalidTime);
+    auto const start = std::chrono::steady_clock::now();
+    auto footpath_count = std::size_t{0U};
+    auto const add_footpath = [&](uint32_t const i, uint32_t const j,
+                                  motis::time const duration) {
+      add_closure_footpath(std::next(lb, i)->second, std::next(lb, j)->second,
+                           duration);
+      ++footpath_count;
+    };
+    auto const component = to_component(lb, ub, fgraph);
+    if (size >= kSparseComponentThreshold) {
+      close_footpaths_sparse(component, opt_.max_footpath_length_,
+                             add_footpath);
+    } else {
+      close_footpaths_dense(component, opt_.max_footpath_length_,
+                            add_footpath);
+    }
+    auto& stats = size >= kSparseComponentThreshold ? sparse_stats_
+                                                    : dense_stats_;
+    stats.components_ += 1;
+    stats.footpaths_ += footpath_count;
+    stats.time_us_ += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+  }
+
+  void add_closure_footpath(uint32_t const idx_a, uint32_t const idx_b,
+                            motis::time const duration) {
+    // each node only in one cluster -> no sync required
+    sched_.stations_[idx_a]->outgoing_footpaths_.emplace_back(idx_a, idx_b,
+                                                              duration);
+    sched_.stations_[idx_b]->incoming_footpaths_.emplace_back(idx_a, idx_b,
+                                                              duration);
+  }
 
-    for (auto i = 0; i < size; ++i) {
+  static footpath_component to_component(component_it const lb,
+                                         component_it const ub,
+                                         footgraph const& fgraph) {
+    auto const size = static_cast<uint32_t>(std::distance(lb, ub));
+    footpath_component component(size);
+    for (auto i = 0U; i < size; ++i) {
       auto it = lb;
       for (auto const& edge : fgraph[(lb + i)->second]) {  // precond.: sorted!
         while (it != ub && edge.to_station_ != it->second) {
           ++it;
         }
-        auto j = std::distance(lb, it);
-        mat(i, j) = edge.duration_;
-      }
-    }
-
-    floyd_warshall(mat);
-
-    for (auto i = 0; i < size; ++i) {
-      for (auto j = 0; j < size; ++j) {
-        if (mat(i, j) == kInvalidTime || i == j) {
-          continue;
-        }
-
-        auto idx_a = std::next(lb, i)->second;
-        auto idx_b = std::next(lb, j)->second;
-
-        // each node only in one cluster -> no sync required
-        sched_.stations_[idx_a]->outgoing_footpaths_.emplace_back(idx_a, idx_b,
-                                                                  mat(i, j));
-        sched_.stations_[idx_b]->incoming_footpaths_.emplace_back(idx_a, idx_b,
-                                                                  mat(i, j));
+        component[i].emplace_back(static_cast<uint32_t>(std::distance(lb, it)),
+                                  edge.duration_);
       }
     }
+    return component;
   }
 
   static std::string to_str(std::vector<footpath> const& footpaths) {
@@ -376,9 +483,15 @@ struct footpath_builder {
     return opt_.no_local_transport_ && is_local_station(station);
   }
 
+  struct closure_stats {
+    std::atomic_size_t components_{0U}, footpaths_{0U};
+    std::atomic_uint64_t time_us_{0U};
+  };
+
   schedule& sched_;
   loader_options const& opt_;
   mcd::hash_map<Station const*, station_node*> const& station_nodes_;
+  closure_stats dense_stats_, sparse_stats_;
 };
 
 void build_footpaths(
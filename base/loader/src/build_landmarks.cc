@@ -0,0 +1,123 @@
+#include "motis/loader/build_landmarks.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+#include "utl/verify.h"
+
+#include "motis/core/common/logging.h"
+#include "motis/core/schedule/constant_graph.h"
+
+namespace ml = motis::logging;
+
+namespace motis::loader {
+
+namespace {
+
+using landmark_dijkstra_t =
+    constant_graph_dijkstra<landmarks::MAX_DIST, map_station_graph_node>;
+
+mcd::vector<uint32_t> landmark_dists(constant_graph const& g,
+                                     uint32_t const landmark) {
+  auto const no_edges = mcd::hash_map<unsigned, std::vector<simple_edge>>{};
+  landmark_dijkstra_t d{g, {static_cast<int>(landmark)}, no_edges};
+  d.run();
+  return std::move(d.dists_);
+}
+
+}  // namespace
+
+void build_landmarks(schedule& sched, loader_options const& opt) {
+  auto const station_count = sched.stations_.size();
+  auto const count = std::max(opt.landmarks_.size(),
+                              static_cast<std::size_t>(opt.landmark_count_));
+  if (count == 0U) {
+    return;
+  }
+
+  ml::scoped_timer timer("landmarks");
+
+  auto const& fwd = sched.travel_time_lower_bounds_fwd_;
+  auto const& bwd = sched.travel_time_lower_bounds_bwd_;
+
+  // to: dijkstra on the (reversed) FWD graph, from: on the BWD graph
+  std::vector<mcd::vector<uint32_t>> to, from;
+  std::vector<uint32_t> selected;
+  std::vector<uint32_t> min_dist(station_count,
+                                 std::numeric_limits<uint32_t>::max());
+  auto const capped = [](uint32_t const d) {
+    return std::min(d, static_cast<uint32_t>(landmarks::MAX_DIST));
+  };
+  auto const add = [&](uint32_t const idx) {
+    selected.push_back(idx);
+    to.emplace_back(landmark_dists(fwd, idx));
+    from.emplace_back(landmark_dists(bwd, idx));
+    for (auto s = 0U; s != station_count; ++s) {
+      min_dist[s] =
+          std::min(min_dist[s], capped(to.back()[s]) + capped(from.back()[s]));
+    }
+  };
+
+  for (auto const& id : opt.landmarks_) {
+    auto const it = sched.eva_to_station_.find(mcd::string{id});
+    utl::verify(it != end(sched.eva_to_station_), "landmark {} not found", id);
+    if (std::find(begin(selected), end(selected), it->second->index_) ==
+        end(selected)) {
+      add(it->second->index_);
+    }
+  }
+
+  if (selected.empty()) {
+    // seed: farthest station from the best connected station
+    auto const hub = static_cast<uint32_t>(std::distance(
+        begin(fwd), std::max_element(begin(fwd), end(fwd),
+                                     [](auto const& a, auto const& b) {
+                                       return a.size() < b.size();
+                                     })));
+    auto const dists = landmark_dists(bwd, hub);
+    auto seed = hub;
+    for (auto s = 0U; s != station_count; ++s) {
+      if (dists[s] != landmark_dijkstra_t::UNREACHABLE &&
+          dists[s] > dists[seed]) {
+        seed = s;
+      }
+    }
+    add(seed);
+  }
+
+  while (selected.size() < count) {
+    auto best = std::optional<uint32_t>{};
+    for (auto s = 0U; s != station_count; ++s) {
+      if (fwd[s].empty() && bwd[s].empty()) {
+        continue;  // dummy or isolated station
+      }
+      if (!best.has_value() || min_dist[s] > min_dist[*best]) {
+        best = s;
+      }
+    }
+    if (!best.has_value() || min_dist[*best] == 0U) {
+      break;  // every station is a landmark
+    }
+    add(*best);
+  }
+
+  auto& lm = sched.landmarks_;
+  lm.stations_ = mcd::vector<uint32_t>(begin(selected), end(selected));
+  lm.to_landmark_.resize(station_count * lm.count());
+  lm.from_landmark_.resize(station_count * lm.count());
+  auto const to_dist = [](uint32_t const d) {
+    return d == landmark_dijkstra_t::UNREACHABLE ? landmarks::INVALID_DIST
+                                                 : static_cast<duration>(d);
+  };
+  for (auto s = 0U; s != station_count; ++s) {
+    for (auto i = 0U; i != lm.count(); ++i) {
+      lm.to_landmark_[s * lm.count() + i] = to_dist(to[i][s]);
+      lm.from_landmark_[s * lm.count() + i] = to_dist(from[i][s]);
+    }
+  }
+
+  LOG(ml::info) << lm.count() << " landmarks";
+}
+
+}  // namespace motis::loader
@@ -27,6 +27,7 @@
 
 #include "motis/loader/build_footpaths.h"
 #include "motis/loader/build_graph.h"
+#include "motis/loader/build_landmarks.h"
 #include "motis/loader/build_stations.h"
 #include "motis/loader/classes.h"
 #include "motis/loader/filter/local_stations.h"
@@ -784,6 +785,23 @@ bool graph_builder::skip_route(Route const* route) const {
              [&](Station const* station) { return skip_station(station); });
 }
 
+cista::hash_t graph_hash(std::vector<cista::hash_t> const& dataset_hashes,
+                         loader_options const& opt) {
+  auto hash = cista::BASE_HASH;
+  for (auto const dataset_hash : dataset_hashes) {
+    hash = cista::hash_combine(hash, dataset_hash);
+  }
+  if (dataset_hashes.size() == 1 && opt.dataset_prefix_.empty()) {
+    hash = cista::hash(mcd::string{}, hash);
+  } else {
+    for (auto const& prefix : opt.dataset_prefix_) {
+      hash = cista::hash(
+          prefix.empty() ? mcd::string{} : mcd::string{prefix + "_"}, hash);
+    }
+  }
+  return hash;
+}
+
 schedule_ptr build_graph(std::vector<Schedule const*> const& fbs_schedules,
                          loader_options const& opt) {
   utl::verify(!fbs_schedules.empty(), "build_graph: no schedules");
@@ -860,14 +878,10 @@ schedule_ptr build_graph(std::vector<Schedule const*> const& fbs_schedules,
   progress_tracker->status("Sort Trips").out_bounds(93, 95);
   builder.sort_trips();
 
-  auto hash = cista::BASE_HASH;
-  for (auto const* fbs_schedule : fbs_schedules) {
-    hash = cista::hash_combine(hash, fbs_schedule->hash());
-  }
-  for (auto const& prefix : sched->prefixes_) {
-    hash = cista::hash(prefix, hash);
-  }
-  sched->hash_ = hash;
+  sched->hash_ = graph_hash(
+      utl::to_vec(fbs_schedules,
+                  [](Schedule const* s) -> cista::hash_t { return s->hash(); }),
+      opt);
 
   sched->route_count_ = builder.next_route_index_;
 
@@ -886,6 +900,7 @@ schedule_ptr build_graph(std::vector<Schedule const*> const& fbs_schedules,
   sched->travel_time_lower_bounds_bwd_ =
       build_station_graph(sched->station_nodes_, search_dir::BWD);
   progress_tracker->increment();
+  build_landmarks(*sched, opt);
 
   sched->waiting_time_rules_ = load_waiting_time_rules(
       opt.wzr_classes_path_, opt.wzr_matrix_path_, sched->categories_);
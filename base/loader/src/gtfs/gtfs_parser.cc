@@ -1,6 +1,9 @@
 #include "motis/loader/gtfs/gtfs_parser.h"
 
+#include <algorithm>
+#include <cassert>
 #include <numeric>
+#include <string_view>
 
 #include "boost/algorithm/string.hpp"
 #include "boost/date_time/posix_time/posix_time.hpp"
@@ -9,6 +12,7 @@
 #include "utl/erase_if.h"
 #include "utl/get_or_create.h"
 #include "utl/pairwise.h"
+#include "utl/parallel_for.h"
 #include "utl/parser/cstr.h"
 #include "utl/pipes/accumulate.h"
 #include "utl/pipes/all.h"
@@ -17,6 +21,7 @@
 #include "utl/pipes/transform.h"
 #include "utl/pipes/vec.h"
 #include "utl/progress_tracker.h"
+#include "utl/to_vec.h"
 
 #include "cista/hash.h"
 #include "cista/mmap.h"
@@ -52,27 +57,19 @@ namespace motis::loader::gtfs {
 auto const required_files = {AGENCY_FILE, STOPS_FILE, ROUTES_FILE, TRIPS_FILE,
                              STOP_TIMES_FILE};
 
-cista::hash_t hash(fs::path const& path) {
-  auto hash = cista::BASE_HASH;
-  auto const hash_file = [&](fs::path const& p) {
-    if (!fs::is_regular_file(p)) {
-      return;
-    }
-    cista::mmap m{p.generic_string().c_str(), cista::mmap::protection::READ};
-    hash = cista::hash_combine(
-        cista::hash(std::string_view{
-            reinterpret_cast<char const*>(m.begin()),
-            std::min(static_cast<size_t>(50 * 1024 * 1024), m.size())}),
-        hash);
-  };
+// all files read by gtfs_parser::parse
+auto const parsed_files = {AGENCY_FILE,         STOPS_FILE,     ROUTES_FILE,
+                           TRIPS_FILE,          STOP_TIMES_FILE, CALENDAR_FILE,
+                           CALENDAR_DATES_FILE, TRANSFERS_FILE, FEED_INFO_FILE};
 
-  for (auto const& file_name : required_files) {
-    hash_file(path / file_name);
+std::vector<fs::path> gtfs_parser::input_files(fs::path const& path) const {
+  std::vector<fs::path> files;
+  for (auto const& file_name : parsed_files) {
+    if (fs::is_regular_file(path / file_name)) {
+      files.emplace_back(path / file_name);
+    }
   }
-  hash_file(path / CALENDAR_FILE);
-  hash_file(path / CALENDAR_DATES_FILE);
-
-  return hash;
+  return files;
 }
 
 bool gtfs_parser::applicable(fs::path const& path) {
@@ -238,10 +235,13 @@ void fix_flixtrain_transfers(trip_map& trips,
   }
 }
 
-void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
+void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb,
+                        cista::hash_t const dataset_hash) {
   motis::logging::scoped_timer global_timer{"gtfs parser"};
 
   auto const load = [&](char const* file) {
+    assert(std::find(begin(parsed_files), end(parsed_files),
+                     std::string_view{file}) != end(parsed_files));
     return fs::is_regular_file(root / file) ? loaded_file{root / file}
                                             : loaded_file{};
   };
@@ -258,6 +258,27 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
   fix_stop_positions(trips);
   fix_flixtrain_transfers(trips, transfers);
 
+  // Stop sequences and sequence numbers are the deduplication keys for routes
+  // and sequence number vectors. Compute them once per trip in parallel instead
+  // of rebuilding them for every lookup during (sequential) export.
+  struct trip_keys {
+    trip::stop_seq stops_;
+    trip::stop_seq_numbers seq_numbers_;
+  };
+  std::map<trip const*, trip_keys> keys;
+  {
+    motis::logging::scoped_timer keys_timer{"trip keys"};
+    for (auto const& [id, t] : trips) {
+      keys.emplace(t.get(), trip_keys{});
+    }
+    auto key_entries = utl::to_vec(
+        keys, [](std::pair<trip const* const, trip_keys>& e) { return &e; });
+    utl::parallel_for(key_entries, [](auto* e) {
+      e->second.stops_ = e->first->stops();
+      e->second.seq_numbers_ = e->first->seq_numbers();
+    });
+  }
+
   std::map<category, fbs64::Offset<Category>> fbs_categories;
   std::map<agency const*, fbs64::Offset<Provider>> fbs_providers;
   std::map<std::string, fbs64::Offset<fbs64::String>> fbs_strings;
@@ -344,7 +365,7 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
     if (!t->headsign_.empty()) {
       return get_or_create_str(t->headsign_);
     } else {
-      return get_or_create_str(t->stops().back().stop_->name_);
+      return get_or_create_str(keys.at(t).stops_.back().stop_->name_);
     }
   };
 
@@ -371,7 +392,8 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
       train_nr = std::stoi(t->headsign_);
     }
 
-    auto const stop_seq = t->stops();
+    auto const& stop_seq = keys.at(t).stops_;
+    auto const& seq_numbers = keys.at(t).seq_numbers_;
     return CreateService(
         fbb,
         utl::get_or_create(
@@ -418,8 +440,8 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
                                t->line_),
         is_rule_service_participant, 0 /* initial train number */,
         get_or_create_str(t->id_),
-        utl::get_or_create(fbs_seq_numbers, t->seq_numbers(), [&]() {
-          return fbb.CreateVector(t->seq_numbers());
+        utl::get_or_create(fbs_seq_numbers, seq_numbers, [&]() {
+          return fbb.CreateVector(seq_numbers);
         }));
   };
 
@@ -427,10 +449,10 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
       utl::all(trips)  //
       | utl::remove_if([&](auto const& entry) {
           progress_tracker->increment();
-          auto const stop_count = entry.second->stops().size();
+          auto const stop_count = keys.at(entry.second.get()).stops_.size();
           if (stop_count < 2) {
-            LOG(warn) << "invalid trip " << entry.first << ": "
-                      << entry.second->stops().size() << " stops";
+            LOG(warn) << "invalid trip " << entry.first << ": " << stop_count
+                      << " stops";
           }
           return stop_count < 2;
         })  //
@@ -549,7 +571,7 @@ void gtfs_parser::parse(fs::path const& root, fbs64::FlatBufferBuilder& fbb) {
                             fbb.CreateVector(footpaths),
                             fbb.CreateVector(rule_services),
                             fbb.CreateVector(meta_stations),
-                            fbb.CreateString(dataset_name), hash(root)));
+                            fbb.CreateString(dataset_name), dataset_hash));
 }
 
 }  // namespace motis::loader::gtfs
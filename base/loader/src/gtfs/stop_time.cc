@@ -1,12 +1,16 @@
 #include "motis/loader/gtfs/stop_time.h"
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
 #include <tuple>
 
-#include "utl/enumerate.h"
+#include "utl/parallel_for.h"
 #include "utl/parser/arg_parser.h"
 #include "utl/parser/csv.h"
 #include "utl/progress_tracker.h"
+#include "utl/verify.h"
 
 #include "motis/core/common/logging.h"
 #include "motis/loader/util.h"
@@ -32,6 +36,8 @@ static const column_mapping<gtfs_stop_time> stop_time_columns = {
     {"trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence",
      "stop_headsign", "pickup_type", "drop_off_type"}};
 
+constexpr auto const MIN_PARALLEL_CHUNK_SIZE = std::size_t{4U * 1024U * 1024U};
+
 int hhmm_to_min(cstr s) {
   if (s.len == 0) {
     return -1;
@@ -51,20 +57,111 @@ int hhmm_to_min(cstr s) {
   }
 }
 
-void read_stop_times(loaded_file const& file, trip_map& trips,
-                     stop_map const& stops) {
-  motis::logging::scoped_timer timer{"read stop times"};
+struct parsed_stop_time {
+  trip* trip_;
+  unsigned seq_;
+  stop_time stop_time_;
+};
+
+struct line_chunk {
+  cstr content_;
+  std::size_t first_line_;  // 1-based line number in the file
+};
+
+// Splits at line ends that are not inside a quoted field: quoted fields may
+// contain line breaks. Escaped quotes ("") toggle twice and keep the state.
+std::vector<line_chunk> split_into_line_chunks(cstr const body,
+                                               std::size_t const first_line,
+                                               std::size_t const chunk_count) {
+  std::vector<line_chunk> chunks;
+  auto const chunk_size = body.len / chunk_count + 1;
+  auto quoted = false;
+  auto line = first_line;
+  auto chunk_begin = std::size_t{0U};
+  auto chunk_line = first_line;
+  for (auto i = std::size_t{0U}; i != body.len; ++i) {
+    if (body.str[i] == '"') {
+      quoted = !quoted;
+    } else if (body.str[i] == '\n') {
+      ++line;
+      if (!quoted && i + 1 - chunk_begin >= chunk_size) {
+        chunks.emplace_back(
+            line_chunk{body.substr(chunk_begin, i + 1 - chunk_begin),
+                       chunk_line});
+        chunk_begin = i + 1;
+        chunk_line = line;
+      }
+    }
+  }
+  if (chunk_begin != body.len) {
+    chunks.emplace_back(line_chunk{body.substr(chunk_begin), chunk_line});
+  }
+  return chunks;
+}
+
+cstr trim_header_column(cstr s) {
+  if (s.len >= 3 && std::memcmp(s.str, "\xEF\xBB\xBF", 3) == 0) {
+    s = s.substr(3);  // UTF-8 BOM
+  }
+  while (s.len != 0 && (s.str[0] == ' ' || s.str[0] == '"')) {
+    s = s.substr(1);
+  }
+  while (s.len != 0 && (s.str[s.len - 1] == ' ' || s.str[s.len - 1] == '"' ||
+                        s.str[s.len - 1] == '\r')) {
+    s.len -= 1;
+  }
+  return s;
+}
+
+struct stop_time_columns_map {
+  std::array<column_idx_t, MAX_COLUMNS> column_map_{};
+  std::size_t num_columns_{0U};
+};
+
+stop_time_columns_map read_stop_time_header(cstr const header) {
+  stop_time_columns_map m;
+  std::fill(begin(m.column_map_), end(m.column_map_), NO_COLUMN_IDX);
+  for_each_token(header, ',', [&](cstr const token) {
+    utl::verify(m.num_columns_ < MAX_COLUMNS, "stop_times: too many columns");
+    auto const name = trim_header_column(token);
+    for (auto i = 0U; i != stop_time_columns.size(); ++i) {
+      if (name == stop_time_columns[i]) {
+        m.column_map_[m.num_columns_] = static_cast<column_idx_t>(i);
+      }
+    }
+    ++m.num_columns_;
+  });
+  return m;
+}
+
+std::vector<parsed_stop_time> parse_stop_time_chunk(
+    loaded_file const& file, stop_time_columns_map const& columns,
+    line_chunk const& chunk, trip_map const& trips, stop_map const& stops) {
+  std::vector<parsed_stop_time> parsed;
   std::string last_trip_id;
   trip* last_trip = nullptr;
 
-  auto const entries = read<gtfs_stop_time>(file.content(), stop_time_columns);
+  // Line numbers are only needed for log messages: count lazily.
+  auto counted_until = chunk.content_.str;
+  auto counted_line = chunk.first_line_;
+  auto const line_number = [&](char const* row_begin) {
+    counted_line += static_cast<std::size_t>(
+        std::count(counted_until, row_begin, '\n'));
+    counted_until = row_begin;
+    return counted_line;
+  };
+
+  auto next = chunk.content_;
+  while (next) {
+    auto const row_begin = next.str;
+    auto const row = read_row<gtfs_stop_time, ','>(next, columns.column_map_,
+                                                   columns.num_columns_);
+    gtfs_stop_time s;
+    read(s, row);
+    if (get<trip_id>(s).len == 0 && get<stop_id>(s).len == 0) {
+      continue;  // empty line
+    }
 
-  auto progress_tracker = utl::get_active_progress_tracker();
-  progress_tracker->status("Parse Stop Times")
-      .out_bounds(25.F, 60.F)
-      .in_high(entries.size());
-  for (auto const& [i, s] : utl::enumerate(entries)) {
-    progress_tracker->update(i);
     trip* t = nullptr;
     auto t_id = get<trip_id>(s).to_str();
     if (last_trip != nullptr && t_id == last_trip_id) {
@@ -73,7 +170,7 @@ void read_stop_times(loaded_file const& file, trip_map& trips,
       auto const trip_it = trips.find(t_id);
       if (trip_it == end(trips)) {
         LOG(logging::error) << "trip \"" << t_id << "\" in " << file.name()
-                            << ":" << i << " not found";
+                            << ":" << line_number(row_begin) << " not found";
         continue;
       }
       t = trip_it->second.get();
@@ -81,16 +178,68 @@ void read_stop_times(loaded_file const& file, trip_map& trips,
       last_trip = t;
     }
 
-    try {
-      t->stop_times_.emplace(
-          get<stop_sequence>(s), stops.at(get<stop_id>(s).to_str()).get(),
-          get<stop_headsign>(s).to_str(),  //
-          hhmm_to_min(get<arrival_time>(s)), get<drop_off_type>(s) != 1,
-          hhmm_to_min(get<departure_time>(s)), get<pickup_type>(s) != 1);
-    } catch (...) {
+    auto const stop_it = stops.find(get<stop_id>(s).to_str());
+    if (stop_it == end(stops)) {
       LOG(logging::warn) << "unkown stop " << get<stop_id>(s).to_str() << " at "
-                         << file.name() << ":" << i;
+                         << file.name() << ":" << line_number(row_begin);
+      continue;
+    }
+
+    parsed.emplace_back(parsed_stop_time{
+        t, static_cast<unsigned>(get<stop_sequence>(s)),
+        stop_time{stop_it->second.get(), get<stop_headsign>(s).to_str(),
+                  hhmm_to_min(get<arrival_time>(s)),
+                  get<drop_off_type>(s) != 1,
+                  hhmm_to_min(get<departure_time>(s)),
+                  get<pickup_type>(s) != 1}});
+  }
+  return parsed;
+}
+
+void read_stop_times(loaded_file const& file, trip_map& trips,
+                     stop_map const& stops, std::size_t chunk_count) {
+  motis::logging::scoped_timer timer{"read stop times"};
+
+  auto const content = file.content();
+  auto const header_end = content.view().find('\n');
+  if (header_end == std::string_view::npos) {
+    return;
+  }
+  auto const columns = read_stop_time_header(content.substr(0, header_end));
+  auto const body = content.substr(header_end + 1);
+
+  if (chunk_count == 0U) {
+    chunk_count =
+        body.len < MIN_PARALLEL_CHUNK_SIZE
+            ? std::size_t{1U}
+            : std::min(body.len / MIN_PARALLEL_CHUNK_SIZE,
+                       4U * static_cast<std::size_t>(std::max(
+                                1U, std::thread::hardware_concurrency())));
+  }
+  auto const chunks = split_into_line_chunks(body, 2U, chunk_count);
+
+  auto progress_tracker = utl::get_active_progress_tracker();
+  progress_tracker->status("Parse Stop Times")
+      .out_bounds(25.F, 60.F)
+      .in_high(chunks.size());
+
+  std::vector<std::vector<parsed_stop_time>> parsed(chunks.size());
+  {
+    motis::logging::scoped_timer parse_timer{"parse stop time chunks"};
+    utl::parallel_for_run(chunks.size(), [&](auto const i) {
+      parsed[i] = parse_stop_time_chunk(file, columns, chunks[i], trips, stops);
+    });
+  }
+
+  // Chunks are merged in file order: stop times of a trip that is split
+  // across chunk borders end up in the same order as with a sequential read.
+  motis::logging::scoped_timer merge_timer{"merge stop time chunks"};
+  for (auto i = 0U; i != parsed.size(); ++i) {
+    progress_tracker->update(i);
+    for (auto& s : parsed[i]) {
+      s.trip_->stop_times_.emplace(s.seq_, std::move(s.stop_time_));
     }
+    parsed[i] = {};
   }
 }
 
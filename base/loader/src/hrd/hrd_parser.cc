@@ -5,7 +5,6 @@
 #include "utl/progress_tracker.h"
 
 #include "cista/hash.h"
-#include "cista/mmap.h"
 
 #include "motis/core/common/logging.h"
 
@@ -45,18 +44,24 @@ using namespace utl;
 using namespace motis::logging;
 namespace fs = boost::filesystem;
 
-cista::hash_t hash(fs::path const& hrd_root) {
+std::vector<fs::path> hrd_parser::input_files(fs::path const& hrd_root) const {
   for (auto const& c : configs) {
-    auto const basic_data_path = hrd_root / c.core_data_ / c.files(BASIC_DATA);
-    if (fs::is_regular_file(basic_data_path)) {
-      cista::mmap m{basic_data_path.generic_string().c_str(),
-                    cista::mmap::protection::READ};
-      return cista::hash(std::string_view{
-          reinterpret_cast<char const*>(m.begin()),
-          std::min(static_cast<size_t>(50 * 1024 * 1024), m.size())});
+    if (fs::is_regular_file(hrd_root / c.core_data_ / c.files(BASIC_DATA))) {
+      return input_files(hrd_root, c);
     }
   }
-  return 0U;
+  return {};
+}
+
+std::vector<fs::path> hrd_parser::input_files(fs::path const& hrd_root,
+                                              config const& c) {
+  std::vector<fs::path> files;
+  collect_files(hrd_root / c.core_data_, "", files);
+  if (fs::exists(hrd_root / c.fplan_)) {
+    collect_files(hrd_root / c.fplan_, c.fplan_file_extension_, files);
+  }
+  std::sort(begin(files), end(files));
+  return files;
 }
 
 bool hrd_parser::applicable(fs::path const& path) {
@@ -204,10 +209,11 @@ void delete_f_equivalences(
   }
 }
 
-void hrd_parser::parse(fs::path const& hrd_root, FlatBufferBuilder& fbb) {
+void hrd_parser::parse(fs::path const& hrd_root, FlatBufferBuilder& fbb,
+                       cista::hash_t const dataset_hash) {
   for (auto const& c : configs) {
     if (applicable(hrd_root, c)) {
-      return parse(hrd_root, fbb, c);
+      return parse(hrd_root, fbb, c, dataset_hash);
     } else {
       LOG(info) << (hrd_root / c.core_data_ / c.files(BASIC_DATA))
                 << " does not exist";
@@ -217,7 +223,7 @@ void hrd_parser::parse(fs::path const& hrd_root, FlatBufferBuilder& fbb) {
 }
 
 void hrd_parser::parse(fs::path const& hrd_root, FlatBufferBuilder& fbb,
-                       config const& c) {
+                       config const& c, cista::hash_t const dataset_hash) {
   LOG(info) << "parsing HRD data version " << c.version_;
 
   auto const core_data_root = hrd_root / c.core_data_;
@@ -300,7 +306,7 @@ void hrd_parser::parse(fs::path const& hrd_root, FlatBufferBuilder& fbb,
                      fbb.CreateVector(values(stb.fbs_stations_)),
                      fbb.CreateVector(values(rb.routes_)), &interval, footpaths,
                      fbb.CreateVector(rsb.fbs_rule_services_), metastations,
-                     fbb.CreateString(schedule_name), hash(hrd_root)));
+                     fbb.CreateString(schedule_name), dataset_hash));
 }
 
 }  // namespace motis::loader::hrd
@@ -1,9 +1,13 @@
 #include "motis/loader/loader.h"
 
+#include <algorithm>
 #include <fstream>
 #include <istream>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -50,6 +54,22 @@ std::vector<std::unique_ptr<format_parser>> parsers() {
 
 using dataset_mem_t = std::variant<cista::mmap, typed_flatbuffer<Schedule>>;
 
+// Stamp file next to the graph: dataset stamp and hash of the written graph.
+std::optional<std::pair<cista::hash_t, cista::hash_t>> read_graph_stamp(
+    std::string const& path) {
+  auto in = std::ifstream{path};
+  auto stamp = cista::hash_t{}, hash = cista::hash_t{};
+  if (in >> stamp >> hash) {
+    return std::pair{stamp, hash};
+  }
+  return std::nullopt;
+}
+
+void write_graph_stamp(std::string const& path, cista::hash_t const stamp,
+                       cista::hash_t const hash) {
+  std::ofstream{path} << stamp << " " << hash << "\n";
+}
+
 schedule_ptr load_schedule_impl(loader_options const& opt,
                                 cista::memory_holder& schedule_buf,
                                 std::string const& data_dir) {
@@ -58,6 +78,14 @@ schedule_ptr load_schedule_impl(loader_options const& opt,
   // ensure there is an active progress tracker (e.g. for test cases)
   utl::get_active_progress_tracker_or_activate("schedule");
 
+  auto const all_parsers = parsers();
+  auto const dataset_parsers = utl::to_vec(opt.dataset_, [&](auto const& path) {
+    auto const it = std::find_if(
+        begin(all_parsers), end(all_parsers),
+        [&](auto const& parser) { return parser->applicable(path); });
+    return it == end(all_parsers) ? nullptr : it->get();
+  });
+
   auto const graph_path = opt.graph_path(data_dir);
   auto enable_read_graph = opt.read_graph_;
   auto enable_write_graph = opt.write_graph_;
@@ -65,12 +93,81 @@ schedule_ptr load_schedule_impl(loader_options const& opt,
     enable_read_graph = fs::is_regular_file(graph_path);
     enable_write_graph = true;
   }
+
+  // Content hashes decide which serialized datasets (and cached graphs) are
+  // still up to date. nullopt: dataset input not available, the serialized
+  // schedule is used as is. Computed at most once, only when required.
+  std::optional<std::vector<std::optional<cista::hash_t>>> dataset_hashes;
+  auto const get_dataset_hashes = [&]() -> auto& {
+    if (!dataset_hashes.has_value()) {
+      dataset_hashes.emplace();
+      for (auto const& [i, path] : utl::enumerate(opt.dataset_)) {
+        if (dataset_parsers[i] == nullptr) {
+          dataset_hashes->emplace_back(std::nullopt);
+        } else {
+          ml::scoped_timer hash_timer{fmt::format("hash dataset {}", path)};
+          dataset_hashes->emplace_back(dataset_parsers[i]->hash(path));
+        }
+      }
+    }
+    return *dataset_hashes;
+  };
+
+  // Cheap key (file sizes and modification times) of the datasets the cached
+  // graph was built from: skips hashing all files if nothing changed.
+  auto const all_parsers_known =
+      std::all_of(begin(dataset_parsers), end(dataset_parsers),
+                  [](auto const* p) { return p != nullptr; });
+  auto const stamp = [&]() -> std::optional<cista::hash_t> {
+    if (!all_parsers_known) {
+      return std::nullopt;
+    }
+    std::vector<cista::hash_t> dataset_stamps;
+    for (auto const& [i, path] : utl::enumerate(opt.dataset_)) {
+      dataset_stamps.emplace_back(dataset_parsers[i]->stamp(path));
+    }
+    return graph_hash(dataset_stamps, opt);
+  }();
+  auto const stamp_path = graph_path + ".stamp";
+
   if (enable_read_graph) {
     utl::verify(fs::is_regular_file(graph_path), "graph not found: {}",
                 graph_path);
     LOG(ml::info) << "reading graph: " << graph_path;
     try {
-      return read_graph(graph_path, schedule_buf, opt.read_graph_mmap_);
+      auto sched = read_graph(graph_path, schedule_buf, opt.read_graph_mmap_);
+      if (!opt.cache_graph_) {
+        return sched;
+      }
+
+      if (auto const stored = read_graph_stamp(stamp_path);
+          stamp.has_value() && stored.has_value() &&
+          stored->first == *stamp && stored->second == sched->hash_) {
+        LOG(ml::info) << "datasets unchanged (sizes, modification times)";
+        return sched;
+      }
+
+      auto const& hashes = get_dataset_hashes();
+      auto const all_hashes_known =
+          !hashes.empty() && std::all_of(begin(hashes), end(hashes),
+                                         [](auto const& h) {
+                                           return h.has_value();
+                                         });
+      auto const expected_hash =
+          all_hashes_known
+              ? graph_hash(
+                    utl::to_vec(hashes, [](auto const& h) { return *h; }),
+                    opt)
+              : sched->hash_;
+      if (sched->hash_ == expected_hash) {
+        if (stamp.has_value()) {
+          write_graph_stamp(stamp_path, *stamp, sched->hash_);
+        }
+        return sched;
+      }
+      LOG(ml::info) << "cached graph outdated (datasets changed), rebuilding";
+      sched = {};
+      schedule_buf = {};
     } catch (std::runtime_error const& err) {
       if (opt.cache_graph_) {
         LOG(ml::info) << "could not load existing graph, updating cache ("
@@ -91,20 +188,24 @@ schedule_ptr load_schedule_impl(loader_options const& opt,
   for (auto const& [i, path] : utl::enumerate(opt.dataset_)) {
     auto const binary_schedule_file = opt.fbs_schedule_path(data_dir, i);
     if (fs::is_regular_file(binary_schedule_file)) {
-      mem.emplace_back(cista::mmap{binary_schedule_file.c_str(),
-                                   cista::mmap::protection::READ});
-      continue;
+      auto m = cista::mmap{binary_schedule_file.c_str(),
+                           cista::mmap::protection::READ};
+      auto const serialized_hash = GetSchedule(m.data())->hash();
+      auto const& dataset_hash = get_dataset_hashes()[i];
+      if (!dataset_hash.has_value() || *dataset_hash == serialized_hash) {
+        LOG(ml::info) << "reusing unchanged dataset " << path << " ("
+                      << binary_schedule_file << ")";
+        mem.emplace_back(std::move(m));
+        continue;
+      }
+      LOG(ml::info) << "dataset " << path << " changed, re-parsing";
     }
 
-    auto const all_parsers = parsers();
-    auto const it = std::find_if(
-        begin(all_parsers), end(all_parsers),
-        [&p = path](auto const& parser) { return parser->applicable(p); });
-
-    if (it == end(all_parsers)) {
-      for (auto const& parser : parsers()) {
+    auto const parser = dataset_parsers[i];
+    if (parser == nullptr) {
+      for (auto const& p : all_parsers) {
         std::clog << "missing files:\n";
-        for (auto const& file : parser->missing_files(path)) {
+        for (auto const& file : p->missing_files(path)) {
           std::clog << "  " << file << "\n";
         }
       }
@@ -118,7 +219,7 @@ schedule_ptr load_schedule_impl(loader_options const& opt,
 
     flatbuffers64::FlatBufferBuilder builder;
     try {
-      (**it).parse(path, builder);
+      parser->parse(path, builder, *get_dataset_hashes()[i]);
       progress_tracker->status("FINISHED").show_progress(false);
     } catch (std::exception const& e) {
       progress_tracker->status(fmt::format("ERROR: {}", e.what()))
@@ -159,7 +260,12 @@ schedule_ptr load_schedule_impl(loader_options const& opt,
     if (!graph_dir.empty()) {
       fs::create_directories(graph_dir);
     }
-    write_graph(graph_path, *sched);
+    write_graph(graph_path, *sched, opt.compress_graph_);
+    if (stamp.has_value()) {
+      write_graph_stamp(stamp_path, *stamp, sched->hash_);
+    } else {
+      fs::remove(stamp_path);
+    }
   }
   return sched;
 }
@@ -1,10 +1,14 @@
 #include "motis/loader/loader_options.h"
 
+#include <limits>
 #include <sstream>
+#include <string_view>
 
 #include "boost/date_time/local_time/local_time.hpp"
 #include "boost/filesystem.hpp"
 
+#include "cista/hash.h"
+
 #include "motis/core/common/date_time_util.h"
 
 namespace fs = boost::filesystem;
@@ -34,8 +38,18 @@ std::string loader_options::graph_path(std::string const& data_dir) const {
     std::stringstream ss;
     ss << "graph_" << from << "-" << to << "af" << adjust_footpaths_ << "ar"
        << apply_rules_ << "et" << expand_trips_ << "ef" << expand_footpaths_
-       << "ptd" << planned_transfer_delta_ << "nlt" << no_local_transport_
-       << ".raw";
+       << "ptd" << planned_transfer_delta_ << "nlt" << no_local_transport_;
+    if (max_footpath_length_ != std::numeric_limits<duration>::max()) {
+      ss << "mfl" << max_footpath_length_;  // default: keep the old file name
+    }
+    if (!landmarks_.empty() || landmark_count_ != 0U) {
+      auto landmarks = std::string{};
+      for (auto const& id : landmarks_) {
+        landmarks += id + ",";
+      }
+      ss << "lm" << landmark_count_ << "-" << cista::hash(std::string_view{landmarks});
+    }
+    ss << ".raw";
     return (fs::path{data_dir} / "schedule" / ss.str()).generic_string();
   } else {
     return graph_path_;
@@ -0,0 +1,25 @@
+#include "motis/loader/parser.h"
+
+#include "motis/loader/util.h"
+
+namespace fs = boost::filesystem;
+
+namespace motis::loader {
+
+cista::hash_t format_parser::hash(fs::path const& path) const {
+  auto h = cista::BASE_HASH;
+  for (auto const& f : input_files(path)) {
+    h = hash_file(f, h);
+  }
+  return h;
+}
+
+cista::hash_t format_parser::stamp(fs::path const& path) const {
+  auto h = cista::BASE_HASH;
+  for (auto const& f : input_files(path)) {
+    h = stamp_file(f, h);
+  }
+  return h;
+}
+
+}  // namespace motis::loader
@@ -3,6 +3,8 @@
 #include <iomanip>
 #include <sstream>
 
+#include "cista/mmap.h"
+
 using namespace flatbuffers64;
 using namespace utl;
 namespace fs = boost::filesystem;
@@ -20,6 +22,26 @@ void write_schedule(FlatBufferBuilder& b, fs::path const& path) {
   f.write(b.GetBufferPointer(), b.GetSize());
 }
 
+cista::hash_t hash_file(fs::path const& p, cista::hash_t const h) {
+  if (!fs::is_regular_file(p)) {
+    return h;
+  }
+  cista::mmap m{p.generic_string().c_str(), cista::mmap::protection::READ};
+  return cista::hash_combine(
+      cista::hash(std::string_view{reinterpret_cast<char const*>(m.begin()),
+                                   m.size()}),
+      m.size(), h);
+}
+
+cista::hash_t stamp_file(fs::path const& p, cista::hash_t const h) {
+  if (!fs::is_regular_file(p)) {
+    return h;
+  }
+  return cista::hash_combine(
+      cista::hash(p.generic_string()), fs::file_size(p),
+      static_cast<int64_t>(fs::last_write_time(p)), h);
+}
+
 std::size_t collect_files(fs::path const& root,
                           std::string const& file_extension,
                           std::vector<fs::path>& files) {
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "motis/loader/build_footpaths.h"
+
+namespace motis::loader {
+
+namespace {
+
+using closure = std::vector<std::tuple<uint32_t, uint32_t, motis::time>>;
+
+// Connected component: a (bidirectional) chain plus random shortcuts.
+footpath_component make_component(uint32_t const size, unsigned const seed) {
+  std::mt19937 gen{seed};
+  std::uniform_int_distribution<uint32_t> station{0U, size - 1U};
+  std::uniform_int_distribution<unsigned> duration{1U, 10U};
+
+  footpath_component c(size);
+  auto const add = [&](uint32_t const from, uint32_t const to) {
+    if (from != to &&
+        std::none_of(begin(c[from]), end(c[from]),
+                     [&](auto const& e) { return e.first == to; })) {
+      c[from].emplace_back(to, static_cast<motis::time>(duration(gen)));
+    }
+  };
+  for (auto i = 1U; i < size; ++i) {
+    add(i - 1U, i);
+    add(i, i - 1U);
+  }
+  for (auto i = 0U; i < size; ++i) {
+    add(station(gen), station(gen));
+  }
+  for (auto& edges : c) {
+    std::sort(begin(edges), end(edges));
+  }
+  return c;
+}
+
+template <typename Fn>
+closure closure_of(Fn&& close_fn, footpath_component const& c,
+                   motis::time const max_length) {
+  closure result;
+  close_fn(c, max_length,
+           [&](uint32_t const from, uint32_t const to,
+               motis::time const duration) {
+             result.emplace_back(from, to, duration);
+           });
+  return result;
+}
+
+}  // namespace
+
+TEST(loader_build_footpaths, sparse_closure_equals_dense) {
+  for (auto const size : {128U, 200U}) {
+    for (auto const seed : {1U, 2U, 3U}) {
+      auto const c = make_component(size, seed);
+      for (auto const max_length :
+           {motis::time{5U}, motis::time{30U},
+            std::numeric_limits<motis::time>::max()}) {
+        auto const dense = closure_of(close_footpaths_dense, c, max_length);
+        auto const sparse = closure_of(close_footpaths_sparse, c, max_length);
+        EXPECT_FALSE(dense.empty());
+        EXPECT_EQ(dense, sparse)
+            << "size=" << size << ", seed=" << seed
+            << ", max_length=" << max_length;
+      }
+    }
+  }
+}
+
+TEST(loader_build_footpaths, closure_max_length) {
+  // 0 -5-> 1 -5-> 2
+  auto const c = footpath_component{{{1U, 5U}}, {{2U, 5U}}, {}};
+  EXPECT_EQ((closure{{0U, 1U, 5U}, {0U, 2U, 10U}, {1U, 2U, 5U}}),
+            closure_of(close_footpaths_sparse, c, 10U));
+  EXPECT_EQ((closure{{0U, 1U, 5U}, {1U, 2U, 5U}}),
+            closure_of(close_footpaths_sparse, c, 9U));
+  EXPECT_EQ(closure_of(close_footpaths_dense, c, 9U),
+            closure_of(close_footpaths_sparse, c, 9U));
+}
+
+}  // namespace motis::loader
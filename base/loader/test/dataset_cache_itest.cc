@@ -0,0 +1,110 @@
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "boost/filesystem.hpp"
+
+#include "motis/loader/loader.h"
+
+#include "./gtfs/resources.h"
+
+namespace fs = boost::filesystem;
+
+namespace motis::loader {
+
+namespace {
+
+void append(fs::path const& p, std::string const& s) {
+  std::ofstream out{p.generic_string(), std::ios::app};
+  out << s;
+}
+
+std::string read(fs::path const& p) {
+  std::ifstream in{p.generic_string(), std::ios::binary};
+  return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+void write(fs::path const& p, std::string const& s) {
+  std::ofstream out{p.generic_string(), std::ios::binary | std::ios::trunc};
+  out << s;
+}
+
+}  // namespace
+
+TEST(loader_dataset_cache, reuse_or_rebuild) {
+  auto const root = fs::temp_directory_path() / "motis_loader_dataset_cache";
+  auto const dataset = root / "dataset";
+  auto const data_dir = root / "data";
+  fs::remove_all(root);
+  fs::create_directories(dataset);
+  for (auto const& entry :
+       fs::directory_iterator(gtfs::SCHEDULES / "example")) {
+    fs::copy_file(entry.path(), dataset / entry.path().filename());
+  }
+
+  auto const opt = loader_options{.dataset_ = {dataset.generic_string()},
+                                  .schedule_begin_ = "20060701",
+                                  .num_days_ = 1,
+                                  .write_serialized_ = true,
+                                  .cache_graph_ = true};
+  auto const serialized = fs::path{opt.fbs_schedule_path(data_dir.string(), 0)};
+  auto const graph = fs::path{opt.graph_path(data_dir.string())};
+
+  auto const load = [&]() {
+    cista::memory_holder buf;
+    return load_schedule(opt, buf, data_dir.string())->hash_;
+  };
+
+  // Outputs written by the loader get a new modification time, reused ones
+  // keep the (old) time set here.
+  constexpr auto const kOld = std::time_t{1'000'000'000};
+  auto const mark_outputs_old = [&]() {
+    fs::last_write_time(serialized, kOld);
+    fs::last_write_time(graph, kOld);
+  };
+
+  auto const first_hash = load();
+  ASSERT_TRUE(fs::is_regular_file(serialized));
+  ASSERT_TRUE(fs::is_regular_file(graph));
+
+  // unchanged dataset: serialized schedule and graph are reused
+  mark_outputs_old();
+  EXPECT_EQ(first_hash, load());
+  EXPECT_EQ(kOld, fs::last_write_time(serialized));
+  EXPECT_EQ(kOld, fs::last_write_time(graph));
+
+  // unchanged sizes and modification times: the stamp next to the graph
+  // skips hashing the dataset (a same-size in-place edit goes unnoticed)
+  auto const stops = dataset / "stops.txt";
+  auto const stops_time = fs::last_write_time(stops);
+  auto const stops_content = read(stops);
+  ASSERT_TRUE(fs::is_regular_file(graph.generic_string() + ".stamp"));
+  mark_outputs_old();
+  write(stops, std::string{stops_content}.replace(0U, 1U, "#"));
+  fs::last_write_time(stops, stops_time);
+  EXPECT_EQ(first_hash, load());
+  EXPECT_EQ(kOld, fs::last_write_time(graph));
+  write(stops, stops_content);
+  fs::last_write_time(stops, stops_time);
+
+  // touched, but unchanged dataset: content hash matches, graph reused
+  mark_outputs_old();
+  fs::last_write_time(stops, kOld);
+  EXPECT_EQ(first_hash, load());
+  EXPECT_EQ(kOld, fs::last_write_time(serialized));
+  EXPECT_EQ(kOld, fs::last_write_time(graph));
+
+  // changed dataset: parsed again, graph rebuilt
+  mark_outputs_old();
+  append(dataset / "transfers.txt", "\n");
+  EXPECT_NE(first_hash, load());
+  EXPECT_NE(kOld, fs::last_write_time(serialized));
+  EXPECT_NE(kOld, fs::last_write_time(graph));
+
+  fs::remove_all(root);
+}
+
+}  // namespace motis::loader
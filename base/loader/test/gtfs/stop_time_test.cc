@@ -1,5 +1,9 @@
+#include <string>
+
 #include "gtest/gtest.h"
 
+#include "motis/core/common/timing.h"
+
 #include "motis/loader/gtfs/files.h"
 #include "motis/loader/gtfs/stop_time.h"
 
@@ -65,4 +69,95 @@ TEST(loader_gtfs_route, read_stop_times_example_data) {
   EXPECT_TRUE(stop.dep_.in_out_allowed_);
 }
 
+namespace {
+
+struct synthetic_feed {
+  synthetic_feed(unsigned const trip_count, unsigned const stop_count)
+      : trip_count_{trip_count}, stop_count_{stop_count} {
+    for (auto i = 0U; i != stop_count; ++i) {
+      auto const id = "S" + std::to_string(i);
+      stops_.emplace(id,
+                     std::make_unique<stop>(stop{id, id, {}, {}, {}, {}, {}}));
+    }
+
+    buf_ =
+        "trip_id,arrival_time,departure_time,stop_id,stop_sequence,"
+        "stop_headsign\n";
+    for (auto t = 0U; t != trip_count; ++t) {
+      for (auto s = 0U; s != stop_count; ++s) {
+        auto const time = std::to_string(10 + s / 60) + ":" +
+                          std::to_string(10 + s % 50) + ":00";
+        buf_ += "T" + std::to_string(t) + "," + time + "," + time + ",S" +
+                std::to_string(s) + "," + std::to_string(s + 1) + ",\"H" +
+                std::to_string(t % 7) + "\"\n";
+      }
+    }
+  }
+
+  trip_map read(std::size_t const chunk_count) const {
+    trip_map trips;
+    for (auto i = 0U; i != trip_count_; ++i) {
+      auto const id = "T" + std::to_string(i);
+      trips.emplace(id, std::make_unique<trip>(nullptr, nullptr, nullptr, id,
+                                               "", "", i + 1));
+    }
+    read_stop_times(loaded_file{"stop_times.txt", std::string{buf_}}, trips,
+                    stops_, chunk_count);
+    return trips;
+  }
+
+  void check(trip_map const& trips, trip_map const& reference) const {
+    ASSERT_EQ(trip_count_, trips.size());
+    for (auto const& [id, t] : trips) {
+      ASSERT_EQ(stop_count_, t->stop_times_.size()) << id;
+      auto ref_it = begin(reference.at(id)->stop_times_);
+      auto seq = 1U;
+      for (auto const& [seq_nr, st] : t->stop_times_) {
+        EXPECT_EQ(seq, seq_nr);
+        EXPECT_EQ("S" + std::to_string(seq - 1), st.stop_->id_);
+        EXPECT_EQ(ref_it->second.headsign_, st.headsign_);
+        EXPECT_EQ(ref_it->second.arr_.time_, st.arr_.time_);
+        ++ref_it;
+        ++seq;
+      }
+    }
+  }
+
+  unsigned trip_count_, stop_count_;
+  stop_map stops_;
+  std::string buf_;
+};
+
+}  // namespace
+
+TEST(loader_gtfs_route, read_stop_times_chunked) {
+  auto const feed = synthetic_feed{200U, 10U};
+  auto const sequential = feed.read(1U);
+  feed.check(sequential, sequential);
+  for (auto const chunk_count : {0U, 2U, 7U, 97U}) {
+    SCOPED_TRACE(chunk_count);
+    feed.check(feed.read(chunk_count), sequential);
+  }
+}
+
+// Multi-MiB feed, compares sequential and parallel parsing.
+TEST(loader_gtfs_route, DISABLED_read_stop_times_benchmark) {
+  auto const feed = synthetic_feed{10'000U, 30U};
+
+  MOTIS_START_TIMING(sequential_timing);
+  auto const sequential = feed.read(1U);
+  MOTIS_STOP_TIMING(sequential_timing);
+
+  MOTIS_START_TIMING(parallel_timing);
+  auto const parallel = feed.read(0U);
+  MOTIS_STOP_TIMING(parallel_timing);
+
+  feed.check(parallel, sequential);
+  RecordProperty("mib", static_cast<int>(feed.buf_.size() / (1024 * 1024)));
+  RecordProperty("sequential_ms",
+                 static_cast<int>(MOTIS_TIMING_MS(sequential_timing)));
+  RecordProperty("parallel_ms",
+                 static_cast<int>(MOTIS_TIMING_MS(parallel_timing)));
+}
+
 }  // namespace motis::loader::gtfs
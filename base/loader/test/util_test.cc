@@ -1,9 +1,13 @@
 #include <cinttypes>
 #include <cstring>
+#include <ctime>
+#include <fstream>
 #include <functional>
 
 #include "gtest/gtest.h"
 
+#include "boost/filesystem.hpp"
+
 #include "utl/parser/arg_parser.h"
 #include "utl/parser/cstr.h"
 
@@ -12,6 +16,7 @@
 #include "motis/loader/util.h"
 
 using namespace utl;
+namespace fs = boost::filesystem;
 
 namespace motis::loader::hrd {
 
@@ -76,4 +81,65 @@ TEST(loader_util, find_nth_not_found_empty_vec) {
   ASSERT_TRUE(it == end(ints));
 }
 
+TEST(loader_util, hash_file) {
+  auto const dir = fs::temp_directory_path() / "motis_loader_hash_file";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto const file = dir / "file.txt";
+
+  EXPECT_EQ(cista::BASE_HASH, hash_file(file, cista::BASE_HASH));
+
+  {
+    std::ofstream out{file.generic_string()};
+    out << "abc";
+  }
+  auto const h1 = hash_file(file, cista::BASE_HASH);
+  EXPECT_NE(cista::BASE_HASH, h1);
+  EXPECT_EQ(h1, hash_file(file, cista::BASE_HASH));
+
+  {
+    std::ofstream out{file.generic_string()};
+    out << "abd";  // same size, different content
+  }
+  EXPECT_NE(h1, hash_file(file, cista::BASE_HASH));
+
+  fs::remove_all(dir);
+}
+
+TEST(loader_util, stamp_file) {
+  auto const dir = fs::temp_directory_path() / "motis_loader_stamp_file";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto const file = dir / "file.txt";
+
+  EXPECT_EQ(cista::BASE_HASH, stamp_file(file, cista::BASE_HASH));
+
+  {
+    std::ofstream out{file.generic_string()};
+    out << "abc";
+  }
+  fs::last_write_time(file, std::time_t{1'000'000'000});
+  auto const s1 = stamp_file(file, cista::BASE_HASH);
+  EXPECT_NE(cista::BASE_HASH, s1);
+
+  {
+    std::ofstream out{file.generic_string()};
+    out << "abd";  // same size, same time: not detected
+  }
+  fs::last_write_time(file, std::time_t{1'000'000'000});
+  EXPECT_EQ(s1, stamp_file(file, cista::BASE_HASH));
+
+  fs::last_write_time(file, std::time_t{1'000'000'001});
+  EXPECT_NE(s1, stamp_file(file, cista::BASE_HASH));
+
+  {
+    std::ofstream out{file.generic_string()};
+    out << "abcd";
+  }
+  fs::last_write_time(file, std::time_t{1'000'000'000});
+  EXPECT_NE(s1, stamp_file(file, cista::BASE_HASH));
+
+  fs::remove_all(dir);
+}
+
 }  // namespace motis::loader::hrd
@@ -10,6 +10,7 @@
 #include "motis/module/ctx_data.h"
 #include "motis/module/future.h"
 #include "motis/module/message.h"
+#include "motis/module/query_recorder.h"
 #include "motis/module/receiver.h"
 #include "motis/module/registry.h"
 #include "motis/module/timer.h"
@@ -61,6 +62,9 @@ struct dispatcher : public receiver, public ctx::access_scheduler<ctx_data> {
   std::vector<std::unique_ptr<module>> modules_;
   std::map<std::string, std::shared_ptr<timer>> timers_;
 
+  // Records slow top-level requests (nullptr = disabled).
+  std::unique_ptr<query_recorder> query_recorder_;
+
   // If this is set to a value != nullptr, it indicates direct mode is on.
   // This implies that in direct mode there can only be one global dispatcher.
   // Direct mode means that
@@ -1,31 +1,69 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "motis/module/message.h"
 
 namespace motis::module {
 
+// Delivers import events to all importers. Import operations handed to
+// schedule() run as soon as their dependencies are published: inline with
+// num_threads_ <= 1, otherwise concurrently on up to num_threads_ threads.
+// Operations known to use several threads themselves can reserve a larger
+// share of that budget (see set_thread_budget).
 struct import_dispatcher {
   using importer_fn = std::function<void(msg_ptr)>;
+  using time_point = std::chrono::steady_clock::time_point;
+
+  struct timeline_entry {
+    std::string name_;
+    unsigned threads_{1U};
+    time_point scheduled_, start_, end_;
+  };
 
   void subscribe(importer_fn&& i) { importers_.emplace_back(std::move(i)); }
 
-  void publish(msg_ptr const& m) { publish_queue_.emplace_back(m); }
+  void publish(msg_ptr const& m);
+  void schedule(std::string name, std::function<void()> op);
+
+  void set_thread_budget(std::string const& name, unsigned threads);
+
+  void run();
+
+  void print_timeline(std::ostream&) const;
 
-  void run() {
-    while (!publish_queue_.empty()) {
-      auto const m = publish_queue_.front();
-      publish_queue_.erase(begin(publish_queue_));
-      for (auto const& i : importers_) {
-        i(m);
-      }
-    }
-  }
+  unsigned num_threads_{1U};
 
   std::vector<importer_fn> importers_;
   std::vector<msg_ptr> publish_queue_;
+
+private:
+  struct task {
+    std::size_t timeline_idx_;
+    std::function<void()> op_;
+  };
+
+  unsigned thread_budget(std::string const& name) const;
+  void start(task&&);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<task> pending_;
+  std::vector<std::thread> workers_;
+  unsigned threads_in_use_{0U};
+  std::size_t running_{0U};
+
+  std::map<std::string, unsigned> thread_budget_;
+  std::vector<timeline_entry> timeline_;
+  time_point begin_{std::chrono::steady_clock::now()};
 };
 
 }  // namespace motis::module
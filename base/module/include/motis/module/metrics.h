@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace motis::module {
+
+// Latency histogram with fixed bucket bounds (upper bounds in microseconds,
+// last bucket: +Inf). Counts are per bucket (not cumulative).
+struct latency_histogram {
+  static constexpr auto const BOUNDS_US = std::array<uint64_t, 12>{
+      1'000U,   5'000U,   10'000U,    25'000U,    50'000U,    100'000U,
+      250'000U, 500'000U, 1'000'000U, 2'500'000U, 5'000'000U, 10'000'000U};
+
+  void observe(std::chrono::microseconds);
+
+  std::array<std::atomic<uint64_t>, BOUNDS_US.size() + 1U> buckets_{};
+  std::atomic<uint64_t> count_{0U};
+  std::atomic<uint64_t> sum_us_{0U};
+};
+
+// Request metrics of one registered operation. Updated lock-free by
+// dispatcher::dispatch for every request handled by the operation.
+struct op_metrics {
+  void record(std::chrono::microseconds queue_time,
+              std::chrono::microseconds latency, bool error);
+
+  std::atomic<uint64_t> requests_{0U};
+  std::atomic<uint64_t> errors_{0U};
+  latency_histogram latency_;
+  latency_histogram queue_time_;
+};
+
+// Records one request into op_metrics (nullptr: no-op). Requests leaving
+// the scope with an exception are counted as errors.
+struct request_timer {
+  using clock = std::chrono::steady_clock;
+
+  request_timer(op_metrics*, clock::time_point enqueued);
+  ~request_timer();
+
+  request_timer(request_timer const&) = delete;
+  request_timer& operator=(request_timer const&) = delete;
+  request_timer(request_timer&&) = delete;
+  request_timer& operator=(request_timer&&) = delete;
+
+  op_metrics* metrics_;
+  clock::time_point enqueued_, start_;
+  int uncaught_exceptions_;
+  bool error_{false};
+};
+
+struct metrics_registry {
+  std::shared_ptr<op_metrics> add(std::string const& target);
+  void clear();
+
+  // Prometheus text exposition format (version 0.0.4)
+  void write_prometheus(std::ostream&) const;
+
+private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<op_metrics>> ops_;
+};
+
+}  // namespace motis::module
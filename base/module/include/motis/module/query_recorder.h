@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "motis/module/message.h"
+
+namespace motis::module {
+
+// Writes requests that took longer than a threshold (or were sampled) to a
+// rotating file: path, path.1, ..., path.<max_files - 1>.
+//
+// Each recorded request takes two lines:
+//   # {"time": ..., "target": ..., "queue_ms": ..., ..., "statistics": ...}
+//   <request as single line JSON>
+// Batch mode skips comment lines, so the file can be replayed directly.
+struct query_recorder {
+  using clock = std::chrono::steady_clock;
+
+  struct config {
+    std::string path_;
+    std::chrono::milliseconds threshold_{1000};
+    double sample_rate_{0.0};
+    std::vector<std::string> targets_;  // empty = all targets
+    std::size_t max_file_size_{100U * 1024U * 1024U};
+    unsigned max_files_{5U};
+  };
+
+  explicit query_recorder(config);
+
+  bool is_candidate(std::string const& target) const;
+
+  // Never throws (errors are logged): called while answering the request.
+  void record(msg_ptr const& req, msg_ptr const& res, std::error_code ec,
+              clock::time_point enqueued, clock::time_point start,
+              clock::time_point end) noexcept;
+
+private:
+  void write(msg_ptr const& req, msg_ptr const& res, std::error_code ec,
+             clock::time_point enqueued, clock::time_point start,
+             clock::time_point end);
+  void rotate();
+
+  config config_;
+  std::mutex mutex_;
+  std::ofstream out_;
+  std::size_t file_size_{0U};
+};
+
+}  // namespace motis::module
@@ -9,6 +9,7 @@
 #include "motis/module/client.h"
 #include "motis/module/global_res_ids.h"
 #include "motis/module/message.h"
+#include "motis/module/metrics.h"
 #include "motis/module/receiver.h"
 
 namespace motis::module {
@@ -19,10 +20,14 @@ using remote_op_fn_t = std::function<void(msg_ptr, callback)>;
 
 struct op {
   op(std::function<msg_ptr(msg_ptr const&)> fn,
-     std::vector<ctx::access_request> access)
-      : fn_{std::move(fn)}, access_{std::move(access)} {}
+     std::vector<ctx::access_request> access,
+     std::shared_ptr<op_metrics> metrics = nullptr)
+      : fn_{std::move(fn)},
+        access_{std::move(access)},
+        metrics_{std::move(metrics)} {}
   op_fn_t fn_;
   ctx::accesses_t access_;
+  std::shared_ptr<op_metrics> metrics_;
 };
 
 struct registry {
@@ -61,6 +66,8 @@ struct registry {
 
   std::mutex mutable remote_op_mutex_;
   std::map<std::string, remote_op_fn_t> remote_operations_;
+
+  metrics_registry metrics_;
 };
 
 }  // namespace motis::module
@@ -4,20 +4,65 @@
 
 namespace motis::module {
 
+namespace {
+
+// Installed as std::clog buffer once: forwards to the target of the current
+// thread so imports running concurrently can log to separate files.
+struct thread_clog_buf : public std::streambuf {
+  explicit thread_clog_buf(std::streambuf* fallback) : fallback_{fallback} {}
+
+  std::streambuf* target() const {
+    return current_ != nullptr ? current_ : fallback_;
+  }
+
+  int_type overflow(int_type c) override {
+    return traits_type::eq_int_type(c, traits_type::eof())
+               ? traits_type::not_eof(c)
+               : target()->sputc(traits_type::to_char_type(c));
+  }
+
+  std::streamsize xsputn(char const* s, std::streamsize n) override {
+    return target()->sputn(s, n);
+  }
+
+  int sync() override { return target()->pubsync(); }
+
+  std::streambuf* fallback_;
+  static thread_local std::streambuf* current_;
+};
+
+thread_local std::streambuf* thread_clog_buf::current_ = nullptr;
+
+struct clog_dispatch {
+  clog_dispatch() : buf_{std::clog.rdbuf()} { std::clog.rdbuf(&buf_); }
+  clog_dispatch(clog_dispatch const&) = delete;
+  clog_dispatch(clog_dispatch&&) = delete;
+  clog_dispatch& operator=(clog_dispatch const&) = delete;
+  clog_dispatch& operator=(clog_dispatch&&) = delete;
+  ~clog_dispatch() { std::clog.rdbuf(buf_.fallback_); }
+  thread_clog_buf buf_;
+};
+
+void install_clog_dispatch() { static auto const dispatch = clog_dispatch{}; }
+
+}  // namespace
+
 clog_redirect::clog_redirect(char const* log_file_path)
-    : backup_clog_{std::clog.rdbuf()} {
+    : backup_clog_{nullptr} {
   if (!enabled_) {
     return;
   }
 
+  install_clog_dispatch();
   sink_.exceptions(std::ios_base::badbit | std::ios_base::failbit);
   sink_.open(log_file_path, std::ios_base::app);
-  std::clog.rdbuf(sink_.rdbuf());
+  backup_clog_ = thread_clog_buf::current_;
+  thread_clog_buf::current_ = sink_.rdbuf();
 }
 
 clog_redirect::~clog_redirect() {
   if (enabled_) {
-    std::clog.rdbuf(backup_clog_);
+    thread_clog_buf::current_ = backup_clog_;
   }
 }
 
@@ -1,5 +1,6 @@
 #include "motis/module/dispatcher.h"
 
+#include <chrono>
 #include <queue>
 #include <string_view>
 
@@ -13,6 +14,8 @@
 #include "motis/core/common/logging.h"
 #include "motis/module/error.h"
 #include "motis/module/global_res_ids.h"
+#include "motis/module/metrics.h"
+#include "motis/module/query_recorder.h"
 #include "motis/module/module.h"
 
 namespace motis::module {
@@ -108,10 +111,30 @@ void dispatcher::dispatch(msg_ptr const& msg, callback const& cb, ctx::op_id id,
     return cb(api_desc(msg->id()), std::error_code{});
   }
 
-  auto const run = [this, id, cb, msg]() {
+  auto const enqueued = std::chrono::steady_clock::now();
+  auto const record = op_type == ctx::op_type_t::IO &&
+                      query_recorder_ != nullptr &&
+                      query_recorder_->is_candidate(id.name);
+  auto const run = [this, id, cb, msg, enqueued, record]() {
+    auto const started = std::chrono::steady_clock::now();
+    auto const done = [&](msg_ptr const& res, std::error_code const ec) {
+      if (record) {
+        query_recorder_->record(msg, res, ec, enqueued, started,
+                                std::chrono::steady_clock::now());
+      }
+      return cb(res, ec);
+    };
+
     try {
       if (auto const op = registry_.get_operation(id.name)) {
-        return cb(op->fn_(msg), std::error_code());
+        msg_ptr res;
+        {
+          request_timer timer{op->metrics_.get(), enqueued};
+          res = op->fn_(msg);
+          timer.error_ = res != nullptr &&
+                         res->get()->content_type() == MsgContent_MotisError;
+        }
+        return done(res, std::error_code());
       } else if (auto const remote_op = registry_.get_remote_op(id.name);
                  remote_op.has_value()) {
         boost::asio::post(runner_.ios_,
@@ -122,13 +145,13 @@ void dispatcher::dispatch(msg_ptr const& msg, callback const& cb, ctx::op_id id,
         return handle_no_target(msg, cb);
       }
     } catch (std::system_error const& e) {
-      return cb(nullptr, e.code());
+      return done(nullptr, e.code());
     } catch (std::exception const& e) {
       LOG(logging::error) << "error executing " << id.name << ": " << e.what();
-      return cb(nullptr, error::unknown_error);
+      return done(nullptr, error::unknown_error);
     } catch (...) {
       LOG(logging::error) << "unknown error executing " << id.name;
-      return cb(nullptr, error::unknown_error);
+      return done(nullptr, error::unknown_error);
     }
   };
 
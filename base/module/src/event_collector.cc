@@ -68,20 +68,25 @@ event_collector* event_collector::require(
       return nullptr;  // Still waiting for a message.
     }
 
-    // All messages arrived -> start.
-    activate_progress_tracker(progress_tracker_);
-    progress_tracker_->status("RUNNING").show_progress(true);
-    try {
-      executed_ = true;
-      op_(dependencies_, [&](msg_ptr const& m) { reg_.publish(m); });
-      progress_tracker_->status("FINISHED").show_progress(false);
-    } catch (std::exception const& e) {
-      progress_tracker_->status(fmt::format("ERROR: {}", e.what()))
-          .show_progress(false);
-    } catch (...) {
-      progress_tracker_->status("ERROR: UNKNOWN EXCEPTION")
-          .show_progress(false);
-    }
+    // All messages arrived -> start (possibly on another thread).
+    executed_ = true;
+    progress_tracker_->status("QUEUED");
+    reg_.schedule(module_name_, [this, self, logs_path] {
+      clog_redirect redirect{
+          (logs_path / (module_name_ + ".txt")).generic_string().c_str()};
+      activate_progress_tracker(progress_tracker_);
+      progress_tracker_->status("RUNNING").show_progress(true);
+      try {
+        op_(dependencies_, [&](msg_ptr const& m) { reg_.publish(m); });
+        progress_tracker_->status("FINISHED").show_progress(false);
+      } catch (std::exception const& e) {
+        progress_tracker_->status(fmt::format("ERROR: {}", e.what()))
+            .show_progress(false);
+      } catch (...) {
+        progress_tracker_->status("ERROR: UNKNOWN EXCEPTION")
+            .show_progress(false);
+      }
+    });
 
     return nullptr;
   });
@@ -0,0 +1,127 @@
+#include "motis/module/import_dispatcher.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace motis::module {
+
+void import_dispatcher::publish(msg_ptr const& m) {
+  {
+    std::lock_guard const lock{mutex_};
+    publish_queue_.emplace_back(m);
+  }
+  cv_.notify_one();
+}
+
+void import_dispatcher::schedule(std::string name, std::function<void()> op) {
+  auto const threads = thread_budget(name);
+  auto const now = std::chrono::steady_clock::now();
+
+  std::unique_lock lock{mutex_};
+  timeline_.emplace_back(timeline_entry{std::move(name), threads, now, {}, {}});
+  auto t = task{timeline_.size() - 1U, std::move(op)};
+
+  if (num_threads_ <= 1U) {
+    timeline_[t.timeline_idx_].start_ = std::chrono::steady_clock::now();
+    lock.unlock();
+    t.op_();
+    lock.lock();
+    timeline_[t.timeline_idx_].end_ = std::chrono::steady_clock::now();
+  } else {
+    pending_.emplace_back(std::move(t));
+  }
+}
+
+void import_dispatcher::set_thread_budget(std::string const& name,
+                                          unsigned const threads) {
+  thread_budget_[name] = std::max(threads, 1U);
+}
+
+unsigned import_dispatcher::thread_budget(std::string const& name) const {
+  auto const it = thread_budget_.find(name);
+  auto const threads = it == end(thread_budget_) ? 1U : it->second;
+  return std::min(threads, std::max(num_threads_, 1U));
+}
+
+void import_dispatcher::start(task&& t) {
+  // mutex_ held by caller
+  auto& entry = timeline_[t.timeline_idx_];
+  entry.start_ = std::chrono::steady_clock::now();
+  threads_in_use_ += entry.threads_;
+  ++running_;
+
+  workers_.emplace_back([this, t = std::move(t)]() {
+    t.op_();
+
+    {
+      std::lock_guard const lock{mutex_};
+      auto& e = timeline_[t.timeline_idx_];
+      e.end_ = std::chrono::steady_clock::now();
+      threads_in_use_ -= e.threads_;
+      --running_;
+    }
+    cv_.notify_one();
+  });
+}
+
+void import_dispatcher::run() {
+  std::unique_lock lock{mutex_};
+  while (true) {
+    if (!publish_queue_.empty()) {
+      auto const m = publish_queue_.front();
+      publish_queue_.erase(begin(publish_queue_));
+      lock.unlock();
+      for (auto const& i : importers_) {
+        i(m);
+      }
+      lock.lock();
+      continue;
+    }
+
+    for (auto it = begin(pending_); it != end(pending_);) {
+      if (threads_in_use_ + timeline_[it->timeline_idx_].threads_ <=
+          num_threads_) {
+        start(std::move(*it));
+        it = pending_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    if (pending_.empty() && running_ == 0U) {
+      break;
+    }
+
+    cv_.wait(lock);
+  }
+  lock.unlock();
+
+  for (auto& w : workers_) {
+    w.join();
+  }
+  workers_.clear();
+}
+
+void import_dispatcher::print_timeline(std::ostream& out) const {
+  using seconds = std::chrono::duration<double>;
+  auto const rel = [&](time_point const t) {
+    return seconds{t - begin_}.count();
+  };
+
+  std::lock_guard const lock{mutex_};
+  out << "import timeline (" << num_threads_ << " threads):\n";
+  out << std::left << std::setw(20) << "module" << std::right  //
+      << std::setw(8) << "threads" << std::setw(10) << "ready"
+      << std::setw(10) << "start" << std::setw(10) << "end"
+      << std::setw(10) << "duration"
+      << "\n";
+  out << std::fixed << std::setprecision(1);
+  for (auto const& e : timeline_) {
+    out << std::left << std::setw(20) << e.name_ << std::right  //
+        << std::setw(8) << e.threads_ << std::setw(10) << rel(e.scheduled_)
+        << std::setw(10) << rel(e.start_) << std::setw(10) << rel(e.end_)
+        << std::setw(10) << seconds{e.end_ - e.start_}.count() << "\n";
+  }
+}
+
+}  // namespace motis::module
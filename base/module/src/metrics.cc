@@ -0,0 +1,124 @@
+#include "motis/module/metrics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+
+namespace motis::module {
+
+void latency_histogram::observe(std::chrono::microseconds const d) {
+  auto const us = static_cast<uint64_t>(std::max(d.count(), int64_t{0}));
+  auto const bucket = static_cast<std::size_t>(
+      std::distance(begin(BOUNDS_US),
+                    std::lower_bound(begin(BOUNDS_US), end(BOUNDS_US), us)));
+  buckets_[bucket].fetch_add(1U, std::memory_order_relaxed);
+  count_.fetch_add(1U, std::memory_order_relaxed);
+  sum_us_.fetch_add(us, std::memory_order_relaxed);
+}
+
+void op_metrics::record(std::chrono::microseconds const queue_time,
+                        std::chrono::microseconds const latency,
+                        bool const error) {
+  requests_.fetch_add(1U, std::memory_order_relaxed);
+  if (error) {
+    errors_.fetch_add(1U, std::memory_order_relaxed);
+  }
+  latency_.observe(latency);
+  queue_time_.observe(queue_time);
+}
+
+request_timer::request_timer(op_metrics* metrics,
+                             clock::time_point const enqueued)
+    : metrics_{metrics},
+      enqueued_{enqueued},
+      start_{clock::now()},
+      uncaught_exceptions_{std::uncaught_exceptions()} {}
+
+request_timer::~request_timer() {
+  if (metrics_ == nullptr) {
+    return;
+  }
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  metrics_->record(
+      duration_cast<microseconds>(start_ - enqueued_),
+      duration_cast<microseconds>(clock::now() - start_),
+      error_ || std::uncaught_exceptions() > uncaught_exceptions_);
+}
+
+std::shared_ptr<op_metrics> metrics_registry::add(std::string const& target) {
+  std::lock_guard const lock{mutex_};
+  auto& m = ops_[target];
+  if (m == nullptr) {
+    m = std::make_shared<op_metrics>();
+  }
+  return m;
+}
+
+void metrics_registry::clear() {
+  std::lock_guard const lock{mutex_};
+  ops_.clear();
+}
+
+namespace {
+
+void write_histogram(std::ostream& out, char const* name,
+                     std::string const& target, latency_histogram const& h) {
+  auto cumulative = uint64_t{0U};
+  for (auto i = 0U; i != h.buckets_.size(); ++i) {
+    cumulative += h.buckets_[i].load(std::memory_order_relaxed);
+    out << name << "_bucket{target=\"" << target << "\",le=\"";
+    if (i == latency_histogram::BOUNDS_US.size()) {
+      out << "+Inf";
+    } else {
+      out << latency_histogram::BOUNDS_US[i] / 1e6;
+    }
+    out << "\"} " << cumulative << "\n";
+  }
+  out << name << "_sum{target=\"" << target << "\"} "
+      << h.sum_us_.load(std::memory_order_relaxed) / 1e6 << "\n";
+  out << name << "_count{target=\"" << target << "\"} "
+      << h.count_.load(std::memory_order_relaxed) << "\n";
+}
+
+}  // namespace
+
+void metrics_registry::write_prometheus(std::ostream& out) const {
+  std::lock_guard const lock{mutex_};
+  auto const flags = out.flags();
+  auto const precision = out.precision();
+  out << std::fixed << std::setprecision(6);
+
+  out << "# HELP motis_requests_total Requests handled per target.\n"
+      << "# TYPE motis_requests_total counter\n";
+  for (auto const& [target, m] : ops_) {
+    out << "motis_requests_total{target=\"" << target << "\"} "
+        << m->requests_.load(std::memory_order_relaxed) << "\n";
+  }
+
+  out << "# HELP motis_request_errors_total Failed requests per target.\n"
+      << "# TYPE motis_request_errors_total counter\n";
+  for (auto const& [target, m] : ops_) {
+    out << "motis_request_errors_total{target=\"" << target << "\"} "
+        << m->errors_.load(std::memory_order_relaxed) << "\n";
+  }
+
+  out << "# HELP motis_request_duration_seconds Request processing time.\n"
+      << "# TYPE motis_request_duration_seconds histogram\n";
+  for (auto const& [target, m] : ops_) {
+    write_histogram(out, "motis_request_duration_seconds", target,
+                    m->latency_);
+  }
+
+  out << "# HELP motis_request_queue_seconds Time from dispatch to start.\n"
+      << "# TYPE motis_request_queue_seconds histogram\n";
+  for (auto const& [target, m] : ops_) {
+    write_histogram(out, "motis_request_queue_seconds", target,
+                    m->queue_time_);
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
+
+}  // namespace motis::module
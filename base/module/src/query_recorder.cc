@@ -0,0 +1,174 @@
+#include "motis/module/query_recorder.h"
+
+#include <algorithm>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include <string_view>
+
+#include "boost/filesystem.hpp"
+
+#include "utl/to_vec.h"
+#include "utl/verify.h"
+
+#include "motis/core/common/logging.h"
+
+namespace fs = boost::filesystem;
+
+namespace motis::module {
+
+namespace {
+
+bool sample(double const rate) {
+  if (rate <= 0.0) {
+    return false;
+  }
+  thread_local std::mt19937 gen{std::random_device{}()};
+  return std::uniform_real_distribution<double>{0.0, 1.0}(gen) < rate;
+}
+
+std::string json_escape(std::string_view const in) {
+  std::string out;
+  out.reserve(in.size());
+  for (auto const c : in) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20U) {
+          constexpr auto const hex = "0123456789abcdef";
+          out += "\\u00";
+          out += hex[(c >> 4) & 0xF];
+          out += hex[c & 0xF];
+        } else {
+          out += c;
+        }
+    }
+  }
+  return out;
+}
+
+// Statistics of routing responses (routing, intermodal, csa, raptor, ...).
+std::string statistics_json(msg_ptr const& res) {
+  if (res == nullptr ||
+      res->get()->content_type() != MsgContent_RoutingResponse) {
+    return "null";
+  }
+
+  auto const routing_res = motis_content(RoutingResponse, res);
+  if (routing_res->statistics() == nullptr) {
+    return "null";
+  }
+
+  message_creator mc;
+  mc.create_and_finish(
+      MsgContent_StatisticsResponse,
+      CreateStatisticsResponse(
+          mc, mc.CreateVector(utl::to_vec(
+                  *routing_res->statistics(),
+                  [&](Statistics const* s) {
+                    return CreateStatistics(
+                        mc, mc.CreateString(s->category()->str()),
+                        mc.CreateVector(utl::to_vec(
+                            *s->entries(), [&](StatisticsEntry const* e) {
+                              return CreateStatisticsEntry(
+                                  mc, mc.CreateString(e->name()->str()),
+                                  e->value());
+                            })));
+                  })))
+          .Union());
+  return make_msg(mc)->to_json(true);
+}
+
+}  // namespace
+
+query_recorder::query_recorder(config c) : config_{std::move(c)} {
+  utl::verify(config_.max_files_ != 0U, "query recorder: max_files = 0");
+  auto const dir = fs::path{config_.path_}.parent_path();
+  if (!dir.empty()) {
+    fs::create_directories(dir);
+  }
+  out_.open(config_.path_, std::ios_base::app);
+  utl::verify(out_.is_open(), "query recorder: cannot open {}", config_.path_);
+  file_size_ = fs::file_size(config_.path_);
+}
+
+bool query_recorder::is_candidate(std::string const& target) const {
+  return config_.targets_.empty() ||
+         std::find(begin(config_.targets_), end(config_.targets_), target) !=
+             end(config_.targets_);
+}
+
+void query_recorder::record(msg_ptr const& req, msg_ptr const& res,
+                            std::error_code const ec,
+                            clock::time_point const enqueued,
+                            clock::time_point const start,
+                            clock::time_point const end) noexcept {
+  try {
+    write(req, res, ec, enqueued, start, end);
+  } catch (std::exception const& e) {
+    LOG(logging::error) << "query recorder: " << e.what();
+  } catch (...) {
+    LOG(logging::error) << "query recorder: unknown error";
+  }
+}
+
+void query_recorder::write(msg_ptr const& req, msg_ptr const& res,
+                           std::error_code const ec,
+                           clock::time_point const enqueued,
+                           clock::time_point const start,
+                           clock::time_point const end) {
+  using std::chrono::duration;
+  using ms = duration<double, std::milli>;
+
+  auto const total = end - enqueued;
+  auto const slow = total >= config_.threshold_;
+  if (!slow && !sample(config_.sample_rate_)) {
+    return;
+  }
+
+  std::stringstream ss;
+  ss << "# {\"time\": " << std::time(nullptr)  //
+     << ", \"target\": \""
+     << json_escape(req->get()->destination()->target()->str())
+     << "\", \"reason\": \"" << (slow ? "slow" : "sampled")
+     << "\", \"queue_ms\": " << ms{start - enqueued}.count()
+     << ", \"processing_ms\": " << ms{end - start}.count()
+     << ", \"total_ms\": " << ms{total}.count() << ", \"error\": \""
+     << (ec ? json_escape(ec.message()) : "") << "\", \"response_type\": \""
+     << (res == nullptr ? "" : EnumNameMsgContent(res->get()->content_type()))
+     << "\", \"response_size\": " << (res == nullptr ? 0U : res->size())
+     << ", \"statistics\": " << statistics_json(res) << "}\n"
+     << req->to_json(true) << "\n";
+  auto const entry = ss.str();
+
+  std::lock_guard const lock{mutex_};
+  if (file_size_ != 0U && file_size_ + entry.size() > config_.max_file_size_) {
+    rotate();
+  }
+  out_ << entry;
+  out_.flush();
+  file_size_ += entry.size();
+}
+
+void query_recorder::rotate() {
+  // mutex_ held by caller
+  out_.close();
+  for (auto i = config_.max_files_ - 1U; i != 0U; --i) {
+    auto const from = i == 1U ? config_.path_
+                              : config_.path_ + "." + std::to_string(i - 1U);
+    auto const to = config_.path_ + "." + std::to_string(i);
+    boost::system::error_code ec;
+    fs::rename(from, to, ec);
+  }
+  out_.open(config_.path_, std::ios_base::trunc);
+  if (!out_.is_open()) {
+    LOG(logging::error) << "query recorder: cannot open " << config_.path_;
+  }
+  file_size_ = 0U;
+}
+
+}  // namespace motis::module
@@ -16,7 +16,10 @@ void registry::register_op(std::string const& name, op_fn_t fn,
   auto const call = [fn_rec = std::move(fn),
                      name](msg_ptr const& m) -> msg_ptr { return fn_rec(m); };
   auto const inserted =
-      operations_.emplace(name, op{std::move(call), std::move(access)}).second;
+      operations_
+          .emplace(name,
+                   op{std::move(call), std::move(access), metrics_.add(name)})
+          .second;
   utl::verify(inserted, "register_op: target {} already registered");
 }
 
@@ -92,6 +95,7 @@ void registry::reset() {
   operations_.clear();
   topic_subscriptions_.clear();
   remote_operations_.clear();
+  metrics_.clear();
 }
 
 }  // namespace motis::module
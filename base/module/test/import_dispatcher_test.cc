@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "motis/module/import_dispatcher.h"
+#include "motis/module/message.h"
+
+using namespace motis::module;
+
+namespace {
+
+std::string target(msg_ptr const& m) {
+  return m->get()->destination()->target()->str();
+}
+
+// a, b and big start on "/start", c requires the results of a and b.
+void run_imports(import_dispatcher& d, std::atomic<int>& c_runs) {
+  auto finished = 0;
+  d.subscribe([&](msg_ptr const& m) {
+    if (target(m) == "/start") {
+      for (auto const* name : {"a", "b", "big"}) {
+        d.schedule(name, [&d, name] {
+          std::this_thread::sleep_for(std::chrono::milliseconds{20});
+          d.publish(make_success_msg(std::string{"/done/"} + name));
+        });
+      }
+    } else if (target(m) == "/done/a" || target(m) == "/done/b") {
+      if (++finished == 2) {
+        d.schedule("c", [&] { ++c_runs; });
+      }
+    }
+  });
+  d.publish(make_success_msg("/start"));
+  d.run();
+}
+
+}  // namespace
+
+TEST(module_import_dispatcher, sequential) {
+  auto d = import_dispatcher{};
+  auto c_runs = std::atomic<int>{0};
+  run_imports(d, c_runs);
+  EXPECT_EQ(1, c_runs);
+}
+
+TEST(module_import_dispatcher, parallel) {
+  auto d = import_dispatcher{};
+  d.num_threads_ = 4U;
+  d.set_thread_budget("big", 3U);
+  auto c_runs = std::atomic<int>{0};
+  run_imports(d, c_runs);
+  EXPECT_EQ(1, c_runs);
+
+  std::stringstream ss;
+  d.print_timeline(ss);
+  for (auto const* name : {"a", "b", "big", "c"}) {
+    EXPECT_NE(std::string::npos,
+              ss.str().find(std::string{"\n"} + name + " "));
+  }
+}
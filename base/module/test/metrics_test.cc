@@ -0,0 +1,44 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "motis/module/metrics.h"
+
+using namespace motis::module;
+using namespace std::chrono_literals;
+
+TEST(module_metrics, record_and_export) {
+  metrics_registry reg;
+  auto const m = reg.add("/routing");
+  EXPECT_EQ(m, reg.add("/routing"));
+
+  m->record(10us, 3ms, false);  // bucket le=0.005
+  m->record(0us, 20s, true);  // bucket +Inf
+
+  auto const now = request_timer::clock::now();
+  try {
+    request_timer t{m.get(), now};
+    throw std::runtime_error{"fail"};
+  } catch (std::runtime_error const&) {
+  }
+  { request_timer t{nullptr, now}; }
+
+  EXPECT_EQ(3U, m->requests_);
+  EXPECT_EQ(2U, m->errors_);
+  EXPECT_EQ(3U, m->latency_.count_);
+
+  std::stringstream ss;
+  reg.write_prometheus(ss);
+  auto const out = ss.str();
+  EXPECT_NE(std::string::npos,
+            out.find("motis_requests_total{target=\"/routing\"} 3\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_request_errors_total{target=\"/routing\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_request_duration_seconds_bucket{target=\"/"
+                     "routing\",le=\"0.005000\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            out.find("motis_request_duration_seconds_bucket{target=\"/"
+                     "routing\",le=\"+Inf\"} 3\n"));
+}
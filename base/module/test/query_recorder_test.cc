@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "boost/filesystem.hpp"
+
+#include "motis/module/message.h"
+#include "motis/module/query_recorder.h"
+
+namespace fs = boost::filesystem;
+using namespace motis::module;
+
+namespace {
+
+struct quoting_category : std::error_category {
+  char const* name() const noexcept override { return "quoting"; }
+  std::string message(int) const override {
+    return "say \"hi\"\n\\ \x01";
+  }
+};
+
+}  // namespace
+
+TEST(module_query_recorder, record_and_rotate) {
+  auto const dir = fs::temp_directory_path() / fs::unique_path();
+  auto const path = (dir / "slow_queries.txt").generic_string();
+
+  auto const now = query_recorder::clock::now();
+  {
+    query_recorder rec{query_recorder::config{
+        path, std::chrono::milliseconds{100}, 0.0, {"/lookup/id_train"},
+        1U, 3U}};
+    EXPECT_TRUE(rec.is_candidate("/lookup/id_train"));
+    EXPECT_FALSE(rec.is_candidate("/routing"));
+
+    auto const req = make_no_msg("/lookup/id_train");
+    rec.record(req, nullptr, {}, now, now, now);  // fast: not recorded
+    EXPECT_EQ(0U, fs::file_size(path));
+
+    auto const slow = now + std::chrono::milliseconds{200};
+    for (auto i = 0; i != 4; ++i) {
+      rec.record(req, nullptr, {}, now, now, slow);
+    }
+  }
+
+  // max_file_size exceeded by every entry: one entry per file, 3 files kept
+  EXPECT_TRUE(fs::exists(path));
+  EXPECT_TRUE(fs::exists(path + ".1"));
+  EXPECT_TRUE(fs::exists(path + ".2"));
+  EXPECT_FALSE(fs::exists(path + ".3"));
+
+  std::ifstream in{path};
+  std::string meta, request;
+  ASSERT_TRUE(std::getline(in, meta));
+  ASSERT_TRUE(std::getline(in, request));
+  EXPECT_EQ('#', meta.front());
+  EXPECT_NE(std::string::npos, meta.find("\"reason\": \"slow\""));
+  EXPECT_EQ("/lookup/id_train",
+            make_msg(request)->get()->destination()->target()->str());
+
+  fs::remove_all(dir);
+}
+
+TEST(module_query_recorder, escape_error_message) {
+  auto const dir = fs::temp_directory_path() / fs::unique_path();
+  auto const path = (dir / "slow_queries.txt").generic_string();
+
+  static quoting_category const category;
+  auto const now = query_recorder::clock::now();
+  {
+    query_recorder rec{query_recorder::config{
+        path, std::chrono::milliseconds{100}, 0.0, {"/lookup/id_train"},
+        1024U * 1024U, 3U}};
+    rec.record(make_no_msg("/lookup/id_train"), nullptr,
+               std::error_code{1, category}, now, now,
+               now + std::chrono::milliseconds{200});
+  }
+
+  std::ifstream in{path};
+  std::string meta, request, rest;
+  ASSERT_TRUE(std::getline(in, meta));
+  ASSERT_TRUE(std::getline(in, request));
+  EXPECT_FALSE(std::getline(in, rest));
+  EXPECT_NE(std::string::npos,
+            meta.find(R"("error": "say \"hi\"\n\\ \u0001")"));
+  EXPECT_EQ("/lookup/id_train",
+            make_msg(request)->get()->destination()->target()->str());
+
+  fs::remove_all(dir);
+}
@@ -11,6 +11,7 @@
 #include "motis/module/message.h"
 
 #include "motis/path/path_database.h"
+#include "motis/path/path_feature_cache.h"
 
 #include "motis/path/fbs/InternalDbSequence_generated.h"
 
@@ -21,6 +22,7 @@ struct path_database_query {
       std::numeric_limits<uint64_t>::max();
   static constexpr auto kExtraSequenceIndex =
       std::numeric_limits<size_t>::max();
+  static constexpr auto kMinParallelSubqueries = size_t{16};
 
   struct resolvable_feature {
     uint32_t use_count() const { return fwd_use_count_ + bwd_use_count_; }
@@ -51,13 +53,16 @@ struct path_database_query {
     std::vector<std::unique_ptr<resolvable_feature>> mem_;
   };
 
-  explicit path_database_query(int const zoom_level = -1)
-      : zoom_level_{zoom_level} {}
+  explicit path_database_query(int const zoom_level = -1,
+                               path_feature_cache* cache = nullptr)
+      : zoom_level_{zoom_level}, cache_{cache} {}
 
   void add_sequence(size_t index, std::vector<size_t> segment_indices = {});
   void add_extra(std::vector<geo::polyline> const&);
 
-  void execute(path_database const&);
+  // parallel: split large queries into chunks run via motis_parallel_for
+  // (requires a running ctx operation or the direct mode dispatcher)
+  void execute(path_database const&, bool parallel = false);
   void resolve_sequences_and_build_subqueries(lmdb::cursor&);
   void execute_subquery(tiles::tile_key_t, subquery&, lmdb::cursor&,
                         tiles::pack_handle const&);
@@ -76,6 +81,7 @@ struct path_database_query {
       std::vector<uint64_t>& fbs_extras);
 
   int zoom_level_;
+  path_feature_cache* cache_;
 
   std::vector<resolvable_sequence> sequences_;
   mcd::hash_map<tiles::tile_key_t, subquery> subqueries_;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tiles/fixed/fixed_geometry.h"
+
+#include "motis/core/common/lru_cache.h"
+#include "motis/core/statistics/statistics.h"
+
+namespace motis::path {
+
+// LRU cache of decoded feature geometries, keyed by (feature id, zoom level).
+// Lets path_database_query skip LMDB reads and decoding for hot sequences.
+struct path_feature_cache {
+  using key_t = std::pair<uint64_t, int>;
+  using geometry_ptr = std::shared_ptr<tiles::fixed_geometry const>;
+
+  explicit path_feature_cache(std::size_t max_entries);
+
+  geometry_ptr get(uint64_t feature_id, int zoom_level);
+  void put(uint64_t feature_id, int zoom_level, tiles::fixed_geometry const&);
+
+  stats_category get_stats(std::string const& name) const;
+
+private:
+  struct key_hash {
+    std::size_t operator()(key_t const&) const;
+  };
+
+  lru_cache<key_t, geometry_ptr, lru_entry_count, key_hash> cache_;
+};
+
+}  // namespace motis::path
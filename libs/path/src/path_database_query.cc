@@ -1,5 +1,9 @@
 #include "motis/path/path_database_query.h"
 
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
 #include "tiles/db/tile_index.h"
 #include "tiles/fixed/convert.h"
 #include "tiles/fixed/fixed_geometry.h"
@@ -13,6 +17,8 @@
 #include "utl/to_vec.h"
 #include "utl/verify.h"
 
+#include "motis/module/context/motis_parallel_for.h"
+
 #include "motis/path/definitions.h"
 #include "motis/path/polyline_builder.h"
 
@@ -51,30 +57,88 @@ void path_database_query::add_extra(std::vector<geo::polyline> const& extra) {
   sequences_.emplace_back(std::move(rs));
 }
 
-void path_database_query::execute(path_database const& db) {
-  auto txn = db.db_handle_->make_txn();
+void path_database_query::execute(path_database const& db,
+                                  bool const parallel) {
   {
+    auto txn = db.db_handle_->make_txn();
     auto dbi = path_database::data_dbi(txn);
     auto cursor = lmdb::cursor{txn, dbi};
     resolve_sequences_and_build_subqueries(cursor);
   }
-  {
+
+  std::vector<resolvable_feature*> to_cache;
+  std::vector<std::pair<tiles::tile_key_t, subquery*>> pending;
+  for (auto& [hint, subquery] : subqueries_) {
+    auto unresolved = false;
+    for (auto const& rf : subquery.mem_) {
+      if (cache_ != nullptr) {
+        if (auto const geo = cache_->get(rf->feature_id_, zoom_level_);
+            geo != nullptr) {
+          rf->geometry_ = *geo;
+          rf->is_resolved_ = true;
+          continue;
+        }
+        to_cache.emplace_back(rf.get());
+      }
+      unresolved = true;
+    }
+    if (unresolved) {
+      pending.emplace_back(hint, &subquery);
+    }
+  }
+
+  // every chunk uses its own read transaction (LMDB read transactions are
+  // bound to the thread which created them), opened and closed without
+  // suspending the running operation
+  auto const execute_range = [&](size_t const from, size_t const to) {
+    auto txn = db.db_handle_->make_txn();
     auto dbi = db.db_handle_->features_dbi(txn);
     auto cursor = lmdb::cursor{txn, dbi};
-    for (auto& [hint, subquery] : subqueries_) {
-      execute_subquery(hint, subquery, cursor, *db.pack_handle_);
+    for (auto i = from; i < to; ++i) {
+      execute_subquery(pending[i].first, *pending[i].second, cursor,
+                       *db.pack_handle_);
+    }
+  };
+
+  if (!parallel || pending.size() < kMinParallelSubqueries) {
+    execute_range(0U, pending.size());
+  } else {
+    std::vector<size_t> chunks(std::min(
+        pending.size() / kMinParallelSubqueries,
+        static_cast<size_t>(std::max(1U, std::thread::hardware_concurrency()))));
+    std::iota(begin(chunks), end(chunks), size_t{0U});
+    motis_parallel_for(chunks, ([&](size_t const chunk) {
+                         execute_range(
+                             chunk * pending.size() / chunks.size(),
+                             (chunk + 1) * pending.size() / chunks.size());
+                       }));
+  }
+
+  for (auto const* rf : to_cache) {
+    if (rf->is_resolved_) {
+      cache_->put(rf->feature_id_, zoom_level_, rf->geometry_);
     }
   }
 }
 
 void path_database_query::resolve_sequences_and_build_subqueries(
     lmdb::cursor& cursor) {
+  // look up sequences in key order for better locality in the database
+  std::vector<std::pair<std::string, resolvable_sequence*>> sorted;
+  sorted.reserve(sequences_.size());
   for (auto& rs : sequences_) {
+    sorted.emplace_back(std::to_string(rs.index_), &rs);
+  }
+  std::sort(begin(sorted), end(sorted),
+            [](auto const& a, auto const& b) { return a.first < b.first; });
+
+  for (auto& [key, rs_ptr] : sorted) {
+    auto& rs = *rs_ptr;
     if (rs.index_ == kExtraSequenceIndex) {
       continue;
     }
 
-    auto ret = cursor.get(lmdb::cursor_op::SET, std::to_string(rs.index_));
+    auto ret = cursor.get(lmdb::cursor_op::SET, key);
     utl::verify(ret.has_value(), "path_database_query: {} not found :E",
                 rs.index_);
 
@@ -0,0 +1,37 @@
+#include "motis/path/path_feature_cache.h"
+
+#include "cista/hash.h"
+
+namespace motis::path {
+
+std::size_t path_feature_cache::key_hash::operator()(key_t const& k) const {
+  return cista::hash_combine(cista::BASE_HASH, k.first, k.second);
+}
+
+path_feature_cache::path_feature_cache(std::size_t const max_entries)
+    : cache_{max_entries} {}
+
+path_feature_cache::geometry_ptr path_feature_cache::get(
+    uint64_t const feature_id, int const zoom_level) {
+  return cache_.get({feature_id, zoom_level}).value_or(nullptr);
+}
+
+void path_feature_cache::put(uint64_t const feature_id, int const zoom_level,
+                             tiles::fixed_geometry const& geometry) {
+  if (cache_.capacity() == 0U) {
+    return;
+  }
+  cache_.put({feature_id, zoom_level},
+             std::make_shared<tiles::fixed_geometry const>(geometry));
+}
+
+stats_category path_feature_cache::get_stats(std::string const& name) const {
+  auto const stats = cache_.stats();
+  return stats_category{name,
+                        {{"entries", stats.entries_},
+                         {"hits", stats.hits_},
+                         {"misses", stats.misses_},
+                         {"evictions", stats.evictions_}}};
+}
+
+}  // namespace motis::path
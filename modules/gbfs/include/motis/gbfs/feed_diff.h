@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "motis/gbfs/free_bike.h"
+#include "motis/gbfs/station.h"
+
+namespace motis::gbfs {
+
+// Equality ignoring the number of available vehicles.
+inline bool same_except_availability(station const& a, station const& b) {
+  return a.id_ == b.id_ && a.name_ == b.name_ && a.pos_ == b.pos_;
+}
+
+inline bool same_except_availability(free_bike const& a, free_bike const& b) {
+  return a == b;
+}
+
+struct feed_diff {
+  bool empty() const {
+    return added_ == 0U && removed_ == 0U && changed_ == 0U;
+  }
+
+  unsigned added_{0U}, removed_{0U}, changed_{0U};
+
+  // false: all entries are at the same index and position as before,
+  // i.e. spatial indices built for the previous version remain valid
+  bool positions_changed_{false};
+
+  // false: at most the availability of existing entries changed
+  bool attributes_changed_{false};
+};
+
+template <typename T>
+void sort_by_id(std::vector<T>& v) {
+  std::sort(begin(v), end(v),
+            [](T const& a, T const& b) { return a.id_ < b.id_; });
+}
+
+// T: station or free_bike, both vectors have to be sorted by id_.
+template <typename T>
+feed_diff diff_feed(std::vector<T> const& prev, std::vector<T> const& next) {
+  auto d = feed_diff{};
+  auto a = begin(prev);
+  auto b = begin(next);
+  while (a != end(prev) || b != end(next)) {
+    if (b == end(next) || (a != end(prev) && a->id_ < b->id_)) {
+      ++d.removed_;
+      ++a;
+    } else if (a == end(prev) || b->id_ < a->id_) {
+      ++d.added_;
+      ++b;
+    } else {
+      if (!(*a == *b)) {
+        ++d.changed_;
+        d.positions_changed_ |= !(a->pos_ == b->pos_);
+        d.attributes_changed_ |= !same_except_availability(*a, *b);
+      }
+      ++a;
+      ++b;
+    }
+  }
+  d.positions_changed_ |= d.added_ != 0U || d.removed_ != 0U;
+  d.attributes_changed_ |= d.positions_changed_;
+  return d;
+}
+
+}  // namespace motis::gbfs
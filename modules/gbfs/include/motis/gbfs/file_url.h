@@ -0,0 +1,17 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace motis::gbfs {
+
+// Feed URLs with the "file://" prefix are read from the local file system
+// (e.g. for tests or mirrored feeds).
+bool is_file_url(std::string_view url);
+
+// Returns the file content for "file://" URLs, std::nullopt for other URLs.
+// Throws if the file cannot be read.
+std::optional<std::string> read_file_url(std::string_view url);
+
+}  // namespace motis::gbfs
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace motis::gbfs {
+
+using cost_t = std::uint16_t;  // minutes
+constexpr auto const kUnreachable = std::numeric_limits<cost_t>::max();
+
+inline cost_t to_cost(double const seconds) {
+  auto const minutes = std::ceil(seconds / 60.0);
+  return minutes < kUnreachable ? static_cast<cost_t>(minutes) : kUnreachable;
+}
+
+// Row-major matrix of durations in minutes.
+struct cost_matrix {
+  cost_matrix() = default;
+  cost_matrix(std::size_t const rows, std::size_t const cols)
+      : rows_{rows}, cols_{cols}, data_(rows * cols, kUnreachable) {}
+
+  cost_t& operator()(std::size_t const row, std::size_t const col) {
+    return data_[row * cols_ + col];
+  }
+  cost_t operator()(std::size_t const row, std::size_t const col) const {
+    return data_[row * cols_ + col];
+  }
+
+  cost_t const* row(std::size_t const row) const {
+    return data_.data() + row * cols_;
+  }
+
+  std::size_t rows_{0U}, cols_{0U};
+  std::vector<cost_t> data_;
+};
+
+// Reads columns [offset, offset + cols) of a row-major table of durations in
+// seconds with the given number of rows and columns (stride).
+// transpose = true: the resulting matrix is cols x rows.
+template <typename Seconds>
+cost_matrix to_cost_matrix(Seconds&& seconds, std::size_t const rows,
+                           std::size_t const stride, std::size_t const offset,
+                           std::size_t const cols, bool const transpose) {
+  auto m = transpose ? cost_matrix{cols, rows} : cost_matrix{rows, cols};
+  for (auto r = std::size_t{0U}; r != rows; ++r) {
+    for (auto c = std::size_t{0U}; c != cols; ++c) {
+      auto const cost = to_cost(seconds(r * stride + offset + c));
+      if (transpose) {
+        m(c, r) = cost;
+      } else {
+        m(r, c) = cost;
+      }
+    }
+  }
+  return m;
+}
+
+struct min_plus_row {
+  cost_t base_;  // added to every entry of the row
+  cost_t limit_;  // entries > limit_ are ignored
+  std::uint32_t row_;  // row index in the matrix
+};
+
+// For every column c of m (rows: all rows with the same prefix path):
+//   best[c] = min { r.base_ + m(r.row_, c) | r in rows, m(r.row_, c) <= limit }
+// arg[c] is set to the index (in rows) of the first row reaching the minimum.
+// Only values strictly better than the initial value of best[c] are stored.
+void min_plus(std::vector<min_plus_row> const& rows, cost_matrix const& m,
+              std::vector<cost_t>& best, std::vector<std::uint32_t>& arg);
+
+}  // namespace motis::gbfs
@@ -0,0 +1,24 @@
+#include "motis/gbfs/file_url.h"
+
+#include "utl/read_file.h"
+#include "utl/verify.h"
+
+namespace motis::gbfs {
+
+constexpr auto const kFilePrefix = std::string_view{"file://"};
+
+bool is_file_url(std::string_view const url) {
+  return url.starts_with(kFilePrefix);
+}
+
+std::optional<std::string> read_file_url(std::string_view const url) {
+  if (!is_file_url(url)) {
+    return std::nullopt;
+  }
+  auto const path = std::string{url.substr(kFilePrefix.size())};
+  auto content = utl::read_file(path.c_str());
+  utl::verify(content.has_value(), "gbfs: unable to read {}", path);
+  return content;
+}
+
+}  // namespace motis::gbfs
@@ -1,7 +1,11 @@
 #include "motis/gbfs/gbfs.h"
 
+#include <chrono>
 #include <mutex>
 #include <numeric>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
 
 #include "boost/filesystem.hpp"
 
@@ -29,7 +33,10 @@
 #include "motis/module/context/motis_parallel_for.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/message.h"
+#include "motis/gbfs/feed_diff.h"
+#include "motis/gbfs/file_url.h"
 #include "motis/gbfs/free_bike.h"
+#include "motis/gbfs/min_plus.h"
 #include "motis/gbfs/station.h"
 #include "motis/gbfs/system_information.h"
 #include "motis/gbfs/system_status.h"
@@ -77,6 +84,27 @@ struct gbfs::impl {
   explicit impl(fs::path data_dir, config const& c, schedule const& sched)
       : config_{c}, sched_{sched}, data_dir_{std::move(data_dir)} {}
 
+  struct tiles_database;
+  struct provider_data;
+
+  // Feeds are fetched via HTTP, see file_url.h for local files.
+  struct feed_request {
+    explicit feed_request(std::string const& url) {
+      if (auto content = read_file_url(url); content.has_value()) {
+        content_ = std::move(*content);
+      } else {
+        future_ = motis_http(url);
+      }
+    }
+
+    std::string get() const {
+      return future_ != nullptr ? future_->val().body : content_;
+    }
+
+    http_future_t future_;
+    std::string content_;
+  };
+
   void fetch_stream(std::string url) {
     auto tag = std::string{"default"};
     auto vehicle_type = std::string{"bike"};
@@ -93,7 +121,7 @@ struct gbfs::impl {
       url = url.substr(tag_pos + 1);
     }
 
-    auto const s = read_system_status(motis_http(url)->val().body);
+    auto const s = read_system_status(feed_request{url}.get());
     if (s.empty()) {
       l(warn, "no feeds from {}", url);
       return;
@@ -101,48 +129,120 @@ struct gbfs::impl {
 
     auto const& urls = s.front();
 
-    auto f_station_info = http_future_t{};
-    auto f_station_status = http_future_t{};
-    auto f_free_bikes = http_future_t{};
-    auto f_system_info = http_future_t{};
+    auto f_station_info = std::optional<feed_request>{};
+    auto f_station_status = std::optional<feed_request>{};
+    auto f_free_bikes = std::optional<feed_request>{};
+    auto f_system_info = std::optional<feed_request>{};
 
     if (urls.station_info_url_.has_value()) {
-      f_station_info = motis_http(*urls.station_info_url_);
-      f_station_status = motis_http(*urls.station_status_url_);
+      f_station_info.emplace(*urls.station_info_url_);
+      f_station_status.emplace(*urls.station_status_url_);
     }
 
     if (urls.free_bike_url_.has_value()) {
-      f_free_bikes = motis_http(*urls.free_bike_url_);
+      f_free_bikes.emplace(*urls.free_bike_url_);
     }
 
     if (urls.system_information_url_.has_value()) {
-      f_system_info = motis_http(*urls.system_information_url_);
+      f_system_info.emplace(*urls.system_information_url_);
     }
 
-    auto const lock = std::scoped_lock{mutex_};
-    auto& info = utl::get_or_create(status_, tag, [&]() {
-      return provider_status{std::make_unique<tiles_database>(
-          (data_dir_ / (tag + "tiles.mdb")).string(), config_.db_size_)};
-    });
-    info.vehicle_type_ = vehicle_type;
+    auto [status, prev] = [&]() {
+      auto const lock = std::scoped_lock{mutex_};
+      auto& st = utl::get_or_create(status_, tag, [&]() {
+        return provider_status{std::make_unique<tiles_database>(
+            (data_dir_ / (tag + "tiles.mdb")).string(), config_.db_size_)};
+      });
+      return std::pair{&st, st.data_};
+    }();
+
+    // Build the new version next to the one in use: routing requests keep
+    // working on the previous snapshot until it is swapped below.
+    auto const empty = provider_data{};
+    auto const& old = prev == nullptr ? empty : *prev;
+    auto next = std::make_shared<provider_data>();
+    next->vehicle_type_ = vehicle_type;
+    next->info_ = urls.system_information_url_.has_value()
+                      ? read_system_information(f_system_info->get())
+                      : old.info_;
     if (urls.station_info_url_.has_value()) {
-      info.stations_ =
-          utl::to_vec(parse_stations(tag, f_station_info->val().body,
-                                     f_station_status->val().body),
+      next->stations_ =
+          utl::to_vec(parse_stations(tag, f_station_info->get(),
+                                     f_station_status->get()),
                       [](auto const& el) { return el.second; });
-      info.stations_rtree_ = geo::make_point_rtree(
-          utl::to_vec(info.stations_, [](auto&& s) { return s.pos_; }));
+      sort_by_id(next->stations_);
+    } else {
+      next->stations_ = old.stations_;
     }
     if (urls.free_bike_url_.has_value()) {
-      info.free_bikes_ = parse_free_bikes(tag, f_free_bikes->val().body);
-      info.free_bikes_rtree_ = geo::make_point_rtree(
-          utl::to_vec(info.free_bikes_, [](auto&& s) { return s.pos_; }));
+      next->free_bikes_ = parse_free_bikes(tag, f_free_bikes->get());
+      sort_by_id(next->free_bikes_);
+    } else {
+      next->free_bikes_ = old.free_bikes_;
     }
-    if (urls.system_information_url_.has_value()) {
-      info.info_ = read_system_information(f_system_info->val().body);
+
+    auto const stations_diff = diff_feed(old.stations_, next->stations_);
+    auto const free_bikes_diff = diff_feed(old.free_bikes_, next->free_bikes_);
+    next->stations_rtree_ = old.stations_rtree_;
+    next->free_bikes_rtree_ = old.free_bikes_rtree_;
+
+    if (prev == nullptr || stations_diff.positions_changed_) {
+      next->stations_rtree_ =
+          std::make_shared<geo::point_rtree const>(geo::make_point_rtree(
+              utl::to_vec(next->stations_, [](auto&& s) { return s.pos_; })));
+    }
+    if (prev == nullptr || free_bikes_diff.positions_changed_) {
+      next->free_bikes_rtree_ =
+          std::make_shared<geo::point_rtree const>(geo::make_point_rtree(
+              utl::to_vec(next->free_bikes_, [](auto&& b) { return b.pos_; })));
+    }
+
+    // The first update after startup always rewrites the tiles database
+    // because it may contain data from a previous run.
+    // The tiles database cannot update single features, so changes that only
+    // affect the number of available vehicles (shown on the map, not used for
+    // the tile layout) are collected and written at most once per
+    // availability_tiles_interval.
+    auto const now = std::chrono::steady_clock::now();
+    auto const availability_outdated =
+        status->tiles_availability_outdated_ || !stations_diff.empty() ||
+        !free_bikes_diff.empty();
+    auto const rewrite_tiles =
+        prev == nullptr || prev->vehicle_type_ != vehicle_type ||
+        stations_diff.attributes_changed_ ||
+        free_bikes_diff.attributes_changed_ ||
+        (availability_outdated &&
+         now - status->tiles_written_ >=
+             std::chrono::seconds{config_.availability_tiles_interval_seconds_});
+    if (rewrite_tiles) {
+      write_tiles(*status->tiles_, tag, *next);
     }
 
-    info.tiles_->clear();
+    {
+      auto const lock = std::scoped_lock{mutex_};
+      status->data_ = std::move(next);
+      ++status->updates_;
+      if (rewrite_tiles) {
+        ++status->tile_rewrites_;
+        status->tiles_written_ = now;
+      }
+      status->tiles_availability_outdated_ =
+          !rewrite_tiles && availability_outdated;
+    }
+
+    l(logging::debug,
+      "GBFS {}: stations +{} -{} ~{}, free vehicles +{} -{} ~{}, tiles {}",
+      tag, stations_diff.added_, stations_diff.removed_,
+      stations_diff.changed_, free_bikes_diff.added_, free_bikes_diff.removed_,
+      free_bikes_diff.changed_,
+      rewrite_tiles ? "rewritten"
+                    : (availability_outdated ? "deferred" : "unchanged"));
+  }
+
+  static void write_tiles(tiles_database& db, std::string const& tag,
+                          provider_data const& data) {
+    auto const lock = std::unique_lock{db.mutex_};
+    db.clear();
 
     tiles::layer_names_builder layer_names;
     auto const free_bike_layer_id = layer_names.get_layer_idx("vehicle");
@@ -150,16 +250,15 @@ struct gbfs::impl {
 
     static constexpr auto const kMinZoomLevel = 10;
     auto feature_inserter = tiles::feature_inserter_mt{
-        tiles::dbi_handle{info.tiles_->db_handle_,
-                          info.tiles_->db_handle_.features_dbi_opener()},
-        info.tiles_->pack_handle_};
+        tiles::dbi_handle{db.db_handle_, db.db_handle_.features_dbi_opener()},
+        db.pack_handle_};
 
-    for (auto const& [idx, nfo] : utl::enumerate(info.free_bikes_)) {
+    for (auto const& [idx, nfo] : utl::enumerate(data.free_bikes_)) {
       tiles::feature f;
       f.id_ = idx;
       f.layer_ = free_bike_layer_id;
       f.zoom_levels_ = {kMinZoomLevel, tiles::kMaxZoomLevel};
-      f.meta_.emplace_back("type", tiles::encode_string(vehicle_type));
+      f.meta_.emplace_back("type", tiles::encode_string(data.vehicle_type_));
       f.meta_.emplace_back("tag", tiles::encode_string(tag));
       f.meta_.emplace_back("id", tiles::encode_string(nfo.id_));
       f.geometry_ = tiles::fixed_point{
@@ -167,12 +266,12 @@ struct gbfs::impl {
       feature_inserter.insert(f);
     }
 
-    for (auto const& [idx, nfo] : utl::enumerate(info.stations_)) {
+    for (auto const& [idx, nfo] : utl::enumerate(data.stations_)) {
       tiles::feature f;
       f.id_ = idx;
       f.layer_ = station_bike_layer_id;
       f.zoom_levels_ = {kMinZoomLevel, tiles::kMaxZoomLevel};
-      f.meta_.emplace_back("type", tiles::encode_string(vehicle_type));
+      f.meta_.emplace_back("type", tiles::encode_string(data.vehicle_type_));
       f.meta_.emplace_back("tag", tiles::encode_string(tag));
       f.meta_.emplace_back("name", tiles::encode_string(nfo.name_));
       f.meta_.emplace_back("id", tiles::encode_string(nfo.id_));
@@ -184,12 +283,12 @@ struct gbfs::impl {
     }
 
     {
-      auto txn = info.tiles_->db_handle_.make_txn();
-      layer_names.store(info.tiles_->db_handle_, txn);
+      auto txn = db.db_handle_.make_txn();
+      layer_names.store(db.db_handle_, txn);
       txn.commit();
     }
 
-    info.tiles_->render_ctx_ = tiles::make_render_ctx(info.tiles_->db_handle_);
+    db.render_ctx_ = tiles::make_render_ctx(db.db_handle_);
   }
 
   void init() {
@@ -198,17 +297,25 @@ struct gbfs::impl {
       fs::create_directories(data_dir_);
     }
 
+    if (pt_stations_rtree_ == nullptr) {
+      pt_stations_rtree_ = std::make_unique<geo::point_rtree>(
+          geo::make_point_rtree(sched_.stations_, [](auto const& s) {
+            return geo::latlng{s->lat(), s->lng()};
+          }));
+    }
+
     motis_parallel_for(config_.urls_, [&](auto&& url) { fetch_stream(url); });
 
     auto const lock = std::scoped_lock{mutex_};
-    pt_stations_rtree_ =
-        geo::make_point_rtree(sched_.stations_, [](auto const& s) {
-          return geo::latlng{s->lat(), s->lng()};
-        });
     for (auto const& [tag, info] : status_) {
+      if (info.data_ == nullptr) {
+        continue;
+      }
       l(logging::info,
-        "GBFS {} (type={}): loaded {} stations, {} free vehicles", tag,
-        info.vehicle_type_, info.stations_.size(), info.free_bikes_.size());
+        "GBFS {} (type={}): {} stations, {} free vehicles, {}/{} updates "
+        "rewrote tiles",
+        tag, info.data_->vehicle_type_, info.data_->stations_.size(),
+        info.data_->free_bikes_.size(), info.tile_rewrites_, info.updates_);
     }
   }
 
@@ -266,16 +373,12 @@ struct gbfs::impl {
     auto const req = motis_content(GBFSRoutingRequest, m);
 
     auto const provider = req->provider()->str();
-    auto const status_it = status_.find(provider);
-    utl::verify(status_it != end(status_), "provider {} not found", provider);
-
-    auto const lock = std::lock_guard{mutex_};
-    auto const& info = status_it->second;
-    auto const& stations = info.stations_;
-    auto const& stations_rtree = info.stations_rtree_;
-    auto const& free_bikes = info.free_bikes_;
-    auto const& free_bikes_rtree = info.free_bikes_rtree_;
-    auto const& vehicle_type = info.vehicle_type_;
+    auto const data = get_data(provider);
+    auto const& stations = data->stations_;
+    auto const& stations_rtree = *data->stations_rtree_;
+    auto const& free_bikes = data->free_bikes_;
+    auto const& free_bikes_rtree = *data->free_bikes_rtree_;
+    auto const& vehicle_type = data->vehicle_type_;
     utl::verify(vehicle_type == "car" || vehicle_type == "bike",
                 "unsupported vehicle type {}", vehicle_type);
 
@@ -289,7 +392,7 @@ struct gbfs::impl {
 
     auto const x = from_fbs(req->x());
 
-    auto const p = pt_stations_rtree_.in_radius(x, max_total_dist);
+    auto const p = pt_stations_rtree_->in_radius(x, max_total_dist);
     auto p_pos = utl::to_vec(p, [&](auto const idx) {
       auto const& s = *sched_.stations_.at(idx);
       return geo::latlng{s.lat(), s.lng()};
@@ -345,254 +448,204 @@ struct gbfs::impl {
     auto const sp_pos =
         utl::to_vec(sp, [&](auto const idx) { return stations.at(idx).pos_; });
 
-    auto p_best_journeys = std::vector<journey>{};
-    p_best_journeys.resize(p_pos.size());
+    auto const get_costs = [](future const& f) {
+      return utl::to_vec(
+          *motis_content(OSRMOneToManyResponse, f->val())->costs(),
+          [](auto&& c) { return to_cost(c->duration()); });
+    };
+    auto const get_table = [](future const& f, std::size_t const rows,
+                              std::size_t const stride,
+                              std::size_t const offset, std::size_t const cols,
+                              bool const transpose) {
+      auto const costs =
+          motis_content(OSRMManyToManyResponse, f->val())->costs();
+      return to_cost_matrix([&](std::size_t const i) { return costs->Get(i); },
+                            rows, stride, offset, cols, transpose);
+    };
 
-    auto d_best_journeys = std::vector<journey>{};
-    d_best_journeys.resize(req->direct()->size());
+    struct station_leg {
+      std::uint32_t sx_, sp_;
+      cost_t x_walk_, bike_;
+    };
 
-    if (req->dir() == SearchDir_Forward) {
+    auto const fwd = req->dir() == SearchDir_Forward;
+    auto const use_stations = !sx.empty() && !sp.empty();
+    auto const walk_limit = static_cast<cost_t>(max_walk_duration);
+    auto const bike_limit = static_cast<cost_t>(max_bike_duration);
+
+    // free-float: one min-plus row per free vehicle b over [b] x [p]
+    //   FWD: matrix = bike durations, leg = walk x --> b
+    //   BWD: matrix = walk durations, leg = bike b --> x
+    auto free_float_rows = std::vector<min_plus_row>{};
+    auto free_float_legs = std::vector<cost_t>{};
+    auto free_float_matrix = cost_matrix{};
+
+    // station: one min-plus row per (sx, sp) pair over [sp] x [p] walks
+    auto station_rows = std::vector<min_plus_row>{};
+    auto station_legs = std::vector<station_leg>{};
+    auto sp_p_walks = cost_matrix{};
+
+    auto const add_station_legs = [&](std::vector<cost_t> const& x_walks,
+                                      auto&& get_bike) {
+      for (auto sx_idx = 0U; sx_idx != sx.size(); ++sx_idx) {
+        auto const x_walk = x_walks[sx_idx];
+        if (x_walk > walk_limit) {
+          continue;
+        }
+        for (auto sp_idx = 0U; sp_idx != sp.size(); ++sp_idx) {
+          if (!fwd && stations.at(sp[sp_idx]).bikes_available_ == 0) {
+            continue;
+          }
+          auto const bike = get_bike(sx_idx, sp_idx);
+          if (bike > bike_limit) {
+            continue;
+          }
+          station_legs.push_back({sx_idx, sp_idx, x_walk, bike});
+          station_rows.push_back(
+              {static_cast<cost_t>(bike_ready_time + x_walk + bike),
+               static_cast<cost_t>(walk_limit - x_walk), sp_idx});
+        }
+      }
+    };
+
+    if (fwd) {
       // REQUESTS
+      // x --walk--> [b] and x --walk--> [sx]: one foot request
+      auto x_walk_targets = b_pos;
+      if (use_stations) {
+        utl::concat(x_walk_targets, sx_pos);
+      }
+      auto const f_x_walks =
+          x_walk_targets.empty()
+              ? future{}
+              : motis_call(make_one_to_many("foot", x, x_walk_targets,
+                                            SearchDir_Forward));
+
       // free-float FWD: x --walk--> [b] --bike--> [p]
-      auto const f_x_to_b_walks =
-          b.empty() ? future{}
-                    : motis_call(make_one_to_many("foot", x, b_pos,
-                                                  SearchDir_Forward));
       auto const f_b_to_p_rides =
           b.empty()
               ? future{}
               : motis_call(make_table_request(vehicle_type, b_pos, p_pos));
 
-      // REQUESTS
       // station FWD: x --walk--> [sx] --bike--> [sp] --walk--> [p]
-      auto const f_x_to_sx_walks =
-          (sx.empty() || sp.empty())
-              ? future{}
-              : motis_call(
-                    make_one_to_many("foot", x, sx_pos, SearchDir_Forward));
       auto const f_sx_to_sp_rides =
-          (sx.empty() || sp.empty())
-              ? future{}
-              : motis_call(make_table_request(vehicle_type, sx_pos, sp_pos));
+          use_stations
+              ? motis_call(make_table_request(vehicle_type, sx_pos, sp_pos))
+              : future{};
       auto const f_sp_to_p_walks =
-          (sx.empty() || sp.empty())
-              ? future{}
-              : motis_call(make_table_request("foot", sp_pos, p_pos));
+          use_stations ? motis_call(make_table_request("foot", sp_pos, p_pos))
+                       : future{};
 
-      // BUILD JOURNEYS
-      // free-float FWD: x --walk--> [b] --bike--> [p]
+      auto const x_walks =
+          f_x_walks ? get_costs(f_x_walks) : std::vector<cost_t>{};
       if (f_b_to_p_rides) {
-        auto const b_to_p_table =
-            motis_content(OSRMManyToManyResponse, f_b_to_p_rides->val())
-                ->costs();
-        auto const x_to_b_costs =
-            motis_content(OSRMOneToManyResponse, f_x_to_b_walks->val())
-                ->costs();
-
-        for (auto const& [b_vec_idx, x_to_b_res] :
-             utl::enumerate(*x_to_b_costs)) {
-          auto const x_to_b_walk_duration =
-              static_cast<duration>(std::ceil(x_to_b_res->duration() / 60.0));
-          if (x_to_b_walk_duration > max_walk_duration) {
-            continue;
-          }
-
-          for (auto const& [p_vec_idx, _] : utl::enumerate(p_pos)) {
-            auto const b_to_p_duration = static_cast<duration>(std::ceil(
-                b_to_p_table->Get(b_vec_idx * p_pos.size() + p_vec_idx) /
-                60.0));
-            if (b_to_p_duration > max_bike_duration) {
-              continue;
-            }
-
-            auto const total_duration =
-                bike_ready_time + x_to_b_walk_duration + b_to_p_duration;
-            if (auto& best = p_best_journeys[p_vec_idx];
-                best.total_duration_ > total_duration) {
-              best.total_duration_ = total_duration;
-              best.info_ = journey::b{x_to_b_walk_duration, b_to_p_duration,
-                                      static_cast<uint32_t>(b_vec_idx),
-                                      static_cast<uint32_t>(p_vec_idx)};
-            }
+        free_float_matrix = get_table(f_b_to_p_rides, b.size(), p_pos.size(),
+                                      0U, p_pos.size(), false);
+        for (auto b_idx = 0U; b_idx != b.size(); ++b_idx) {
+          auto const x_walk = x_walks[b_idx];
+          free_float_legs.push_back(x_walk);
+          if (x_walk <= walk_limit) {
+            free_float_rows.push_back(
+                {static_cast<cost_t>(bike_ready_time + x_walk), bike_limit,
+                 b_idx});
           }
         }
       }
-
-      // BUILD JOURNEYS
-      // station FWD: x --walk--> [sx] --bike--> [sp] --walk--> [p]
-      if (f_sx_to_sp_rides) {
-        auto const sx_to_sp_table =
-            motis_content(OSRMManyToManyResponse, f_sx_to_sp_rides->val())
-                ->costs();
-        auto const sp_to_p_table =
-            motis_content(OSRMManyToManyResponse, f_sp_to_p_walks->val())
-                ->costs();
-        for (auto const [sx_vec_idx, x_to_sx_res] : utl::enumerate(
-                 *motis_content(OSRMOneToManyResponse, f_x_to_sx_walks->val())
-                      ->costs())) {
-          auto const x_to_sx_walk_duration =
-              static_cast<duration>(std::ceil(x_to_sx_res->duration() / 60.0));
-          if (x_to_sx_walk_duration > max_walk_duration) {
-            continue;
-          }
-
-          for (auto const& [sp_vec_idx, sp_id] : utl::enumerate(sp)) {
-            auto const sx_to_sp_duration = static_cast<duration>(std::ceil(
-                sx_to_sp_table->Get(sx_vec_idx * sp.size() + sp_vec_idx) /
-                60.0));
-            if (sx_to_sp_duration > max_bike_duration) {
-              continue;
-            }
-
-            for (auto const& [p_vec_idx, _] : utl::enumerate(p_pos)) {
-              auto const sp_to_p_walk_duration = static_cast<duration>(
-                  std::ceil(sp_to_p_table->Get(sp_vec_idx * p_pos.size() +
-                                               p_vec_idx) /
-                            60.0));
-              if (sp_to_p_walk_duration > max_walk_duration ||
-                  x_to_sx_walk_duration + sp_to_p_walk_duration >
-                      max_walk_duration) {
-                continue;
-              }
-
-              auto const total_duration =
-                  bike_ready_time + x_to_sx_walk_duration + sx_to_sp_duration +
-                  sp_to_p_walk_duration;
-              if (auto& best = p_best_journeys[p_vec_idx];
-                  best.total_duration_ > total_duration) {
-                best.total_duration_ = total_duration;
-                best.info_ = journey::s{x_to_sx_walk_duration,
-                                        sx_to_sp_duration,
-                                        sp_to_p_walk_duration,
-                                        static_cast<uint32_t>(sx_vec_idx),
-                                        static_cast<uint32_t>(sp_vec_idx),
-                                        static_cast<uint32_t>(p_vec_idx)};
-              }
-            }
-          }
-        }
+      if (use_stations) {
+        auto const sx_to_sp_rides = get_table(
+            f_sx_to_sp_rides, sx.size(), sp.size(), 0U, sp.size(), false);
+        sp_p_walks = get_table(f_sp_to_p_walks, sp.size(), p_pos.size(), 0U,
+                               p_pos.size(), false);
+        add_station_legs(
+            std::vector<cost_t>(begin(x_walks) + b.size(), end(x_walks)),
+            [&](auto const sx_idx, auto const sp_idx) {
+              return sx_to_sp_rides(sx_idx, sp_idx);
+            });
       }
     } else {
       // REQUESTS
+      // [p] --walk--> [b] and [p] --walk--> [sp]: one foot table
+      auto p_walk_targets = b_pos;
+      if (use_stations) {
+        utl::concat(p_walk_targets, sp_pos);
+      }
+      auto const f_p_walks =
+          p_walk_targets.empty()
+              ? future{}
+              : motis_call(make_table_request("foot", p_pos, p_walk_targets));
+
       // free-float BWD: [p] --walk--> [b] --bike--> x
-      auto const f_p_to_b_walks =
-          b_pos.empty() ? future{}
-                        : motis_call(make_table_request("foot", p_pos, b_pos));
       auto const f_b_to_x_rides =
-          b_pos.empty() ? future{}
-                        : motis_call(make_one_to_many(vehicle_type, x, b_pos,
-                                                      SearchDir_Backward));
+          b.empty() ? future{}
+                    : motis_call(make_one_to_many(vehicle_type, x, b_pos,
+                                                  SearchDir_Backward));
 
-      // REQUESTS
       // station BWD: [p] --walk--> [sp] --bike--> [sx] --walk--> x
-      auto const f_p_to_sp_walks =
-          (sp_pos.empty() || sx_pos.empty())
-              ? future{}
-              : motis_call(make_table_request("foot", p_pos, sp_pos));
       auto const f_sp_to_sx_rides =
-          (sp_pos.empty() || sx_pos.empty())
-              ? future{}
-              : motis_call(make_table_request(vehicle_type, sp_pos, sx_pos));
+          use_stations
+              ? motis_call(make_table_request(vehicle_type, sp_pos, sx_pos))
+              : future{};
       auto const f_sx_to_x_walks =
-          (sp_pos.empty() || sx_pos.empty())
-              ? future{}
-              : motis_call(
-                    make_one_to_many("foot", x, sx_pos, SearchDir_Backward));
-
-      // BUILD JOURNEYS
-      // free-float BWD: [p] --walk--> [b] --bike--> x
-      if (f_p_to_b_walks) {
-        auto const p_to_b_table =
-            motis_content(OSRMManyToManyResponse, f_p_to_b_walks->val())
-                ->costs();
-        for (auto const& [b_vec_idx, b_to_x_res] : utl::enumerate(
-                 *motis_content(OSRMOneToManyResponse, f_b_to_x_rides->val())
-                      ->costs())) {
-          auto const b_to_x_bike_duration =
-              static_cast<duration>(std::ceil(b_to_x_res->duration() / 60.0));
-          if (b_to_x_bike_duration > max_bike_duration) {
-            continue;
-          }
-
-          for (auto const& [p_vec_idx, p_id] : utl::enumerate(p)) {
-            auto const p_to_b_walk_duration = static_cast<duration>(std::ceil(
-                p_to_b_table->Get(p_vec_idx * b.size() + b_vec_idx) / 60.0));
-            if (p_to_b_walk_duration > max_walk_duration) {
-              continue;
-            }
-
-            auto const total_duration =
-                p_to_b_walk_duration + b_to_x_bike_duration;
-            if (auto& best = p_best_journeys[p_vec_idx];
-                best.total_duration_ > total_duration) {
-              best.total_duration_ = total_duration;
-              best.info_ =
-                  journey::b{p_to_b_walk_duration, b_to_x_bike_duration,
-                             static_cast<uint32_t>(b_vec_idx),
-                             static_cast<uint32_t>(p_vec_idx)};
-            }
+          use_stations ? motis_call(make_one_to_many("foot", x, sx_pos,
+                                                     SearchDir_Backward))
+                       : future{};
+
+      if (f_b_to_x_rides) {
+        free_float_matrix =
+            get_table(f_p_walks, p_pos.size(), p_walk_targets.size(), 0U,
+                      b.size(), true);
+        auto const b_to_x_rides = get_costs(f_b_to_x_rides);
+        for (auto const& [b_idx, ride] : utl::enumerate(b_to_x_rides)) {
+          free_float_legs.push_back(ride);
+          if (ride <= bike_limit) {
+            free_float_rows.push_back(
+                {ride, walk_limit, static_cast<std::uint32_t>(b_idx)});
           }
         }
       }
+      if (use_stations) {
+        sp_p_walks = get_table(f_p_walks, p_pos.size(), p_walk_targets.size(),
+                               b.size(), sp.size(), true);
+        auto const sp_to_sx_rides = get_table(
+            f_sp_to_sx_rides, sp.size(), sx.size(), 0U, sx.size(), false);
+        add_station_legs(get_costs(f_sx_to_x_walks),
+                         [&](auto const sx_idx, auto const sp_idx) {
+                           return sp_to_sx_rides(sp_idx, sx_idx);
+                         });
+      }
+    }
 
-      // BUILD JOURNEYS
-      // station BWD: [p] --walk--> [sp] --bike--> [sx] --walk--> x
-      if (f_p_to_b_walks && f_sp_to_sx_rides) {
-        auto const p_to_sp_table =
-            motis_content(OSRMManyToManyResponse, f_p_to_sp_walks->val())
-                ->costs();
-        auto const sp_to_sx_table =
-            motis_content(OSRMManyToManyResponse, f_sp_to_sx_rides->val())
-                ->costs();
-        for (auto const [sx_vec_idx, sx_to_x_res] : utl::enumerate(
-                 *motis_content(OSRMOneToManyResponse, f_sx_to_x_walks->val())
-                      ->costs())) {
-          auto const sx_to_x_walk_duration =
-              static_cast<duration>(std::ceil(sx_to_x_res->duration() / 60.0));
-          if (sx_to_x_walk_duration > max_walk_duration) {
-            continue;
-          }
-
-          for (auto const& [sp_vec_idx, sp_id] : utl::enumerate(sp)) {
-            if (stations.at(sp.at(sp_vec_idx)).bikes_available_ == 0) {
-              continue;
-            }
-
-            auto const sp_to_sx_duration = static_cast<duration>(std::ceil(
-                sp_to_sx_table->Get(sp_vec_idx * sx.size() + sx_vec_idx) /
-                60.0));
-
-            if (sp_to_sx_duration > max_bike_duration) {
-              continue;
-            }
-
-            for (auto const& [p_vec_idx, p_id] : utl::enumerate(p)) {
-              auto const p_to_sp_walk_duration =
-                  static_cast<duration>(std::ceil(
-                      p_to_sp_table->Get(p_vec_idx * sp.size() + sp_vec_idx) /
-                      60.0));
-              if (p_to_sp_walk_duration > max_walk_duration ||
-                  p_to_sp_walk_duration + sx_to_x_walk_duration >
-                      max_walk_duration) {
-                continue;
-              }
-
-              auto const total_duration =
-                  bike_ready_time + p_to_sp_walk_duration + sp_to_sx_duration +
-                  sx_to_x_walk_duration;
-              if (auto& best = p_best_journeys[p_vec_idx];
-                  best.total_duration_ > total_duration) {
-                best.total_duration_ = total_duration;
-                best.info_ = journey::s{p_to_sp_walk_duration,
-                                        sp_to_sx_duration,
-                                        sx_to_x_walk_duration,
-                                        static_cast<uint32_t>(sx_vec_idx),
-                                        static_cast<uint32_t>(sp_vec_idx),
-                                        static_cast<uint32_t>(p_vec_idx)};
-              }
-            }
-          }
-        }
+    // BUILD JOURNEYS
+    auto free_float_best = std::vector<cost_t>(p_pos.size(), kUnreachable);
+    auto free_float_arg = std::vector<std::uint32_t>(p_pos.size());
+    min_plus(free_float_rows, free_float_matrix, free_float_best,
+             free_float_arg);
+
+    auto station_best = std::vector<cost_t>(p_pos.size(), kUnreachable);
+    auto station_arg = std::vector<std::uint32_t>(p_pos.size());
+    min_plus(station_rows, sp_p_walks, station_best, station_arg);
+
+    // backward searches only consider public transport stations [p]
+    auto const p_count = fwd ? p_pos.size() : p.size();
+    auto p_best_journeys = std::vector<journey>(p_pos.size());
+    for (auto p_idx = 0U; p_idx != p_count; ++p_idx) {
+      auto& best = p_best_journeys[p_idx];
+      if (free_float_best[p_idx] != kUnreachable) {
+        auto const b_idx = free_float_rows[free_float_arg[p_idx]].row_;
+        auto const leg = free_float_legs[b_idx];
+        auto const matrix_leg = free_float_matrix(b_idx, p_idx);
+        best.total_duration_ = free_float_best[p_idx];
+        best.info_ = fwd ? journey::b{leg, matrix_leg, b_idx, p_idx}
+                         : journey::b{matrix_leg, leg, b_idx, p_idx};
+      }
+      if (station_best[p_idx] < best.total_duration_) {
+        auto const& leg = station_legs[station_arg[p_idx]];
+        auto const p_walk = sp_p_walks(leg.sp_, p_idx);
+        best.total_duration_ = station_best[p_idx];
+        best.info_ = fwd ? journey::s{leg.x_walk_, leg.bike_, p_walk, leg.sx_,
+                                      leg.sp_, p_idx}
+                         : journey::s{p_walk, leg.bike_, leg.x_walk_, leg.sx_,
+                                      leg.sp_, p_idx};
       }
     }
 
@@ -683,26 +736,37 @@ struct gbfs::impl {
     return make_msg(fbb);
   }
 
-  msg_ptr info() const {
+  // Returns the current snapshot of the provider. The snapshot stays valid
+  // (and unchanged) while the provider is updated concurrently.
+  std::shared_ptr<provider_data const> get_data(std::string const& tag) {
+    auto const lock = std::scoped_lock{mutex_};
+    auto const it = status_.find(tag);
+    utl::verify(it != end(status_) && it->second.data_ != nullptr,
+                "provider {} not found", tag);
+    return it->second.data_;
+  }
+
+  msg_ptr info() {
+    auto const lock = std::scoped_lock{mutex_};
     message_creator fbb;
+    std::vector<fbs::Offset<GBFSProvider>> providers;
+    for (auto const& [tag, status] : status_) {
+      if (status.data_ == nullptr) {
+        continue;
+      }
+      auto const& info = *status.data_;
+      providers.emplace_back(CreateGBFSProvider(
+          fbb, fbb.CreateString(tag), fbb.CreateString(info.info_.name_),
+          fbb.CreateString(info.info_.name_short_),
+          fbb.CreateString(info.info_.operator_),
+          fbb.CreateString(info.info_.url_),
+          fbb.CreateString(info.info_.purchase_url_),
+          fbb.CreateString(info.info_.mail_),
+          fbb.CreateString(info.vehicle_type_)));
+    }
     fbb.create_and_finish(
         MsgContent_GBFSProvidersResponse,
-        CreateGBFSProvidersResponse(
-            fbb, fbb.CreateVector(utl::to_vec(
-                     status_,
-                     [&](auto&& s) {
-                       auto const& [tag, info] = s;
-                       return CreateGBFSProvider(
-                           fbb, fbb.CreateString(tag),
-                           fbb.CreateString(info.info_.name_),
-                           fbb.CreateString(info.info_.name_short_),
-                           fbb.CreateString(info.info_.operator_),
-                           fbb.CreateString(info.info_.url_),
-                           fbb.CreateString(info.info_.purchase_url_),
-                           fbb.CreateString(info.info_.mail_),
-                           fbb.CreateString(info.vehicle_type_));
-                     })))
-            .Union());
+        CreateGBFSProvidersResponse(fbb, fbb.CreateVector(providers)).Union());
     return make_msg(fbb);
   }
 
@@ -723,11 +787,17 @@ struct gbfs::impl {
     auto const tile = tiles::parse_tile_url(tile_url);
     utl::verify(tile.has_value(), "invalid tile url {}", tile_url);
 
+    auto const db = [&]() {
+      auto const lock = std::scoped_lock{mutex_};
+      auto const it = status_.find(tag);
+      utl::verify(it != end(status_), "provider {} not found", tag);
+      return it->second.tiles_.get();
+    }();
+
     tiles::null_perf_counter pc;
-    auto& data = status_.at(tag);
-    auto const rendered_tile =
-        tiles::get_tile(data.tiles_->db_handle_, data.tiles_->pack_handle_,
-                        data.tiles_->render_ctx_, *tile, pc);
+    auto const lock = std::shared_lock{db->mutex_};
+    auto const rendered_tile = tiles::get_tile(
+        db->db_handle_, db->pack_handle_, db->render_ctx_, *tile, pc);
 
     message_creator mc;
     std::vector<fbs::Offset<HTTPHeader>> headers;
@@ -778,30 +848,49 @@ struct gbfs::impl {
     tiles::tile_db_handle db_handle_;
     tiles::render_ctx render_ctx_;
     tiles::pack_handle pack_handle_;
+
+    // shared: tile rendering, exclusive: rewrite
+    std::shared_mutex mutex_;
+  };
+
+  // Immutable once published, replaced as a whole on update.
+  struct provider_data {
+    system_information info_;
+    std::string vehicle_type_;
+    std::vector<station> stations_;  // sorted by id
+    std::vector<free_bike> free_bikes_;  // sorted by id
+    std::shared_ptr<geo::point_rtree const> free_bikes_rtree_, stations_rtree_;
   };
 
   struct provider_status {
     explicit provider_status(std::unique_ptr<tiles_database>&& db)
         : tiles_{std::move(db)} {}
-    system_information info_;
-    std::string vehicle_type_;
-    std::vector<station> stations_;
-    std::vector<free_bike> free_bikes_;
-    geo::point_rtree free_bikes_rtree_, stations_rtree_;
+    std::shared_ptr<provider_data const> data_;
     std::unique_ptr<tiles_database> tiles_;
+    std::uint64_t updates_{0U}, tile_rewrites_{0U};
+
+    // availability in the tiles is older than data_
+    bool tiles_availability_outdated_{false};
+    std::chrono::steady_clock::time_point tiles_written_;
   };
 
   config const& config_;
   schedule const& sched_;
   std::mutex mutex_;
   std::map<std::string, provider_status> status_;
-  geo::point_rtree pt_stations_rtree_;
+  std::unique_ptr<geo::point_rtree> pt_stations_rtree_;
   fs::path data_dir_;
 };
 
 gbfs::gbfs() : module("GBFS", "gbfs") {
   param(config_.update_interval_minutes_, "update_interval",
         "update interval in minutes");
+  param(config_.update_interval_seconds_, "update_interval_seconds",
+        "update interval in seconds (overrides update_interval if set)");
+  param(config_.availability_tiles_interval_seconds_,
+        "availability_tiles_interval",
+        "min. seconds between tile rewrites caused only by changed vehicle "
+        "availability (stations added/removed/moved: rewritten immediately)");
   param(config_.urls_, "urls", "URLs to fetch data from");
   param(config_.db_size_, "db_size", "database size");
 }
@@ -849,7 +938,10 @@ void gbfs::init(motis::module::registry& r) {
   r.subscribe("/init", [&]() {
     shared_data_->register_timer(
         "GBFS Update",
-        boost::posix_time::minutes{config_.update_interval_minutes_},
+        boost::posix_time::seconds{config_.update_interval_seconds_ != 0U
+                                       ? config_.update_interval_seconds_
+                                       : config_.update_interval_minutes_ *
+                                             60U},
         [&]() { impl_->init(); },
         ctx::accesses_t{ctx::access_request{
             to_res_id(::motis::module::global_res_id::SCHEDULE),
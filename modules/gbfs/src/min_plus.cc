@@ -0,0 +1,94 @@
+#include "motis/gbfs/min_plus.h"
+
+#include <cassert>
+#include <algorithm>
+
+#ifdef MOTIS_AVX2
+#include <immintrin.h>
+#endif
+
+#include "utl/verify.h"
+
+namespace motis::gbfs {
+
+// Number of columns processed for all rows before moving on to the next
+// columns: keeps the best / arg slices in the L1 cache.
+constexpr auto const kBlockSize = std::size_t{1024U};
+
+inline void relax_base(min_plus_row const& r, std::uint32_t const r_idx,
+                       cost_t const* row, cost_t* best, std::uint32_t* arg,
+                       std::size_t const from, std::size_t const to) {
+  for (auto c = from; c != to; ++c) {
+    auto const total = static_cast<std::uint32_t>(r.base_) + row[c];
+    auto const better = row[c] <= r.limit_ && total < best[c];
+    best[c] = better ? static_cast<cost_t>(total) : best[c];
+    arg[c] = better ? r_idx : arg[c];
+  }
+}
+
+#ifdef MOTIS_AVX2
+
+inline void relax_avx(min_plus_row const& r, std::uint32_t const r_idx,
+                      cost_t const* row, cost_t* best, std::uint32_t* arg,
+                      std::size_t const from, std::size_t const to) {
+  auto const m_base = _mm256_set1_epi16(static_cast<short>(r.base_));
+  auto const m_limit = _mm256_set1_epi16(static_cast<short>(r.limit_));
+  auto const m_idx = _mm256_set1_epi32(static_cast<int>(r_idx));
+
+  auto c = from;
+  for (; c + 16 <= to; c += 16) {
+    auto const cost =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(row + c));
+    auto const current =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(best + c));
+    auto const total = _mm256_adds_epu16(m_base, cost);
+
+    // unsigned comparisons: a <= b <=> min(a, b) == a
+    auto const in_limit =
+        _mm256_cmpeq_epi16(_mm256_min_epu16(cost, m_limit), cost);
+    auto const not_better =
+        _mm256_cmpeq_epi16(_mm256_max_epu16(total, current), total);
+    auto const better = _mm256_andnot_si256(not_better, in_limit);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(best + c),
+                        _mm256_blendv_epi8(current, total, better));
+
+    auto const lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(better));
+    auto const hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(better, 1));
+    auto const arg_lo = reinterpret_cast<__m256i*>(arg + c);
+    auto const arg_hi = reinterpret_cast<__m256i*>(arg + c + 8);
+    _mm256_storeu_si256(
+        arg_lo, _mm256_blendv_epi8(_mm256_loadu_si256(arg_lo), m_idx, lo));
+    _mm256_storeu_si256(
+        arg_hi, _mm256_blendv_epi8(_mm256_loadu_si256(arg_hi), m_idx, hi));
+  }
+
+  relax_base(r, r_idx, row, best, arg, c, to);
+}
+
+#endif
+
+void min_plus(std::vector<min_plus_row> const& rows, cost_matrix const& m,
+              std::vector<cost_t>& best, std::vector<std::uint32_t>& arg) {
+  if (rows.empty()) {
+    return;
+  }
+  utl::verify(best.size() == m.cols_ && arg.size() == m.cols_,
+              "min_plus: {} columns, best={}, arg={}", m.cols_, best.size(),
+              arg.size());
+
+  for (auto from = std::size_t{0U}; from < m.cols_; from += kBlockSize) {
+    auto const to = std::min(from + kBlockSize, m.cols_);
+    for (auto r_idx = std::uint32_t{0U}; r_idx != rows.size(); ++r_idx) {
+      auto const& r = rows[r_idx];
+      assert(r.row_ < m.rows_);
+#ifdef MOTIS_AVX2
+      relax_avx(r, r_idx, m.row(r.row_), best.data(), arg.data(), from, to);
+#else
+      relax_base(r, r_idx, m.row(r.row_), best.data(), arg.data(), from, to);
+#endif
+    }
+  }
+}
+
+}  // namespace motis::gbfs
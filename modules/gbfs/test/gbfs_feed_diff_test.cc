@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include "motis/gbfs/feed_diff.h"
+#include "motis/gbfs/free_bike.h"
+#include "motis/gbfs/station.h"
+
+using namespace motis::gbfs;
+
+TEST(gbfs, diff_free_bikes) {
+  auto prev = std::vector<free_bike>{{.id_ = "b", .pos_ = {48.1, 9.1}},
+                                     {.id_ = "a", .pos_ = {48.0, 9.0}},
+                                     {.id_ = "c", .pos_ = {48.2, 9.2}}};
+  sort_by_id(prev);
+  EXPECT_EQ("a", prev.front().id_);
+
+  auto const same = diff_feed(prev, prev);
+  EXPECT_TRUE(same.empty());
+  EXPECT_FALSE(same.positions_changed_);
+
+  auto moved = prev;
+  moved[1].pos_ = {48.5, 9.5};
+  auto const d_moved = diff_feed(prev, moved);
+  EXPECT_EQ(1U, d_moved.changed_);
+  EXPECT_TRUE(d_moved.positions_changed_);
+
+  auto next = std::vector<free_bike>{{.id_ = "a", .pos_ = {48.0, 9.0}},
+                                     {.id_ = "c", .pos_ = {48.2, 9.2}},
+                                     {.id_ = "d", .pos_ = {48.3, 9.3}}};
+  auto const d = diff_feed(prev, next);
+  EXPECT_EQ(1U, d.added_);
+  EXPECT_EQ(1U, d.removed_);
+  EXPECT_EQ(0U, d.changed_);
+  EXPECT_TRUE(d.positions_changed_);
+}
+
+TEST(gbfs, diff_stations_availability) {
+  auto const prev = std::vector<station>{
+      {.id_ = "s1", .name_ = "S1", .pos_ = {48.0, 9.0}, .bikes_available_ = 3},
+      {.id_ = "s2", .name_ = "S2", .pos_ = {48.1, 9.1}, .bikes_available_ = 0}};
+  auto next = prev;
+  next[1].bikes_available_ = 2;
+
+  auto const d = diff_feed(prev, next);
+  EXPECT_FALSE(d.empty());
+  EXPECT_EQ(1U, d.changed_);
+  EXPECT_FALSE(d.positions_changed_);
+}
+
+TEST(gbfs, diff_stations_attributes) {
+  auto const prev = std::vector<station>{
+      {.id_ = "s1", .name_ = "S1", .pos_ = {48.0, 9.0}, .bikes_available_ = 3}};
+
+  auto availability = prev;
+  availability[0].bikes_available_ = 1;
+  availability[0].vehicles_available_["bike"] = 1;
+  EXPECT_FALSE(diff_feed(prev, availability).attributes_changed_);
+
+  auto renamed = prev;
+  renamed[0].name_ = "S1 (new)";
+  auto const d = diff_feed(prev, renamed);
+  EXPECT_TRUE(d.attributes_changed_);
+  EXPECT_FALSE(d.positions_changed_);
+
+  auto const added = std::vector<station>{
+      prev[0], {.id_ = "s2", .name_ = "S2", .pos_ = {48.1, 9.1}}};
+  EXPECT_TRUE(diff_feed(prev, added).attributes_changed_);
+}
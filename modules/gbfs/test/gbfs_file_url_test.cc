@@ -0,0 +1,50 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "motis/gbfs/file_url.h"
+#include "motis/gbfs/system_status.h"
+
+using namespace motis::gbfs;
+
+TEST(gbfs, file_url) {
+  auto const path =
+      std::filesystem::temp_directory_path() / "motis_gbfs_file_url.json";
+  {
+    std::ofstream out{path};
+    out << R"({
+  "data": {
+    "en": {
+      "feeds": [
+        {
+          "name": "station_information",
+          "url": "file:///feeds/station_information.json"
+        },
+        {
+          "name": "station_status",
+          "url": "file:///feeds/station_status.json"
+        }
+      ]
+    }
+  }
+})";
+  }
+
+  auto const url = "file://" + path.string();
+  EXPECT_TRUE(is_file_url(url));
+  EXPECT_FALSE(is_file_url("https://example.com/gbfs.json"));
+  EXPECT_FALSE(read_file_url("https://example.com/gbfs.json").has_value());
+
+  auto const content = read_file_url(url);
+  ASSERT_TRUE(content.has_value());
+  auto const status = read_system_status(*content);
+  ASSERT_EQ(1U, status.size());
+  EXPECT_EQ("file:///feeds/station_information.json",
+            status.front().station_info_url_);
+  EXPECT_EQ("file:///feeds/station_status.json",
+            status.front().station_status_url_);
+
+  std::filesystem::remove(path);
+  EXPECT_ANY_THROW(read_file_url(url));
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <random>
+
+#include "motis/core/common/timing.h"
+
+#include "motis/gbfs/min_plus.h"
+
+using namespace motis::gbfs;
+
+namespace {
+
+void min_plus_reference(std::vector<min_plus_row> const& rows,
+                        cost_matrix const& m, std::vector<cost_t>& best,
+                        std::vector<std::uint32_t>& arg) {
+  for (auto r_idx = 0U; r_idx != rows.size(); ++r_idx) {
+    auto const& r = rows[r_idx];
+    for (auto c = 0U; c != m.cols_; ++c) {
+      auto const cost = m(r.row_, c);
+      if (cost <= r.limit_ && r.base_ + cost < best[c]) {
+        best[c] = static_cast<cost_t>(r.base_ + cost);
+        arg[c] = r_idx;
+      }
+    }
+  }
+}
+
+struct instance {
+  instance(std::mt19937& gen, std::size_t const row_count,
+           std::size_t const m_rows, std::size_t const m_cols)
+      : m_{m_rows, m_cols} {
+    auto cost = std::uniform_int_distribution<cost_t>{0U, 120U};
+    for (auto& c : m_.data_) {
+      c = cost(gen) == 0U ? kUnreachable : cost(gen);
+    }
+    auto row = std::uniform_int_distribution<std::uint32_t>{
+        0U, static_cast<std::uint32_t>(m_rows - 1)};
+    for (auto i = 0U; i != row_count; ++i) {
+      rows_.push_back({cost(gen), cost(gen), row(gen)});
+    }
+  }
+
+  std::vector<min_plus_row> rows_;
+  cost_matrix m_;
+};
+
+}  // namespace
+
+TEST(gbfs, min_plus) {
+  auto gen = std::mt19937{42U};
+  for (auto const cols : {1U, 15U, 16U, 17U, 1023U, 1025U, 3000U}) {
+    auto const in = instance{gen, 50U, 20U, cols};
+
+    auto best = std::vector<cost_t>(cols, kUnreachable);
+    auto arg = std::vector<std::uint32_t>(cols);
+    min_plus(in.rows_, in.m_, best, arg);
+
+    auto ref_best = std::vector<cost_t>(cols, kUnreachable);
+    auto ref_arg = std::vector<std::uint32_t>(cols);
+    min_plus_reference(in.rows_, in.m_, ref_best, ref_arg);
+
+    EXPECT_EQ(ref_best, best);
+    EXPECT_EQ(ref_arg, arg);
+  }
+}
+
+TEST(gbfs, to_cost_matrix) {
+  // 2 x 3 table in seconds, columns [1, 3)
+  auto const table = std::vector<double>{0, 61, 120, 1, 59, 1e9};
+  auto const seconds = [&](std::size_t const i) { return table[i]; };
+
+  auto const m = to_cost_matrix(seconds, 2U, 3U, 1U, 2U, false);
+  EXPECT_EQ((std::vector<cost_t>{2U, 2U, 1U, kUnreachable}), m.data_);
+
+  auto const t = to_cost_matrix(seconds, 2U, 3U, 1U, 2U, true);
+  EXPECT_EQ(2U, t.rows_);
+  EXPECT_EQ((std::vector<cost_t>{2U, 1U, 2U, kUnreachable}), t.data_);
+}
+
+// Dense urban system: 5000 free vehicles / 2500 (sx, sp) pairs to 500
+// stations. Compares the kernel to the plain nested loops.
+TEST(gbfs, DISABLED_min_plus_benchmark) {
+  auto gen = std::mt19937{42U};
+  auto const in = instance{gen, 5000U, 5000U, 500U};
+
+  auto best = std::vector<cost_t>(in.m_.cols_, kUnreachable);
+  auto arg = std::vector<std::uint32_t>(in.m_.cols_);
+  MOTIS_START_TIMING(kernel);
+  for (auto i = 0U; i != 10U; ++i) {
+    std::fill(begin(best), end(best), kUnreachable);
+    min_plus(in.rows_, in.m_, best, arg);
+  }
+  MOTIS_STOP_TIMING(kernel);
+
+  auto ref_best = std::vector<cost_t>(in.m_.cols_, kUnreachable);
+  auto ref_arg = std::vector<std::uint32_t>(in.m_.cols_);
+  MOTIS_START_TIMING(reference);
+  for (auto i = 0U; i != 10U; ++i) {
+    std::fill(begin(ref_best), end(ref_best), kUnreachable);
+    min_plus_reference(in.rows_, in.m_, ref_best, ref_arg);
+  }
+  MOTIS_STOP_TIMING(reference);
+
+  EXPECT_EQ(ref_best, best);
+  std::cout << "min_plus: " << MOTIS_TIMING_US(kernel) / 10 << "us/query, "
+            << "reference: " << MOTIS_TIMING_US(reference) / 10
+            << "us/query\n";
+}
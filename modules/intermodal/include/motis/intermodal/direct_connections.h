@@ -11,6 +11,7 @@
 #include "motis/intermodal/mumo_edge.h"
 #include "motis/intermodal/ppr_profiles.h"
 #include "motis/intermodal/query_bounds.h"
+#include "motis/intermodal/street_routing.h"
 
 namespace motis::intermodal {
 
@@ -29,10 +30,20 @@ struct direct_connection {
   int mumo_id_{0};
 };
 
+// Registers the OSRM (bike, car) direct connection requests in the street
+// routing batch. Results are appended to direct once the batch is executed.
+void add_direct_street_routing(query_start const& q_start,
+                               query_dest const& q_dest,
+                               IntermodalRoutingRequest const* req,
+                               street_routing_batch& street_routing,
+                               std::vector<direct_connection>& direct);
+
+// direct: connections already computed by the street routing batch
 std::vector<direct_connection> get_direct_connections(
     query_start const& q_start, query_dest const& q_dest,
     IntermodalRoutingRequest const* req, ppr_profiles const& profiles,
-    std::vector<mumo_edge const*> const& edge_mapping);
+    std::vector<mumo_edge const*> const& edge_mapping,
+    std::vector<direct_connection> direct);
 
 std::size_t remove_dominated_journeys(
     std::vector<journey>& journeys,
@@ -10,6 +10,7 @@
 #include "motis/core/schedule/time.h"
 #include "motis/core/statistics/statistics.h"
 #include "motis/intermodal/ppr_profiles.h"
+#include "motis/intermodal/street_routing.h"
 #include "motis/protocol/Message_generated.h"
 
 namespace motis::intermodal {
@@ -85,12 +86,16 @@ using appender_fun = std::function<mumo_edge&(
 
 using mumo_stats_appender_fun = std::function<void(stats_category&&)>;
 
+// OSRM based edges are only registered in the street routing batch and
+// appended once the batch has been executed.
 void make_starts(IntermodalRoutingRequest const*, geo::latlng const& pos,
                  geo::latlng const& direct_target, appender_fun const&,
-                 mumo_stats_appender_fun const&, ppr_profiles const&);
+                 mumo_stats_appender_fun const&, ppr_profiles const&,
+                 street_routing_batch&);
 void make_dests(IntermodalRoutingRequest const*, geo::latlng const& pos,
                 geo::latlng const& direct_target, appender_fun const&,
-                mumo_stats_appender_fun const&, ppr_profiles const&);
+                mumo_stats_appender_fun const&, ppr_profiles const&,
+                street_routing_batch&);
 
 void remove_intersection(std::vector<mumo_edge>& starts,
                          std::vector<mumo_edge>& destinations,
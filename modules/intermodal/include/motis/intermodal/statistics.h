@@ -10,6 +10,9 @@ struct statistics {
   uint64_t linear_distance_{};
   uint64_t dominated_by_direct_connection_{};
   uint64_t mumo_edge_duration_{};
+  uint64_t street_routing_duration_{};
+  uint64_t street_routing_requests_{};
+  uint64_t street_routing_tables_{};
   uint64_t routing_duration_{};
   uint64_t direct_connection_duration_{};
   uint64_t revise_duration_{};
@@ -23,6 +26,9 @@ inline stats_category to_stats_category(char const* name, statistics const& s) {
        {"linear_distance", s.linear_distance_},
        {"dominated_by_direct_connection", s.dominated_by_direct_connection_},
        {"mumo_edge_duration", s.mumo_edge_duration_},
+       {"street_routing_duration", s.street_routing_duration_},
+       {"street_routing_requests", s.street_routing_requests_},
+       {"street_routing_tables", s.street_routing_tables_},
        {"routing_duration", s.routing_duration_},
        {"direct_connection_duration", s.direct_connection_duration_},
        {"revise_duration", s.revise_duration_}}};
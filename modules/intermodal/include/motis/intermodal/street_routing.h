@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "geo/latlng.h"
+
+#include "motis/protocol/Message_generated.h"
+
+namespace motis::intermodal {
+
+// Collects all OSRM one-to-many requests of an intermodal query (start and
+// destination edges of all modes as well as direct connections). Requests
+// with the same profile, direction and origin are merged into one 1xN (or
+// Nx1) /osrm/table request.
+struct street_routing_batch {
+  // called once per reachable "many" position:
+  // index into the "many" vector passed to add(), duration in seconds
+  using callback_fun = std::function<void(std::size_t, double)>;
+
+  // thread safe
+  void add(std::string const& profile, geo::latlng const& one,
+           std::vector<geo::latlng> const& many, SearchDir dir,
+           callback_fun cb);
+
+  // Runs all table requests in parallel, then calls the callbacks
+  // (sequentially, in insertion order).
+  void execute();
+
+  std::size_t table_requests() const { return groups_.size(); }
+  std::size_t requests() const { return requests_.size(); }
+
+private:
+  struct group {
+    std::string profile_;
+    geo::latlng one_;
+    SearchDir dir_{SearchDir_Forward};
+    std::vector<geo::latlng> many_;
+    std::map<std::pair<double, double>, unsigned> many_idx_;
+    std::vector<double> durations_;  // one entry per many_
+  };
+
+  struct request {
+    std::size_t group_{0U};
+    std::vector<unsigned> idx_;  // many index in request -> many_ in group
+    callback_fun cb_;
+  };
+
+  std::mutex mutex_;
+  std::map<std::tuple<std::string, SearchDir, double, double>, std::size_t>
+      group_idx_;
+  std::vector<group> groups_;
+  std::vector<request> requests_;
+};
+
+}  // namespace motis::intermodal
@@ -7,7 +7,6 @@
 #include "cista/reflection/comparable.h"
 #include "utl/enumerate.h"
 #include "utl/erase_if.h"
-#include "utl/verify.h"
 
 #include "motis/core/common/unixtime.h"
 #include "motis/module/context/motis_spawn.h"
@@ -159,28 +158,35 @@ osrm_settings get_direct_osrm_car_settings(
   return start_settings + dest_settings;
 }
 
-msg_ptr make_direct_osrm_request(geo::latlng const& start,
-                                 geo::latlng const& dest,
-                                 std::string const& profile, SearchDir dir) {
-  Position const start_pos{start.lat_, start.lng_};
-  Position const dest_pos{dest.lat_, dest.lng_};
-  message_creator mc;
+void add_direct_street_routing(query_start const& q_start,
+                               query_dest const& q_dest,
+                               IntermodalRoutingRequest const* req,
+                               street_routing_batch& street_routing,
+                               std::vector<direct_connection>& direct) {
+  auto const beeline = distance(q_start.pos_, q_dest.pos_);
+  auto const add = [&](mumo_type const type, osrm_settings const& settings) {
+    if (settings.max_duration_ <= 0 || beeline > settings.max_distance_) {
+      return;
+    }
+    street_routing.add(
+        to_string(type), q_start.pos_, {q_dest.pos_}, req->search_dir(),
+        [&direct, type, settings](std::size_t, double const cost) {
+          auto const duration = static_cast<unsigned>(cost);
+          if (duration <= settings.max_duration_) {
+            direct.emplace_back(type, duration / 60, 0);
+          }
+        });
+  };
 
-  mc.create_and_finish(
-      MsgContent_OSRMOneToManyRequest,
-      CreateOSRMOneToManyRequest(
-          mc, mc.CreateString(profile), dir, &start_pos,
-          mc.CreateVectorOfStructs(std::vector<Position>{dest_pos}))
-          .Union(),
-      "/osrm/one_to_many");
-  return make_msg(mc);
+  add(mumo_type::BIKE, get_direct_osrm_settings<Mode_Bike>(req));
+  add(mumo_type::CAR, get_direct_osrm_car_settings(req));
 }
 
 std::vector<direct_connection> get_direct_connections(
     query_start const& q_start, query_dest const& q_dest,
     IntermodalRoutingRequest const* req, ppr_profiles const& profiles,
-    std::vector<mumo_edge const*> const& edge_mapping) {
-  auto direct = std::vector<direct_connection>{};
+    std::vector<mumo_edge const*> const& edge_mapping,
+    std::vector<direct_connection> direct) {
   auto const beeline = distance(q_start.pos_, q_dest.pos_);
 
   auto direct_mutex = std::mutex{};
@@ -206,48 +212,6 @@ std::vector<direct_connection> get_direct_connections(
     }));
   }
 
-  auto const osrm_bike_settings = get_direct_osrm_settings<Mode_Bike>(req);
-  if (osrm_bike_settings.max_duration_ > 0 &&
-      beeline <= osrm_bike_settings.max_distance_) {
-    futures.emplace_back(spawn_job_void([&]() {
-      auto const osrm_msg =
-          motis_call(make_direct_osrm_request(q_start.pos_, q_dest.pos_,
-                                              to_string(mumo_type::BIKE),
-                                              req->search_dir()))
-              ->val();
-      auto const osrm_resp = motis_content(OSRMOneToManyResponse, osrm_msg);
-      utl::verify(osrm_resp->costs()->size() == 1,
-                  "direct connetions: invalid osrm response");
-      auto const duration =
-          static_cast<unsigned>(osrm_resp->costs()->Get(0)->duration());
-      if (duration <= osrm_bike_settings.max_duration_) {
-        std::lock_guard guard{direct_mutex};
-        direct.emplace_back(mumo_type::BIKE, duration / 60, 0);
-      }
-    }));
-  }
-
-  auto const osrm_car_settings = get_direct_osrm_car_settings(req);
-  if (osrm_car_settings.max_duration_ > 0 &&
-      beeline <= osrm_car_settings.max_distance_) {
-    futures.emplace_back(spawn_job_void([&]() {
-      auto const osrm_msg =
-          motis_call(make_direct_osrm_request(q_start.pos_, q_dest.pos_,
-                                              to_string(mumo_type::CAR),
-                                              req->search_dir()))
-              ->val();
-      auto const osrm_resp = motis_content(OSRMOneToManyResponse, osrm_msg);
-      utl::verify(osrm_resp->costs()->size() == 1,
-                  "direct connetions: invalid osrm response");
-      auto const duration =
-          static_cast<unsigned>(osrm_resp->costs()->Get(0)->duration());
-      if (duration <= osrm_car_settings.max_duration_) {
-        std::lock_guard guard{direct_mutex};
-        direct.emplace_back(mumo_type::CAR, duration / 60, 0);
-      }
-    }));
-  }
-
   ctx::await_all(futures);
 
   for (auto const& [i, e] : utl::enumerate(edge_mapping)) {
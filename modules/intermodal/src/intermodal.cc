@@ -23,6 +23,7 @@
 #include "motis/intermodal/mumo_edge.h"
 #include "motis/intermodal/query_bounds.h"
 #include "motis/intermodal/statistics.h"
+#include "motis/intermodal/street_routing.h"
 
 #include "motis/protocol/Message_generated.h"
 
@@ -288,7 +289,8 @@ msg_ptr postprocess_response(msg_ptr const& response_msg,
                              std::vector<mumo_edge const*> const& edge_mapping,
                              statistics& stats, bool const revise,
                              std::vector<stats_category> const& mumo_stats,
-                             ppr_profiles const& profiles) {
+                             ppr_profiles const& profiles,
+                             std::vector<direct_connection> street_direct) {
   auto const dir = req->search_dir();
   auto routing_response =
       response_msg ? motis_content(RoutingResponse, response_msg) : nullptr;
@@ -297,8 +299,8 @@ msg_ptr postprocess_response(msg_ptr const& response_msg,
                       : message_to_journeys(routing_response);
 
   MOTIS_START_TIMING(direct_connection_timing);
-  auto const direct =
-      get_direct_connections(q_start, q_dest, req, profiles, edge_mapping);
+  auto const direct = get_direct_connections(
+      q_start, q_dest, req, profiles, edge_mapping, std::move(street_direct));
   stats.dominated_by_direct_connection_ =
       remove_dominated_journeys(journeys, direct);
   add_direct_connections(journeys, direct, q_start, q_dest, req);
@@ -469,6 +471,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
   };
 
   std::vector<ctx::future_ptr<ctx_data, void>> futures;
+  street_routing_batch street_routing;
+  std::vector<direct_connection> street_direct;
 
   using namespace std::placeholders;
   if (req->search_dir() == SearchDir_Forward) {
@@ -478,7 +482,7 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
             req, start.pos_, dest.pos_,
             std::bind(appender, std::ref(deps),  // NOLINT
                       STATION_START, _1, start.pos_, _2, _3, _4, _5, _6),
-            mumo_stats_appender, ppr_profiles_);
+            mumo_stats_appender, ppr_profiles_, street_routing);
       }));
     }
     if (dest.is_intermodal_) {
@@ -486,7 +490,7 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
         make_dests(req, dest.pos_, start.pos_,
                    std::bind(appender, std::ref(arrs),  // NOLINT
                              _1, STATION_END, _2, dest.pos_, _3, _4, _5, _6),
-                   mumo_stats_appender, ppr_profiles_);
+                   mumo_stats_appender, ppr_profiles_, street_routing);
       }));
     }
   } else {
@@ -496,7 +500,7 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
             req, start.pos_, dest.pos_,
             std::bind(appender, std::ref(deps),  // NOLINT
                       _1, STATION_START, _2, start.pos_, _3, _4, _5, _6),
-            mumo_stats_appender, ppr_profiles_);
+            mumo_stats_appender, ppr_profiles_, street_routing);
       }));
     }
     if (dest.is_intermodal_) {
@@ -504,18 +508,27 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
         make_dests(req, dest.pos_, start.pos_,
                    std::bind(appender, std::ref(arrs),  // NOLINT
                              STATION_END, _1, dest.pos_, _2, _3, _4, _5, _6),
-                   mumo_stats_appender, ppr_profiles_);
+                   mumo_stats_appender, ppr_profiles_, street_routing);
       }));
     }
   }
 
   ctx::await_all(futures);
+  add_direct_street_routing(start, dest, req, street_routing, street_direct);
+
+  MOTIS_START_TIMING(street_routing_timing);
+  street_routing.execute();
+  MOTIS_STOP_TIMING(street_routing_timing);
   MOTIS_STOP_TIMING(mumo_edge_timing);
 
   stats.start_edges_ = deps.size();
   stats.destination_edges_ = arrs.size();
   stats.mumo_edge_duration_ =
       static_cast<uint64_t>(MOTIS_TIMING_MS(mumo_edge_timing));
+  stats.street_routing_duration_ =
+      static_cast<uint64_t>(MOTIS_TIMING_MS(street_routing_timing));
+  stats.street_routing_requests_ = street_routing.requests();
+  stats.street_routing_tables_ = street_routing.table_requests();
 
   std::vector<mumo_edge const*> edge_mapping;
   auto edges = write_edges(mc, deps, arrs, edge_mapping);
@@ -547,7 +560,8 @@ msg_ptr intermodal::route(msg_ptr const& msg) {
   }
 
   return postprocess_response(routing_resp, start, dest, req, edge_mapping,
-                              stats, revise_, mumo_stats, ppr_profiles_);
+                              stats, revise_, mumo_stats, ppr_profiles_,
+                              std::move(street_direct));
 }
 
 }  // namespace motis::intermodal
@@ -1,8 +1,12 @@
 #include "motis/intermodal/mumo_edge.h"
 
 #include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "utl/erase_if.h"
+#include "utl/to_vec.h"
 
 #include "motis/core/common/constants.h"
 #include "motis/core/conv/position_conv.h"
@@ -59,46 +63,38 @@ msg_ptr make_geo_request(latlng const& pos, double radius) {
   return make_msg(mc);
 }
 
-msg_ptr make_osrm_request(latlng const& pos,
-                          Vector<Offset<Station>> const* stations,
-                          std::string const& profile, SearchDir direction) {
-  Position fbs_position{pos.lat_, pos.lng_};
-  std::vector<Position> many;
-  for (auto const* station : *stations) {
-    many.push_back(*station->pos());
-  }
-
-  message_creator mc;
-  mc.create_and_finish(
-      MsgContent_OSRMOneToManyRequest,
-      CreateOSRMOneToManyRequest(mc, mc.CreateString(profile), direction,
-                                 &fbs_position, mc.CreateVectorOfStructs(many))
-          .Union(),
-      "/osrm/one_to_many");
-  return make_msg(mc);
-}
-
 void osrm_edges(latlng const& pos, int max_dur, int max_dist,
                 mumo_type const type, SearchDir direction,
-                appender_fun const& appender) {
-  auto const geo_msg = motis_call(make_geo_request(pos, max_dist))->val();
-  auto const geo_resp = motis_content(LookupGeoStationResponse, geo_msg);
-  auto const stations = geo_resp->stations();
-
-  auto const osrm_msg =
-      motis_call(make_osrm_request(pos, stations, to_string(type), direction))
-          ->val();
-  auto const osrm_resp = motis_content(OSRMOneToManyResponse, osrm_msg);
+                appender_fun const& appender,
+                Vector<Offset<Station>> const* stations,
+                street_routing_batch& street_routing) {
+  if (max_dur == 0 || stations == nullptr) {
+    return;
+  }
 
-  for (auto i = 0UL; i < stations->size(); ++i) {
-    auto const dur = osrm_resp->costs()->Get(i)->duration();
-    if (dur > max_dur) {
-      continue;
+  // copied: the callbacks run in street_routing.execute(), after the geo
+  // lookup response holding the stations has been released
+  std::vector<std::pair<std::string, latlng>> reachable;
+  for (auto const* station : *stations) {
+    auto const station_pos = from_fbs(station->pos());
+    if (distance(pos, station_pos) <= max_dist) {
+      reachable.emplace_back(station->id()->str(), station_pos);
     }
-
-    appender(stations->Get(i)->id()->str(), from_fbs(stations->Get(i)->pos()),
-             dur / 60, 0, type, 0);
   }
+
+  street_routing.add(
+      to_string(type), pos,
+      utl::to_vec(reachable, [](auto const& s) { return s.second; }),
+      direction,
+      [reachable, max_dur, type, appender](std::size_t const i,
+                                           double const dur) {
+        if (dur > max_dur) {
+          return;
+        }
+
+        appender(reachable[i].first, reachable[i].second, dur / 60, 0, type,
+                 0);
+      });
 }
 
 msg_ptr make_ppr_request(latlng const& pos,
@@ -259,7 +255,43 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
                 appender_fun const& appender,
                 mumo_stats_appender_fun const& mumo_stats_appender,
                 std::string const& mumo_stats_prefix,
-                ppr_profiles const& profiles) {
+                ppr_profiles const& profiles,
+                street_routing_batch& street_routing) {
+  // One geo lookup (with the largest radius) for all OSRM based modes.
+  auto max_osrm_dist = 0.0;
+  for (auto const& wrapper : *modes) {
+    switch (wrapper->mode_type()) {
+      case Mode_Foot:
+        max_osrm_dist = std::max(
+            max_osrm_dist,
+            reinterpret_cast<Foot const*>(wrapper->mode())->max_duration() *
+                WALK_SPEED);
+        break;
+      case Mode_Bike:
+        max_osrm_dist = std::max(
+            max_osrm_dist,
+            reinterpret_cast<Bike const*>(wrapper->mode())->max_duration() *
+                BIKE_SPEED);
+        break;
+      case Mode_Car:
+        max_osrm_dist = std::max(
+            max_osrm_dist,
+            reinterpret_cast<Car const*>(wrapper->mode())->max_duration() *
+                CAR_SPEED);
+        break;
+      default: break;
+    }
+  }
+
+  auto const geo_msg =
+      max_osrm_dist > 0.0
+          ? motis_call(make_geo_request(pos, max_osrm_dist))->val()
+          : msg_ptr{};
+  auto const osrm_stations =
+      geo_msg == nullptr
+          ? nullptr
+          : motis_content(LookupGeoStationResponse, geo_msg)->stations();
+
   for (auto const& wrapper : *modes) {
     switch (wrapper->mode_type()) {
       case Mode_Foot: {
@@ -267,7 +299,7 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
             reinterpret_cast<Foot const*>(wrapper->mode())->max_duration();
         auto const max_dist = max_dur * WALK_SPEED;
         osrm_edges(pos, max_dur, max_dist, mumo_type::FOOT, search_dir,
-                   appender);
+                   appender, osrm_stations, street_routing);
         break;
       }
 
@@ -276,7 +308,7 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
             reinterpret_cast<Bike const*>(wrapper->mode())->max_duration();
         auto const max_dist = max_dur * BIKE_SPEED;
         osrm_edges(pos, max_dur, max_dist, mumo_type::BIKE, search_dir,
-                   appender);
+                   appender, osrm_stations, street_routing);
         break;
       }
 
@@ -285,7 +317,7 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
             reinterpret_cast<Car const*>(wrapper->mode())->max_duration();
         auto const max_dist = max_dur * CAR_SPEED;
         osrm_edges(pos, max_dur, max_dist, mumo_type::CAR, search_dir,
-                   appender);
+                   appender, osrm_stations, street_routing);
         break;
       }
 
@@ -320,17 +352,21 @@ void make_edges(Vector<Offset<ModeWrapper>> const* modes, latlng const& pos,
 void make_starts(IntermodalRoutingRequest const* req, latlng const& pos,
                  latlng const& direct_target, appender_fun const& appender,
                  mumo_stats_appender_fun const& mumo_stats_appender,
-                 ppr_profiles const& profiles) {
+                 ppr_profiles const& profiles,
+                 street_routing_batch& street_routing) {
   make_edges(req->start_modes(), pos, direct_target, SearchDir_Forward,
-             appender, mumo_stats_appender, "intermodal.start.", profiles);
+             appender, mumo_stats_appender, "intermodal.start.", profiles,
+             street_routing);
 }
 
 void make_dests(IntermodalRoutingRequest const* req, latlng const& pos,
                 latlng const& direct_target, appender_fun const& appender,
                 mumo_stats_appender_fun const& mumo_stats_appender,
-                ppr_profiles const& profiles) {
+                ppr_profiles const& profiles,
+                street_routing_batch& street_routing) {
   make_edges(req->destination_modes(), pos, direct_target, SearchDir_Backward,
-             appender, mumo_stats_appender, "intermodal.dest.", profiles);
+             appender, mumo_stats_appender, "intermodal.dest.", profiles,
+             street_routing);
 }
 
 void remove_intersection(std::vector<mumo_edge>& starts,
@@ -0,0 +1,94 @@
+#include "motis/intermodal/street_routing.h"
+
+#include <limits>
+
+#include "utl/get_or_create.h"
+#include "utl/to_vec.h"
+#include "utl/verify.h"
+
+#include "motis/core/conv/position_conv.h"
+#include "motis/module/context/motis_call.h"
+#include "motis/module/context/motis_spawn.h"
+#include "motis/module/message.h"
+
+using namespace motis::module;
+using namespace motis::osrm;
+
+namespace motis::intermodal {
+
+// OSRMManyToManyResponse entry for pairs without a route
+constexpr auto const kUnreachable = std::numeric_limits<double>::max();
+
+void street_routing_batch::add(std::string const& profile,
+                               geo::latlng const& one,
+                               std::vector<geo::latlng> const& many,
+                               SearchDir const dir, callback_fun cb) {
+  std::lock_guard guard{mutex_};
+  auto const group_idx = utl::get_or_create(
+      group_idx_, std::tuple{profile, dir, one.lat_, one.lng_}, [&]() {
+        groups_.emplace_back(group{profile, one, dir, {}, {}, {}});
+        return groups_.size() - 1;
+      });
+  auto& g = groups_[group_idx];
+  auto& r = requests_.emplace_back(request{group_idx, {}, std::move(cb)});
+  r.idx_ = utl::to_vec(many, [&](geo::latlng const& pos) {
+    return utl::get_or_create(g.many_idx_, std::pair{pos.lat_, pos.lng_},
+                              [&]() {
+                                g.many_.emplace_back(pos);
+                                return static_cast<unsigned>(g.many_.size() -
+                                                             1);
+                              });
+  });
+}
+
+msg_ptr make_table_request(std::string const& profile,
+                           std::vector<geo::latlng> const& sources,
+                           std::vector<geo::latlng> const& targets) {
+  auto const to_positions = [](std::vector<geo::latlng> const& v) {
+    return utl::to_vec(v, [](geo::latlng const& pos) { return to_fbs(pos); });
+  };
+  message_creator mc;
+  mc.create_and_finish(
+      MsgContent_OSRMManyToManyRequest,
+      CreateOSRMManyToManyRequest(
+          mc, mc.CreateString(profile),
+          mc.CreateVectorOfStructs(to_positions(sources)),
+          mc.CreateVectorOfStructs(to_positions(targets)))
+          .Union(),
+      "/osrm/table");
+  return make_msg(mc);
+}
+
+void street_routing_batch::execute() {
+  std::vector<ctx::future_ptr<ctx_data, void>> futures;
+  for (auto& g : groups_) {
+    if (g.many_.empty()) {
+      continue;
+    }
+    futures.emplace_back(spawn_job_void([&]() {
+      auto const one = std::vector<geo::latlng>{g.one_};
+      auto const msg =
+          motis_call(g.dir_ == SearchDir_Forward
+                         ? make_table_request(g.profile_, one, g.many_)
+                         : make_table_request(g.profile_, g.many_, one))
+              ->val();
+      auto const costs = motis_content(OSRMManyToManyResponse, msg)->costs();
+      utl::verify(costs->size() == g.many_.size(),
+                  "street routing: invalid osrm table response");
+      g.durations_ = {costs->begin(), costs->end()};
+    }));
+  }
+  ctx::await_all(futures);
+
+  for (auto const& r : requests_) {
+    auto const& g = groups_[r.group_];
+    for (auto i = 0UL; i < r.idx_.size(); ++i) {
+      auto const duration = g.durations_[r.idx_[i]];
+      if (duration < kUnreachable) {
+        r.cb_(i, duration);
+      }
+    }
+  }
+}
+
+}  // namespace motis::intermodal
@@ -1,12 +1,17 @@
 #include "gtest/gtest.h"
 
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
 
 #include "geo/latlng.h"
 
+#include "motis/core/access/station_access.h"
+#include "motis/core/common/constants.h"
 #include "motis/core/journey/journey.h"
 #include "motis/core/journey/message_to_journeys.h"
 #include "motis/module/message.h"
@@ -29,24 +34,36 @@ struct intermodal_itest : public motis_instance_test {
   intermodal_itest()
       : motis::test::motis_instance_test(dataset_opt,
                                          {"intermodal", "routing", "lookup"}) {
-    instance_->register_op("/osrm/one_to_many", [](msg_ptr const& msg) {
-      auto const req = motis_content(OSRMOneToManyRequest, msg);
-      auto one = latlng{req->one()->lat(), req->one()->lng()};
-
-      std::vector<Cost> costs;
-      for (auto const& loc : *req->many()) {
-        auto dist = distance(one, {loc->lat(), loc->lng()});
-        costs.emplace_back(dist / WALK_SPEED, dist);
+    instance_->register_op("/osrm/table", [&](msg_ptr const& msg) {
+      auto const req = motis_content(OSRMManyToManyRequest, msg);
+      auto const profile = req->profile()->str();
+      auto const speed = profile == "car"    ? CAR_SPEED
+                         : profile == "bike" ? BIKE_SPEED
+                                             : WALK_SPEED;
+      {
+        std::lock_guard guard{mutex_};
+        table_profiles_.emplace(profile);
+      }
+
+      std::vector<double> costs;
+      for (auto const& from : *req->from()) {
+        for (auto const& to : *req->to()) {
+          costs.emplace_back(distance(latlng{from->lat(), from->lng()},
+                                      latlng{to->lat(), to->lng()}) /
+                             speed);
+        }
       }
 
       message_creator mc;
       mc.create_and_finish(
-          MsgContent_OSRMOneToManyResponse,
-          CreateOSRMOneToManyResponse(mc, mc.CreateVectorOfStructs(costs))
-              .Union());
+          MsgContent_OSRMManyToManyResponse,
+          CreateOSRMManyToManyResponse(mc, mc.CreateVector(costs)).Union());
       return make_msg(mc);
     });
   }
+
+  std::mutex mutex_;
+  std::set<std::string> table_profiles_;
 };
 
 TEST_F(intermodal_itest, forward) {
@@ -186,6 +203,85 @@ TEST_F(intermodal_itest, backward) {
   EXPECT_DOUBLE_EQ(8.6200666, end->station()->pos()->lng());
 }
 
+TEST_F(intermodal_itest, osrm_modes) {
+  //  Heidelberg Hbf -> Bensheim ( departure: 2015-11-24 13:30:00 )
+  auto json = R"(
+    {
+      "destination": {
+        "type": "Module",
+        "target": "/intermodal"
+      },
+      "content_type": "IntermodalRoutingRequest",
+      "content": {
+        "start_type": "IntermodalOntripStart",
+        "start": {
+          "position": { "lat": 49.4047178, "lng": 8.6768716},
+          "departure_time": 1448368200
+        },
+        "start_modes": [{
+          "mode_type": "Foot",
+          "mode": { "max_duration": 600 }
+        },{
+          "mode_type": "Bike",
+          "mode": { "max_duration": 600 }
+        },{
+          "mode_type": "Car",
+          "mode": { "max_duration": 300 }
+        }],
+        "destination_type": "InputPosition",
+        "destination": { "lat": 49.6801332, "lng": 8.6200666},
+        "destination_modes":  [{
+          "mode_type": "Foot",
+          "mode": { "max_duration": 600 }
+        },{
+          "mode_type": "Bike",
+          "mode": { "max_duration": 600 }
+        },{
+          "mode_type": "Car",
+          "mode": { "max_duration": 300 }
+        }],
+        "search_type": "SingleCriterion"
+      }
+    }
+  )";
+
+  auto res = call(make_msg(json));
+  auto content = motis_content(RoutingResponse, res);
+
+  EXPECT_EQ((std::set<std::string>{"foot", "bike", "car"}), table_profiles_);
+
+  ASSERT_LE(1, content->connections()->size());
+  for (auto const& con : *content->connections()) {
+    auto const& stops = con->stops();
+    ASSERT_LE(3, stops->size());
+    EXPECT_STREQ(STATION_START, stops->Get(0)->station()->id()->c_str());
+    EXPECT_STREQ(STATION_END,
+                 stops->Get(stops->size() - 1)->station()->id()->c_str());
+
+    // the stations of the first and last street leg are real stations
+    // (ids and positions copied from the geo lookup)
+    for (auto const* s : {stops->Get(1), stops->Get(stops->size() - 2)}) {
+      auto const id = s->station()->id()->str();
+      auto const* station = find_station(sched(), id);
+      ASSERT_NE(nullptr, station) << id;
+      EXPECT_DOUBLE_EQ(station->lat(), s->station()->pos()->lat());
+      EXPECT_DOUBLE_EQ(station->lng(), s->station()->pos()->lng());
+    }
+
+    auto const transports = con->transports();
+    ASSERT_LE(2, transports->size());
+    for (auto const* t :
+         {transports->Get(0), transports->Get(transports->size() - 1)}) {
+      ASSERT_EQ(Move_Walk, t->move_type());
+      auto const mumo_type =
+          reinterpret_cast<motis::Walk const*>(t->move())->mumo_type()->str();
+      EXPECT_TRUE(mumo_type == "foot" || mumo_type == "bike" ||
+                  mumo_type == "car")
+          << mumo_type;
+    }
+  }
+}
+
 TEST_F(intermodal_itest, not_so_intermodal) {
   //  Heidelberg Hbf -> Bensheim ( departure: 2015-11-24 13:30:00 )
   auto json = R"(
@@ -8,6 +8,8 @@
 
 namespace motis::lookup {
 
+struct station_board_index;
+
 struct lookup final : public motis::module::module {
   lookup();
   ~lookup() override;
@@ -26,6 +28,8 @@ private:
   motis::module::msg_ptr lookup_stations(motis::module::msg_ptr const&) const;
 
   motis::module::msg_ptr lookup_station_events(motis::module::msg_ptr const&);
+  motis::module::msg_ptr lookup_station_events_batch(
+      motis::module::msg_ptr const&);
   motis::module::msg_ptr lookup_id_train(motis::module::msg_ptr const&);
   motis::module::msg_ptr lookup_meta_station(motis::module::msg_ptr const&);
   motis::module::msg_ptr lookup_meta_stations(motis::module::msg_ptr const&);
@@ -34,6 +38,7 @@ private:
   motis::module::msg_ptr lookup_ribasis(motis::module::msg_ptr const&);
 
   std::unique_ptr<geo::point_rtree> station_geo_index_;
+  std::unique_ptr<station_board_index> station_boards_;
 };
 
 }  // namespace motis::lookup
@@ -5,10 +5,13 @@
 #include "motis/core/schedule/schedule.h"
 #include "motis/protocol/Message_generated.h"
 
+#include "motis/lookup/station_board_index.h"
+
 namespace motis::lookup {
 
+// Events sorted by time.
 std::vector<flatbuffers::Offset<StationEvent>> lookup_station_events(
-    flatbuffers::FlatBufferBuilder&, schedule const&,
+    station_event_writer&, station_board_index&, schedule const&,
     LookupStationEventsRequest const*);
 
 }  // namespace motis::lookup
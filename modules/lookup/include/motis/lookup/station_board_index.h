@@ -0,0 +1,65 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/protocol/Message_generated.h"
+
+namespace motis::lookup {
+
+struct board_event {
+  time time_;
+  bool is_dep_;
+  light_connection const* lcon_;
+};
+
+// all arrivals and departures of one station, sorted by time
+using station_board = std::vector<board_event>;
+
+std::shared_ptr<station_board const> build_station_board(
+    schedule const&, uint32_t station_idx);
+
+// events with begin <= time < end (binary search)
+std::pair<station_board::const_iterator, station_board::const_iterator>
+board_window(station_board const&, time begin, time end);
+
+// Per-station event index shared by all station board queries.
+// Boards are built on first access and dropped for every station touched
+// by a real-time update (see update()).
+struct station_board_index {
+  std::shared_ptr<station_board const> get(schedule const&,
+                                           uint32_t station_idx);
+
+  void update(schedule const&, rt::RtUpdates const*);
+  void invalidate(uint32_t station_idx);
+
+private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<station_board const>> boards_;
+};
+
+// Serializes station events to one builder. Strings and trip ids are
+// deduplicated across all events written (e.g. all boards of a batch).
+struct station_event_writer {
+  station_event_writer(flatbuffers::FlatBufferBuilder&, schedule const&);
+
+  flatbuffers::Offset<StationEvent> write(board_event const&);
+
+private:
+  flatbuffers::Offset<flatbuffers::String> str(std::string_view);
+  flatbuffers::Offset<TripId> trip_id(trip const*);
+
+  flatbuffers::FlatBufferBuilder& fbb_;
+  schedule const& sched_;
+  std::map<trip const*, flatbuffers::Offset<TripId>> trip_ids_;
+  std::map<uint32_t, flatbuffers::Offset<flatbuffers::Vector<
+                         flatbuffers::Offset<TripId>>>>
+      merged_trip_ids_;
+};
+
+}  // namespace motis::lookup
@@ -10,13 +10,16 @@
 #include "motis/lookup/lookup_meta_station.h"
 #include "motis/lookup/lookup_ribasis.h"
 #include "motis/lookup/lookup_station_events.h"
+#include "motis/lookup/station_board_index.h"
 
 using namespace flatbuffers;
 using namespace motis::module;
 
 namespace motis::lookup {
 
-lookup::lookup() : module("Lookup", "lookup") {}
+lookup::lookup()
+    : module("Lookup", "lookup"),
+      station_boards_{std::make_unique<station_board_index>()} {}
 lookup::~lookup() = default;
 
 void lookup::init(registry& r) {
@@ -34,6 +37,9 @@ void lookup::init(registry& r) {
                 [&](msg_ptr const& m) { return lookup_stations(m); });
   r.register_op("/lookup/station_events",
                 [&](msg_ptr const& m) { return lookup_station_events(m); });
+  r.register_op(
+      "/lookup/station_events_batch",
+      [&](msg_ptr const& m) { return lookup_station_events_batch(m); });
   r.register_op("/lookup/schedule_info",
                 [&](msg_ptr const&) { return lookup_schedule_info(); });
   r.register_op("/lookup/id_train",
@@ -44,6 +50,15 @@ void lookup::init(registry& r) {
                 [&](msg_ptr const& m) { return lookup_meta_stations(m); });
   r.register_op("/lookup/ribasis",
                 [&](msg_ptr const& m) { return lookup_ribasis(m); }, {});
+
+  r.subscribe("/rt/update", [&](msg_ptr const& m) {
+    using rt::RtUpdates;
+    auto const rtu = motis_content(RtUpdates, m);
+    if (rtu->schedule() == 0U) {
+      station_boards_->update(get_sched(), rtu);
+    }
+    return nullptr;
+  });
 }
 
 msg_ptr lookup::lookup_station_id(msg_ptr const& msg) const {
@@ -87,13 +102,35 @@ msg_ptr lookup::lookup_station_events(msg_ptr const& msg) {
 
   message_creator b;
   auto const& sched = get_sched();
-  auto events = motis::lookup::lookup_station_events(b, sched, req);
+  station_event_writer writer{b, sched};
+  auto events = motis::lookup::lookup_station_events(writer, *station_boards_,
+                                                     sched, req);
   b.create_and_finish(
       MsgContent_LookupStationEventsResponse,
       CreateLookupStationEventsResponse(b, b.CreateVector(events)).Union());
   return make_msg(b);
 }
 
+msg_ptr lookup::lookup_station_events_batch(msg_ptr const& msg) {
+  auto req = motis_content(LookupBatchStationEventsRequest, msg);
+
+  message_creator b;
+  auto const& sched = get_sched();
+  station_event_writer writer{b, sched};
+  std::vector<Offset<LookupStationEventsResponse>> responses;
+  for (auto const& r : *req->requests()) {
+    auto events = motis::lookup::lookup_station_events(
+        writer, *station_boards_, sched, r);
+    responses.push_back(
+        CreateLookupStationEventsResponse(b, b.CreateVector(events)));
+  }
+  b.create_and_finish(
+      MsgContent_LookupBatchStationEventsResponse,
+      CreateLookupBatchStationEventsResponse(b, b.CreateVector(responses))
+          .Union());
+  return make_msg(b);
+}
+
 msg_ptr lookup::lookup_id_train(msg_ptr const& msg) {
   auto req = motis_content(LookupIdTrainRequest, msg);
 
@@ -0,0 +1,202 @@
+#include "motis/lookup/station_board_index.h"
+
+#include <algorithm>
+#include <system_error>
+#include <tuple>
+
+#include "utl/to_vec.h"
+
+#include "motis/core/access/edge_access.h"
+#include "motis/core/access/service_access.h"
+#include "motis/core/access/station_access.h"
+#include "motis/core/access/time_access.h"
+#include "motis/core/access/trip_iterator.h"
+#include "motis/core/conv/trip_conv.h"
+
+using namespace flatbuffers;
+
+namespace motis::lookup {
+
+std::shared_ptr<station_board const> build_station_board(
+    schedule const& sched, uint32_t const station_idx) {
+  auto board = std::make_shared<station_board>();
+  sched.station_nodes_.at(station_idx)
+      ->for_each_route_node([&](node const* route_node) {
+        for (auto const& e : route_node->incoming_edges_) {
+          if (e->type() == edge::ROUTE_EDGE) {
+            for (auto const& lcon : e->m_.route_edge_.conns_) {
+              board->emplace_back(board_event{lcon.a_time_, false, &lcon});
+            }
+          }
+        }
+        for (auto const& e : route_node->edges_) {
+          if (e.type() == edge::ROUTE_EDGE) {
+            for (auto const& lcon : e.m_.route_edge_.conns_) {
+              board->emplace_back(board_event{lcon.d_time_, true, &lcon});
+            }
+          }
+        }
+      });
+  std::stable_sort(begin(*board), end(*board),
+                   [](board_event const& a, board_event const& b) {
+                     return std::tie(a.time_, a.is_dep_) <
+                            std::tie(b.time_, b.is_dep_);
+                   });
+  return board;
+}
+
+std::pair<station_board::const_iterator, station_board::const_iterator>
+board_window(station_board const& board, time const begin, time const end) {
+  auto const from = std::lower_bound(
+      std::begin(board), std::end(board), begin,
+      [](board_event const& ev, time const t) { return ev.time_ < t; });
+  auto const to = std::lower_bound(
+      from, std::end(board), end,
+      [](board_event const& ev, time const t) { return ev.time_ < t; });
+  return {from, to};
+}
+
+std::shared_ptr<station_board const> station_board_index::get(
+    schedule const& sched, uint32_t const station_idx) {
+  {
+    std::lock_guard const lock{mutex_};
+    if (station_idx < boards_.size() && boards_[station_idx] != nullptr) {
+      return boards_[station_idx];
+    }
+  }
+
+  // Built without holding the lock: concurrent builds of the same board
+  // produce identical results, the last one wins.
+  auto board = build_station_board(sched, station_idx);
+
+  std::lock_guard const lock{mutex_};
+  if (boards_.size() < sched.station_nodes_.size()) {
+    boards_.resize(sched.station_nodes_.size());
+  }
+  boards_[station_idx] = board;
+  return board;
+}
+
+void station_board_index::invalidate(uint32_t const station_idx) {
+  std::lock_guard const lock{mutex_};
+  if (station_idx < boards_.size()) {
+    boards_[station_idx] = nullptr;
+  }
+}
+
+void station_board_index::update(schedule const& sched,
+                                 rt::RtUpdates const* updates) {
+  auto const invalidate_event = [&](rt::RtEventInfo const* ev) {
+    if (auto const s = find_station(sched, ev->station_id()->view());
+        s != nullptr) {
+      invalidate(s->index_);
+    }
+  };
+
+  // Delays propagate along the trip and reroutes replace whole routes:
+  // drop the boards of all stations served by the trip.
+  auto const invalidate_trip = [&](TripId const* id) {
+    try {
+      for (auto const& sec : access::sections(from_fbs(sched, id))) {
+        invalidate(sec.from_station_id());
+        invalidate(sec.to_station_id());
+      }
+    } catch (std::system_error const&) {
+    }
+  };
+
+  for (auto const* u : *updates->updates()) {
+    switch (u->content_type()) {
+      case rt::Content_RtDelayUpdate: {
+        auto const du =
+            reinterpret_cast<rt::RtDelayUpdate const*>(u->content());
+        invalidate_trip(du->trip());
+        for (auto const* ev : *du->events()) {
+          invalidate_event(ev->base());
+        }
+        break;
+      }
+      case rt::Content_RtRerouteUpdate: {
+        auto const ru =
+            reinterpret_cast<rt::RtRerouteUpdate const*>(u->content());
+        invalidate_trip(ru->trip());
+        for (auto const* ev : *ru->old_route()) {
+          invalidate_event(ev);
+        }
+        for (auto const* ev : *ru->new_route()) {
+          invalidate_event(ev);
+        }
+        break;
+      }
+      case rt::Content_RtTrackUpdate: {
+        auto const tu =
+            reinterpret_cast<rt::RtTrackUpdate const*>(u->content());
+        invalidate_event(tu->event());
+        break;
+      }
+      default: break;
+    }
+  }
+}
+
+station_event_writer::station_event_writer(FlatBufferBuilder& fbb,
+                                           schedule const& sched)
+    : fbb_{fbb}, sched_{sched} {}
+
+Offset<String> station_event_writer::str(std::string_view s) {
+  return fbb_.CreateSharedString(s.data(), s.size());
+}
+
+Offset<TripId> station_event_writer::trip_id(trip const* trp) {
+  if (auto const it = trip_ids_.find(trp); it != end(trip_ids_)) {
+    return it->second;
+  }
+
+  auto const& pri = trp->id_.primary_;
+  auto const& sec = trp->id_.secondary_;
+  auto const id = CreateTripId(
+      fbb_, str(sched_.stations_[pri.station_id_]->eva_nr_.view()),
+      pri.get_train_nr(), motis_to_unixtime(sched_, pri.time_),
+      str(sched_.stations_[sec.target_station_id_]->eva_nr_.view()),
+      motis_to_unixtime(sched_, sec.target_time_), str(sec.line_id_.view()));
+  trip_ids_.emplace(trp, id);
+  return id;
+}
+
+Offset<StationEvent> station_event_writer::write(board_event const& ev) {
+  auto const* lcon = ev.lcon_;
+  auto const& trips = *sched_.merged_trips_[lcon->trips_];
+
+  auto trip_ids_it = merged_trip_ids_.find(lcon->trips_);
+  if (trip_ids_it == end(merged_trip_ids_)) {
+    trip_ids_it =
+        merged_trip_ids_
+            .emplace(lcon->trips_,
+                     fbb_.CreateVector(utl::to_vec(
+                         trips, [&](auto const& trp) { return trip_id(trp); })))
+            .first;
+  }
+
+  auto const& fcon = *lcon->full_con_;
+  auto const& info = *fcon.con_info_;
+
+  // TODO(Sebastian Fahnenschreiber) get sched time
+  auto const time = motis_to_unixtime(sched_, ev.time_);
+
+  // XXX what happens with multiple trips?!
+  auto const dir =
+      str(info.dir_ != nullptr
+              ? info.dir_->view()
+              : sched_.stations_[trips.at(0)->id_.secondary_.target_station_id_]
+                    ->name_.view());
+
+  auto const& track =
+      sched_.tracks_[ev.is_dep_ ? fcon.d_track_ : fcon.a_track_];
+
+  return CreateStationEvent(
+      fbb_, trip_ids_it->second, ev.is_dep_ ? EventType_DEP : EventType_ARR,
+      info.train_nr_, str(info.line_identifier_.view()), time, time, dir,
+      str(get_service_name(sched_, &info)), str(track.view()));
+}
+
+}  // namespace motis::lookup
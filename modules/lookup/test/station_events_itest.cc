@@ -53,6 +53,26 @@ constexpr auto kFrankfurtRequest = R""(
   }}
 )"";
 
+constexpr auto kBatchRequest = R""(
+{ "destination": {"type": "Module", "target": "/lookup/station_events_batch"},
+  "content_type": "LookupBatchStationEventsRequest",
+  "content": {
+    "requests": [
+      {
+        "station_id": "8000105",  // Frankfurt(Main)Hbf
+        "interval": { "begin": 1448371800, "end": 1448375400 }
+      }, {
+        "station_id": "8000105",  // Frankfurt(Main)Hbf
+        "interval": { "begin": 1448371800, "end": 1448375400 },
+        "type": "ONLY_DEPARTURES"
+      }, {
+        "station_id": "8000046",  // Siegen Hbf
+        "interval": { "begin": 1448373600, "end": 1448374260 }
+      }
+    ]
+  }}
+)"";
+
 struct lookup_station_events_test : public motis_instance_test {
   lookup_station_events_test()
       : motis_instance_test(
@@ -231,3 +251,27 @@ TEST_F(lookup_station_events_test, station_events_no_realtime) {
     }
   }
 }
+
+TEST_F(lookup_station_events_test, station_events_batch) {
+  auto msg = call(make_msg(kBatchRequest));
+  auto resp = motis_content(LookupBatchStationEventsResponse, msg);
+  ASSERT_EQ(3, resp->responses()->size());
+
+  auto const frankfurt = resp->responses()->Get(0)->events();
+  ASSERT_EQ(3, frankfurt->size());
+  for (auto i = 1U; i < frankfurt->size(); ++i) {
+    EXPECT_LE(frankfurt->Get(i - 1)->time(), frankfurt->Get(i)->time());
+  }
+  EXPECT_EQ(EventType_ARR, frankfurt->Get(0)->type());
+  EXPECT_EQ(2292, frankfurt->Get(0)->train_nr());
+
+  auto const frankfurt_dep = resp->responses()->Get(1)->events();
+  ASSERT_EQ(1, frankfurt_dep->size());
+  EXPECT_EQ(EventType_DEP, frankfurt_dep->Get(0)->type());
+  EXPECT_EQ(628, frankfurt_dep->Get(0)->train_nr());
+  EXPECT_EQ(1448374200, frankfurt_dep->Get(0)->time());
+
+  auto const siegen = resp->responses()->Get(2)->events();
+  ASSERT_EQ(1, siegen->size());
+  EXPECT_EQ(10958, siegen->Get(0)->train_nr());
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "cista/memory_holder.h"
+
+#include "motis/memory.h"
+#include "motis/vector.h"
+
+#include "motis/core/common/lru_cache.h"
+#include "motis/core/statistics/statistics.h"
+
+namespace motis::osrm {
+
+// Grid cell of a snapped coordinate: (lat cell << 32) | lng cell.
+using cell_t = uint64_t;
+
+struct snapping_grid {
+  explicit snapping_grid(double cell_size);
+
+  cell_t snap(double lat, double lng) const;
+
+  double cell_size_deg_;
+};
+
+struct cost {
+  double duration_, distance_;
+};
+
+// Precomputed walking/cycling costs between nearby stations.
+// Sorted by (from_, to_) to allow lookups directly in the mapped file.
+struct station_cost {
+  cell_t from_, to_;
+  float duration_, distance_;
+};
+
+using station_cost_table = mcd::vector<station_cost>;
+
+mcd::unique_ptr<station_cost_table> read_station_cost_table(
+    std::string const& fname, cista::memory_holder&);
+
+void write_station_cost_table(std::string const& fname,
+                              station_cost_table const&);
+
+// Station table lookups first, then an LRU cache of OSRM results
+// (max_size entries, 0 = disabled).
+struct cost_cache {
+  cost_cache(double grid_size, std::size_t max_size);
+
+  void load_station_table(std::string const& fname);
+
+  // distance_ < 0 means the entry was produced by a table request
+  // which does not report distances.
+  std::optional<cost> get(cell_t from, cell_t to, bool need_distance);
+  void put(cell_t from, cell_t to, cost);
+
+  stats_category get_stats(std::string const& profile) const;
+
+  snapping_grid grid_;
+
+private:
+  using key_t = std::pair<cell_t, cell_t>;
+
+  struct key_hash {
+    std::size_t operator()(key_t const& k) const;
+  };
+
+  cista::memory_holder station_table_mem_;
+  mcd::unique_ptr<station_cost_table> station_table_;
+
+  lru_cache<key_t, cost, lru_entry_count, key_hash> cache_;
+
+  std::atomic_uint64_t station_table_hits_{0U};
+};
+
+}  // namespace motis::osrm
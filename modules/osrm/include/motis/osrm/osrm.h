@@ -4,6 +4,10 @@
 #include <memory>
 #include <vector>
 
+#include "boost/filesystem/path.hpp"
+
+#include "cista/hash.h"
+
 #include "motis/module/module.h"
 
 namespace motis::osrm {
@@ -28,9 +32,17 @@ public:
 
 private:
   router const* get_router(std::string const& profile);
+  motis::module::msg_ptr cache_stats() const;
+
+  void build_station_table(std::string const& dataset,
+                           boost::filesystem::path const& dir,
+                           cista::hash_t osrm_hash);
 
   std::vector<std::string> datasets_;
   std::vector<std::string> profiles_;
+  unsigned snap_grid_{10U};
+  std::size_t cache_size_{1'000'000};
+  unsigned station_table_radius_{0U};
   std::map<std::string, std::unique_ptr<router>> routers_;
 };
 
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <limits>
 #include <memory>
+#include <vector>
+
+#include "geo/latlng.h"
 
 #include "motis/module/message.h"
 
+#include "motis/osrm/cost_cache.h"
+
 namespace motis::osrm {
 
+// Table entry for source/destination pairs without a route.
+constexpr auto const kUnreachableDuration = std::numeric_limits<double>::max();
+
 struct router {
-  explicit router(std::string const& path);
+  explicit router(std::string const& path,
+                  std::unique_ptr<cost_cache> cache = nullptr);
   ~router();
 
   router(router const&) = delete;
@@ -21,6 +31,12 @@ struct router {
   motis::module::msg_ptr via(OSRMViaRouteRequest const*) const;
   motis::module::msg_ptr smooth_via(OSRMSmoothViaRouteRequest const*) const;
 
+  std::vector<cost> one_to_many(geo::latlng const& one,
+                                std::vector<geo::latlng> const& many,
+                                bool forward) const;
+
+  cost_cache* cache() const;
+
   struct impl;
   std::unique_ptr<impl> impl_;
 };
@@ -0,0 +1,111 @@
+#include "motis/osrm/cost_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cista/hash.h"
+#include "cista/mmap.h"
+#include "cista/serialization.h"
+
+namespace motis::osrm {
+
+constexpr auto const kMetersPerDegree = 111'320.0;
+constexpr auto const kMinCellSizeDeg = 1E-6;
+
+snapping_grid::snapping_grid(double const cell_size)
+    : cell_size_deg_{std::max(cell_size / kMetersPerDegree, kMinCellSizeDeg)} {}
+
+cell_t snapping_grid::snap(double const lat, double const lng) const {
+  auto const lat_cell =
+      static_cast<uint32_t>(std::floor((lat + 90.0) / cell_size_deg_));
+  auto const lng_cell =
+      static_cast<uint32_t>(std::floor((lng + 180.0) / cell_size_deg_));
+  return (static_cast<cell_t>(lat_cell) << 32U) | lng_cell;
+}
+
+mcd::unique_ptr<station_cost_table> read_station_cost_table(
+    std::string const& fname, cista::memory_holder& mem) {
+  mcd::unique_ptr<station_cost_table> ptr;
+  ptr.self_allocated_ = false;
+#if defined(MOTIS_SCHEDULE_MODE_OFFSET) && !defined(CLANG_TIDY)
+  mem = cista::buf<cista::mmap>(
+      cista::mmap{fname.c_str(), cista::mmap::protection::READ});
+  ptr.el_ = cista::deserialize<station_cost_table, CISTA_MODE>(
+      std::get<cista::buf<cista::mmap>>(mem));
+#elif defined(MOTIS_SCHEDULE_MODE_RAW) || defined(CLANG_TIDY)
+  mem = cista::file(fname.c_str(), "r").content();
+  // suppress clang-tidy false positive
+  // NOLINTNEXTLINE
+  ptr.el_ = cista::deserialize<station_cost_table, CISTA_MODE>(
+      std::get<cista::buffer>(mem));
+#else
+#error "no ptr mode specified"
+#endif
+  return ptr;
+}
+
+void write_station_cost_table(std::string const& fname,
+                              station_cost_table const& table) {
+  auto writer = cista::buf<cista::mmap>(
+      cista::mmap{fname.c_str(), cista::mmap::protection::WRITE});
+  cista::serialize<CISTA_MODE>(writer, table);
+}
+
+std::size_t cost_cache::key_hash::operator()(key_t const& k) const {
+  return cista::hash_combine(cista::BASE_HASH, k.first, k.second);
+}
+
+cost_cache::cost_cache(double const grid_size, std::size_t const max_size)
+    : grid_{grid_size}, cache_{max_size} {}
+
+void cost_cache::load_station_table(std::string const& fname) {
+  station_table_ = read_station_cost_table(fname, station_table_mem_);
+}
+
+std::optional<cost> cost_cache::get(cell_t const from, cell_t const to,
+                                    bool const need_distance) {
+  if (station_table_ != nullptr) {
+    auto const it = std::lower_bound(
+        begin(*station_table_), end(*station_table_), std::pair{from, to},
+        [](station_cost const& a, std::pair<cell_t, cell_t> const& b) {
+          return std::pair{a.from_, a.to_} < b;
+        });
+    if (it != end(*station_table_) && it->from_ == from && it->to_ == to) {
+      ++station_table_hits_;
+      return cost{it->duration_, it->distance_};
+    }
+  }
+
+  return cache_.get({from, to}, [&](cost const& c) {
+    return !need_distance || c.distance_ >= 0.0;
+  });
+}
+
+void cost_cache::put(cell_t const from, cell_t const to, cost const c) {
+  if (c.distance_ >= 0.0) {
+    cache_.insert_or_assign({from, to}, c);
+  } else {
+    // keep a cached distance
+    cache_.put({from, to}, c);
+  }
+}
+
+stats_category cost_cache::get_stats(std::string const& profile) const {
+  auto const cache_stats = cache_.stats();
+  uint64_t const station_table_hits = station_table_hits_;
+  auto const hits = station_table_hits + cache_stats.hits_;
+  auto const lookups = hits + cache_stats.misses_;
+  auto const hit_rate_permille = lookups == 0U ? 0U : hits * 1000U / lookups;
+  return stats_category{
+      "osrm." + profile,
+      {{"station_table_size",
+        station_table_ == nullptr ? 0U : station_table_->size()},
+       {"station_table_hits", station_table_hits},
+       {"cache_entries", cache_stats.entries_},
+       {"cache_hits", cache_stats.hits_},
+       {"misses", cache_stats.misses_},
+       {"evictions", cache_stats.evictions_},
+       {"hit_rate_permille", hit_rate_permille}}};
+}
+
+}  // namespace motis::osrm
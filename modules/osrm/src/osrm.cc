@@ -1,5 +1,6 @@
 #include "motis/osrm/osrm.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "boost/filesystem.hpp"
@@ -11,13 +12,20 @@
 #include "extractor/extractor.hpp"
 #include "extractor/extractor_config.hpp"
 
+#include "geo/point_rtree.h"
+
+#include "utl/parallel_for.h"
+#include "utl/to_vec.h"
+
 #include "motis/core/common/logging.h"
+#include "motis/core/statistics/statistics.h"
 #include "motis/module/clog_redirect.h"
 #include "motis/module/context/motis_parallel_for.h"
 #include "motis/module/context/motis_publish.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/ini_io.h"
 
+#include "motis/osrm/cost_cache.h"
 #include "motis/osrm/error.h"
 #include "motis/osrm/router.h"
 
@@ -35,8 +43,25 @@ struct import_state {
   named<size_t, MOTIS_NAME("size")> size_;
 };
 
+struct station_table_state {
+  CISTA_COMPARABLE()
+  named<cista::hash_t, MOTIS_NAME("osm_hash")> osm_hash_;
+  named<cista::hash_t, MOTIS_NAME("schedule_hash")> schedule_hash_;
+  named<unsigned, MOTIS_NAME("radius")> radius_;
+  named<unsigned, MOTIS_NAME("snap_grid")> snap_grid_;
+};
+
+constexpr auto const kStationTableFile = "station_costs.bin";
+
 osrm::osrm() : module("OSRM Options", "osrm") {
   param(profiles_, "profiles", "lua profile paths");
+  param(snap_grid_, "snap_grid",
+        "grid cell size (meters) for sharing cached costs between nearby "
+        "query coordinates");
+  param(cache_size_, "cache_size", "max. cached costs per profile (0=off)");
+  param(station_table_radius_, "station_table_radius",
+        "precompute costs between stations within this radius (meters, "
+        "0=off)");
 }
 
 osrm::~osrm() = default;
@@ -45,7 +70,7 @@ void osrm::import(motis::module::import_dispatcher& reg) {
   for (auto const& p : profiles_) {
     auto const profile_name =
         boost::filesystem::path{p}.stem().generic_string();
-    std::make_shared<event_collector>(
+    auto const collector = std::make_shared<event_collector>(
         get_data_directory().generic_string(), "osrm-" + profile_name, reg,
         [this, profile_name, p](
             event_collector::dependencies_map_t const& dependencies,
@@ -87,6 +112,10 @@ void osrm::import(motis::module::import_dispatcher& reg) {
             write_ini(dir / "import.ini", state);
           }
 
+          if (station_table_radius_ != 0U) {
+            build_station_table(extr_conf.output_file_name, dir, osm->hash());
+          }
+
           datasets_.emplace_back(extr_conf.output_file_name);
 
           message_creator fbb;
@@ -102,9 +131,80 @@ void osrm::import(motis::module::import_dispatcher& reg) {
         ->require("OSM", [](msg_ptr const& msg) {
           return msg->get()->content_type() == MsgContent_OSMEvent;
         });
+    if (station_table_radius_ != 0U) {
+      collector->require("SCHEDULE", [](msg_ptr const& msg) {
+        return msg->get()->content_type() == MsgContent_ScheduleEvent;
+      });
+    }
   }
 }
 
+void osrm::build_station_table(std::string const& dataset, fs::path const& dir,
+                               cista::hash_t const osm_hash) {
+  auto const& sched = get_sched();
+  auto const state = station_table_state{osm_hash, sched.hash_,
+                                         station_table_radius_, snap_grid_};
+  if (read_ini<station_table_state>(dir / "station_table.ini") == state) {
+    return;
+  }
+
+  scoped_timer timer("building OSRM station cost table: " +
+                     dir.filename().generic_string());
+
+  auto const r = router{dataset};
+  auto const grid = snapping_grid{static_cast<double>(snap_grid_)};
+  auto const rtree =
+      geo::make_point_rtree(sched.stations_, [](auto const& s) {
+        return geo::latlng{s->lat(), s->lng()};
+      });
+
+  std::vector<std::vector<station_cost>> station_costs(sched.stations_.size());
+  utl::parallel_for_run(sched.stations_.size(), [&](auto const idx) {
+    auto const& from = *sched.stations_[idx];
+    auto const from_pos = geo::latlng{from.lat(), from.lng()};
+    auto const neighbours = rtree.in_radius(from_pos, station_table_radius_);
+    if (neighbours.empty()) {
+      return;
+    }
+
+    auto const to_pos = utl::to_vec(neighbours, [&](auto const to_idx) {
+      auto const& to = *sched.stations_[to_idx];
+      return geo::latlng{to.lat(), to.lng()};
+    });
+    auto const costs = r.one_to_many(from_pos, to_pos, true);
+
+    auto const from_cell = grid.snap(from_pos.lat_, from_pos.lng_);
+    auto& out = station_costs[idx];
+    for (auto i = 0U; i < to_pos.size(); ++i) {
+      out.emplace_back(station_cost{
+          from_cell, grid.snap(to_pos[i].lat_, to_pos[i].lng_),
+          static_cast<float>(costs[i].duration_),
+          static_cast<float>(costs[i].distance_)});
+    }
+  });
+
+  station_cost_table table;
+  for (auto const& costs : station_costs) {
+    for (auto const& c : costs) {
+      table.emplace_back(c);
+    }
+  }
+  std::sort(begin(table), end(table), [](auto const& a, auto const& b) {
+    return std::pair{a.from_, a.to_} < std::pair{b.from_, b.to_};
+  });
+  table.erase(std::unique(begin(table), end(table),
+                          [](auto const& a, auto const& b) {
+                            return a.from_ == b.from_ && a.to_ == b.to_;
+                          }),
+              end(table));
+
+  LOG(info) << "OSRM station cost table " << dir.filename().generic_string()
+            << ": " << table.size() << " entries";
+
+  write_station_cost_table((dir / kStationTableFile).generic_string(), table);
+  write_ini(dir / "station_table.ini", state);
+}
+
 bool osrm::import_successful() const {
   return datasets_.size() == profiles_.size();
 }
@@ -127,6 +227,8 @@ void osrm::init(motis::module::registry& reg) {
     auto const req = motis_content(OSRMSmoothViaRouteRequest, msg);
     return get_router(req->profile()->str())->smooth_via(req);
   });
+  reg.register_op("/osrm/cache_stats",
+                  [this](msg_ptr const&) { return cache_stats(); });
 }
 
 void osrm::init_async() {
@@ -141,13 +243,31 @@ void osrm::init_async() {
 
         auto const profile = directory.filename().string();
         scoped_timer timer("loading OSRM dataset: " + profile);
-        auto r = std::make_unique<router>(dataset);
+
+        auto cache = std::make_unique<cost_cache>(snap_grid_, cache_size_);
+        auto const station_table = directory / kStationTableFile;
+        if (station_table_radius_ != 0U && fs::exists(station_table)) {
+          cache->load_station_table(station_table.generic_string());
+        }
+        auto r = std::make_unique<router>(dataset, std::move(cache));
 
         std::lock_guard<std::mutex> lock(mutex);
         routers_.emplace(profile, std::move(r));
       }));
 }
 
+msg_ptr osrm::cache_stats() const {
+  message_creator fbb;
+  auto stats = utl::to_vec(routers_, [&](auto const& r) {
+    return to_fbs(fbb, r.second->cache()->get_stats(r.first));
+  });
+  fbb.create_and_finish(
+      MsgContent_StatisticsResponse,
+      CreateStatisticsResponse(fbb, fbb.CreateVectorOfSortedTables(&stats))
+          .Union());
+  return make_msg(fbb);
+}
+
 router const* osrm::get_router(std::string const& profile) {
   auto const it = routers_.find(profile);
   if (it == end(routers_)) {
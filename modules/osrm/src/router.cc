@@ -1,5 +1,7 @@
 #include "motis/osrm/router.h"
 
+#include <map>
+
 #include "osrm/engine_config.hpp"
 #include "osrm/multi_target_parameters.hpp"
 #include "osrm/osrm.hpp"
@@ -25,7 +27,8 @@ namespace motis::osrm {
 
 struct router::impl {
 public:
-  explicit impl(std::string const& path) {
+  impl(std::string const& path, std::unique_ptr<cost_cache> cache)
+      : cache_{std::move(cache)} {
     EngineConfig config;
     config.storage_config = {path};
     config.use_shared_memory = false;
@@ -37,38 +40,104 @@ public:
     return FloatCoordinate{FloatLongitude{lng}, FloatLatitude{lat}};
   }
 
-  msg_ptr table(OSRMManyToManyRequest const* req) const {
-    if (req->from()->size() == 0U || req->to()->size() == 0U) {
-      message_creator fbb;
-      fbb.create_and_finish(MsgContent_OSRMManyToManyResponse,
-                            CreateOSRMManyToManyResponse(
-                                fbb, fbb.CreateVector(std::vector<double>{}))
-                                .Union());
-      return make_msg(fbb);
-    }
+  static geo::latlng to_latlng(Position const* pos) {
+    return {pos->lat(), pos->lng()};
+  }
 
+  std::vector<double> table(std::vector<geo::latlng> const& from,
+                            std::vector<geo::latlng> const& to) const {
     TableParameters params;
-    for (auto const& loc : *req->from()) {
+    for (auto const& loc : from) {
       params.sources.emplace_back(params.sources.size());
-      params.coordinates.emplace_back(make_coord(loc->lat(), loc->lng()));
+      params.coordinates.emplace_back(make_coord(loc.lat_, loc.lng_));
     }
-    for (auto const& loc : *req->to()) {
+    for (auto const& loc : to) {
       params.destinations.emplace_back(params.sources.size() +
                                        params.destinations.size());
-      params.coordinates.emplace_back(make_coord(loc->lat(), loc->lng()));
+      params.coordinates.emplace_back(make_coord(loc.lat_, loc.lng_));
     }
 
     Object result;
     osrm_->Table(params, result);
 
     std::vector<double> durations;
+    durations.reserve(from.size() * to.size());
     for (auto const& duration_row :
          result.values["durations"].get<Array>().values) {
       for (auto const& d : duration_row.get<Array>().values) {
-        durations.emplace_back(d.get<Number>().value);
+        durations.emplace_back(d.is<Number>() ? d.get<Number>().value
+                                              : kUnreachableDuration);
+      }
+    }
+    return durations;
+  }
+
+  std::vector<double> cached_table(std::vector<geo::latlng> const& from,
+                                   std::vector<geo::latlng> const& to) const {
+    if (cache_ == nullptr) {
+      return table(from, to);
+    }
+
+    auto const& grid = cache_->grid_;
+    auto const snap = [&](geo::latlng const& pos) {
+      return grid.snap(pos.lat_, pos.lng_);
+    };
+    auto const from_cells = utl::to_vec(from, snap);
+    auto const to_cells = utl::to_vec(to, snap);
+
+    // Rows with the same missing columns share one table request:
+    // cached entries are not requested again (new sources typically miss
+    // all columns, known sources only the new targets).
+    std::vector<double> durations(from.size() * to.size());
+    std::map<std::vector<bool>, std::vector<std::size_t>> missing_rows;
+    for (auto r = 0U; r < from.size(); ++r) {
+      std::vector<bool> missing(to.size());
+      auto any_missing = false;
+      for (auto c = 0U; c < to.size(); ++c) {
+        if (auto const cached =
+                cache_->get(from_cells[r], to_cells[c], false);
+            cached.has_value()) {
+          durations[r * to.size() + c] = cached->duration_;
+        } else {
+          missing[c] = true;
+          any_missing = true;
+        }
+      }
+      if (any_missing) {
+        missing_rows[missing].emplace_back(r);
       }
     }
 
+    for (auto const& [missing, rows] : missing_rows) {
+      std::vector<std::size_t> cols;
+      for (auto c = 0U; c < to.size(); ++c) {
+        if (missing[c]) {
+          cols.emplace_back(c);
+        }
+      }
+
+      auto const sub =
+          table(utl::to_vec(rows, [&](std::size_t const r) { return from[r]; }),
+                utl::to_vec(cols, [&](std::size_t const c) { return to[c]; }));
+      for (auto i = 0U; i < rows.size(); ++i) {
+        for (auto j = 0U; j < cols.size(); ++j) {
+          auto const duration = sub[i * cols.size() + j];
+          durations[rows[i] * to.size() + cols[j]] = duration;
+          cache_->put(from_cells[rows[i]], to_cells[cols[j]],
+                      cost{duration, -1.0});
+        }
+      }
+    }
+    return durations;
+  }
+
+  msg_ptr table(OSRMManyToManyRequest const* req) const {
+    std::vector<double> durations;
+    if (req->from()->size() != 0U && req->to()->size() != 0U) {
+      durations = cached_table(utl::to_vec(*req->from(), to_latlng),
+                               utl::to_vec(*req->to(), to_latlng));
+    }
+
     message_creator fbb;
     fbb.create_and_finish(
         MsgContent_OSRMManyToManyResponse,
@@ -78,26 +147,16 @@ public:
     return make_msg(fbb);
   }
 
-  msg_ptr one_to_many(OSRMOneToManyRequest const* req) const {
-    if (req->many()->size() == 0U) {
-      message_creator fbb;
-      fbb.create_and_finish(
-          MsgContent_OSRMOneToManyResponse,
-          CreateOSRMOneToManyResponse(
-              fbb, fbb.CreateVectorOfStructs(std::vector<Cost>{}))
-              .Union());
-      return make_msg(fbb);
-    }
-
+  std::vector<cost> one_to_many(geo::latlng const& one,
+                                std::vector<geo::latlng> const& many,
+                                bool const forward) const {
     MultiTargetParameters params;
-    params.forward = req->direction() == SearchDir_Forward;
+    params.forward = forward;
 
-    params.coordinates.reserve(req->many()->size() + 1);
-    params.coordinates.emplace_back(
-        make_coord(req->one()->lat(), req->one()->lng()));
-
-    for (auto const& loc : *req->many()) {
-      params.coordinates.emplace_back(make_coord(loc->lat(), loc->lng()));
+    params.coordinates.reserve(many.size() + 1);
+    params.coordinates.emplace_back(make_coord(one.lat_, one.lng_));
+    for (auto const& loc : many) {
+      params.coordinates.emplace_back(make_coord(loc.lat_, loc.lng_));
     }
 
     Object result;
@@ -107,11 +166,65 @@ public:
       throw std::system_error(error::no_routing_response);
     }
 
+    return utl::to_vec(result.values["costs"].get<Array>().values,
+                       [](auto const& c) {
+                         auto const& cost_obj = c.template get<Object>();
+                         return cost{cost_obj.values.at("duration")
+                                         .template get<Number>()
+                                         .value,
+                                     cost_obj.values.at("distance")
+                                         .template get<Number>()
+                                         .value};
+                       });
+  }
+
+  std::vector<cost> cached_one_to_many(geo::latlng const& one,
+                                       std::vector<geo::latlng> const& many,
+                                       bool const forward) const {
+    if (cache_ == nullptr) {
+      return one_to_many(one, many, forward);
+    }
+
+    auto const one_cell = cache_->grid_.snap(one.lat_, one.lng_);
+    auto const key = [&](cell_t const other) {
+      return forward ? std::pair{one_cell, other} : std::pair{other, one_cell};
+    };
+
+    std::vector<cost> costs(many.size());
+    std::vector<cell_t> cells(many.size());
+    std::vector<std::size_t> missing_idx;
+    std::vector<geo::latlng> missing;
+    for (auto i = 0U; i < many.size(); ++i) {
+      cells[i] = cache_->grid_.snap(many[i].lat_, many[i].lng_);
+      auto const [from, to] = key(cells[i]);
+      if (auto const cached = cache_->get(from, to, true); cached.has_value()) {
+        costs[i] = *cached;
+      } else {
+        missing_idx.emplace_back(i);
+        missing.emplace_back(many[i]);
+      }
+    }
+
+    if (!missing.empty()) {
+      auto const computed = one_to_many(one, missing, forward);
+      for (auto i = 0U; i < missing_idx.size(); ++i) {
+        costs[missing_idx[i]] = computed[i];
+        auto const [from, to] = key(cells[missing_idx[i]]);
+        cache_->put(from, to, computed[i]);
+      }
+    }
+
+    return costs;
+  }
+
+  msg_ptr one_to_many(OSRMOneToManyRequest const* req) const {
     std::vector<Cost> costs;
-    for (auto const& cost : result.values["costs"].get<Array>().values) {
-      auto const& cost_obj = cost.get<Object>();
-      costs.emplace_back(cost_obj.values.at("duration").get<Number>().value,
-                         cost_obj.values.at("distance").get<Number>().value);
+    if (req->many()->size() != 0U) {
+      costs = utl::to_vec(
+          cached_one_to_many(to_latlng(req->one()),
+                             utl::to_vec(*req->many(), to_latlng),
+                             req->direction() == SearchDir_Forward),
+          [](cost const& c) { return Cost{c.duration_, c.distance_}; });
     }
 
     message_creator fbb;
@@ -197,10 +310,11 @@ public:
   }
 
   std::unique_ptr<OSRM> osrm_;
+  std::unique_ptr<cost_cache> cache_;
 };
 
-router::router(std::string const& path)
-    : impl_(std::make_unique<router::impl>(path)) {}
+router::router(std::string const& path, std::unique_ptr<cost_cache> cache)
+    : impl_(std::make_unique<router::impl>(path, std::move(cache))) {}
 
 router::~router() = default;
 
@@ -220,4 +334,12 @@ msg_ptr router::smooth_via(OSRMSmoothViaRouteRequest const* req) const {
   return impl_->smooth_via(req);
 }
 
+std::vector<cost> router::one_to_many(geo::latlng const& one,
+                                      std::vector<geo::latlng> const& many,
+                                      bool const forward) const {
+  return impl_->one_to_many(one, many, forward);
+}
+
+cost_cache* router::cache() const { return impl_->cache_.get(); }
+
 }  // namespace motis::osrm
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include "motis/osrm/cost_cache.h"
+
+using namespace motis;
+using namespace motis::osrm;
+
+namespace {
+
+uint64_t get_stat(stats_category const& stats, char const* name) {
+  for (auto const& e : stats.entries_) {
+    if (e.key_ == name) {
+      return e.value_;
+    }
+  }
+  return 0U;
+}
+
+}  // namespace
+
+TEST(osrm_cost_cache, hit_miss) {
+  auto cache = cost_cache{100.0, 4U};
+
+  EXPECT_FALSE(cache.get(1U, 2U, false).has_value());
+  cache.put(1U, 2U, cost{60.0, 100.0});
+  auto const c = cache.get(1U, 2U, false);
+  ASSERT_TRUE(c.has_value());
+  EXPECT_EQ(60.0, c->duration_);
+  EXPECT_EQ(100.0, c->distance_);
+  EXPECT_FALSE(cache.get(2U, 1U, false).has_value());  // directed
+
+  // table results have no distance
+  cache.put(3U, 4U, cost{30.0, -1.0});
+  EXPECT_TRUE(cache.get(3U, 4U, false).has_value());
+  EXPECT_FALSE(cache.get(3U, 4U, true).has_value());
+  cache.put(3U, 4U, cost{30.0, 50.0});
+  EXPECT_TRUE(cache.get(3U, 4U, true).has_value());
+  // a table result does not overwrite a known distance
+  cache.put(3U, 4U, cost{30.0, -1.0});
+  EXPECT_TRUE(cache.get(3U, 4U, true).has_value());
+
+  auto const stats = cache.get_stats("foot");
+  EXPECT_EQ("osrm.foot", stats.key_);
+  EXPECT_EQ(4U, get_stat(stats, "cache_hits"));
+  EXPECT_EQ(3U, get_stat(stats, "misses"));
+  EXPECT_EQ(0U, get_stat(stats, "evictions"));
+}
+
+TEST(osrm_cost_cache, lru_eviction) {
+  auto cache = cost_cache{100.0, 2U};
+
+  cache.put(1U, 1U, cost{1.0, 1.0});
+  cache.put(2U, 2U, cost{2.0, 2.0});
+  EXPECT_TRUE(cache.get(1U, 1U, false).has_value());  // 2 is now LRU
+  cache.put(3U, 3U, cost{3.0, 3.0});  // evicts 2 only
+
+  EXPECT_TRUE(cache.get(1U, 1U, false).has_value());
+  EXPECT_FALSE(cache.get(2U, 2U, false).has_value());
+  EXPECT_TRUE(cache.get(3U, 3U, false).has_value());
+  EXPECT_EQ(1U, get_stat(cache.get_stats("foot"), "evictions"));
+}
+
+TEST(osrm_cost_cache, disabled) {
+  auto cache = cost_cache{100.0, 0U};
+  cache.put(1U, 1U, cost{1.0, 1.0});
+  EXPECT_FALSE(cache.get(1U, 1U, false).has_value());
+}
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <utility>
 
 #include "motis/module/module.h"
 
+namespace motis {
+struct tile_cache;
+namespace path {
+struct path_feature_cache;
+}  // namespace path
+}  // namespace motis
+
 namespace motis::path {
 
 struct path : public motis::module::module {
@@ -32,9 +40,19 @@ private:
 
   motis::module::msg_ptr path_tiles(motis::module::msg_ptr const&) const;
 
+  motis::module::msg_ptr stats() const;
+
   std::vector<std::string> use_cache_;
   bool import_successful_{false};
   size_t max_size_{size_t{32} * 1024 * 1024 * 1024};
+  size_t tile_cache_size_{size_t{128} * 1024 * 1024};
+  size_t feature_cache_size_{100'000};
+
+  struct batch_stats;
+
+  std::unique_ptr<tile_cache> tile_cache_;
+  std::unique_ptr<path_feature_cache> feature_cache_;
+  std::unique_ptr<batch_stats> batch_stats_;
 };
 
 }  // namespace motis::path
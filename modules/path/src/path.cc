@@ -1,6 +1,11 @@
 #include "motis/path/path.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <numeric>
+#include <optional>
 
 #include "boost/filesystem.hpp"
 
@@ -14,8 +19,11 @@
 #include "tiles/parse_tile_url.h"
 
 #include "motis/core/common/logging.h"
+#include "motis/core/common/tile_cache.h"
+#include "motis/core/common/timing.h"
 #include "motis/core/access/trip_iterator.h"
 #include "motis/core/conv/trip_conv.h"
+#include "motis/module/context/motis_parallel_for.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/ini_io.h"
 
@@ -23,6 +31,7 @@
 #include "motis/path/error.h"
 #include "motis/path/path_data.h"
 #include "motis/path/path_database_query.h"
+#include "motis/path/path_feature_cache.h"
 
 #include "motis/path/prepare/prepare.h"
 
@@ -41,9 +50,50 @@ struct import_state {
   named<cista::hash_t, MOTIS_NAME("schedule_hash")> schedule_hash_;
 };
 
+struct path::batch_stats {
+  // batches with up to 1, 10, 100, 1000 and more trip segments
+  static constexpr auto const kBuckets =
+      std::array<size_t, 4>{1U, 10U, 100U, 1000U};
+
+  void add(size_t const batch_size, uint64_t const duration_us) {
+    auto const bucket = static_cast<size_t>(
+        std::distance(begin(kBuckets), std::lower_bound(begin(kBuckets),
+                                                        end(kBuckets),
+                                                        batch_size)));
+    ++count_[bucket];
+    total_us_[bucket] += duration_us;
+    auto max = max_us_[bucket].load();
+    while (max < duration_us &&
+           !max_us_[bucket].compare_exchange_weak(max, duration_us)) {
+    }
+  }
+
+  stats_category get_stats() const {
+    stats_category c{"path.by_trip_id_batch", {}};
+    for (auto i = 0U; i <= kBuckets.size(); ++i) {
+      auto const name = i == kBuckets.size()
+                            ? std::string{"more"}
+                            : "le_" + std::to_string(kBuckets[i]);
+      auto const count = count_[i].load();
+      c.entries_.emplace_back(name + "_count", count);
+      c.entries_.emplace_back(name + "_avg_us",
+                              count == 0U ? 0U : total_us_[i] / count);
+      c.entries_.emplace_back(name + "_max_us", max_us_[i].load());
+    }
+    return c;
+  }
+
+  std::array<std::atomic_uint64_t, kBuckets.size() + 1> count_{}, total_us_{},
+      max_us_{};
+};
+
 path::path() : module("Path", "path") {
   param(use_cache_, "use_cache", "caches to use during import {osm, seq}");
   param(max_size_, "max_size", "path db max size");
+  param(tile_cache_size_, "tile_cache_size",
+        "rendered tile cache size in bytes");
+  param(feature_cache_size_, "feature_cache_size",
+        "number of decoded path features to cache");
 }
 
 path::~path() = default;
@@ -111,6 +161,10 @@ void path::import(import_dispatcher& reg) {
 }
 
 void path::init(registry& r) {
+  tile_cache_ = std::make_unique<tile_cache>(tile_cache_size_);
+  feature_cache_ = std::make_unique<path_feature_cache>(feature_cache_size_);
+  batch_stats_ = std::make_unique<batch_stats>();
+
   try {
     auto data = path_data{};
     data.db_ = make_path_database(
@@ -152,6 +206,8 @@ void path::init(registry& r) {
   // used by: debugger
   r.register_op("/path/tiles",
                 [this](msg_ptr const& m) { return path_tiles(m); });
+
+  r.register_op("/path/stats", [this](msg_ptr const&) { return stats(); });
 }
 
 msg_ptr path::boxes() const {
@@ -185,43 +241,65 @@ msg_ptr path::by_trip_id(msg_ptr const& msg) const {
 }
 
 msg_ptr path::by_trip_id_batch(msg_ptr const& msg) const {
+  MOTIS_START_TIMING(batch_timing);
   auto const& data =
       get_shared_data<path_data>(to_res_id(global_res_id::PATH_DATA));
   auto const& req = motis_content(PathByTripIdBatchRequest, msg);
   auto const& sched = get_sched();
 
-  path_database_query q{req->zoom_level()};
-
-  for (auto const* trp_segment : *req->trip_segments()) {
+  struct resolved_segment {
+    std::optional<size_t> index_;
+    std::vector<size_t> segments_;
+    std::vector<geo::polyline> extra_;
+  };
+
+  auto resolved = std::vector<resolved_segment>(req->trip_segments()->size());
+  auto indices = std::vector<size_t>(resolved.size());
+  std::iota(begin(indices), end(indices), size_t{0U});
+  motis_parallel_for(indices, [&](size_t const i) {
+    auto const* trp_segment = req->trip_segments()->Get(i);
     auto const* trp = from_fbs(sched, trp_segment->trip_id());
-    auto segments = utl::to_vec(*trp_segment->segments(),
-                                [](auto s) -> size_t { return s; });
+    auto& r = resolved[i];
+    r.segments_ = utl::to_vec(*trp_segment->segments(),
+                              [](auto s) -> size_t { return s; });
 
     try {
-      auto index = data.trip_to_index(sched, trp);
-      q.add_sequence(index, std::move(segments));
+      r.index_ = data.trip_to_index(sched, trp);
     } catch (std::system_error const&) {
-      std::vector<geo::polyline> extra;
-      size_t i = 0;
+      size_t j = 0;
       for (auto const& s : sections(trp)) {
-        if (segments.empty() ||
-            std::find(begin(segments), end(segments), i) != end(segments)) {
+        if (r.segments_.empty() ||
+            std::find(begin(r.segments_), end(r.segments_), j) !=
+                end(r.segments_)) {
           auto const& from = s.from_station(sched);
           auto const& to = s.to_station(sched);
-          extra.emplace_back(geo::polyline{geo::latlng{from.lat(), from.lng()},
-                                           geo::latlng{to.lat(), to.lng()}});
+          r.extra_.emplace_back(
+              geo::polyline{geo::latlng{from.lat(), from.lng()},
+                            geo::latlng{to.lat(), to.lng()}});
         }
-        ++i;
+        ++j;
       }
-      q.add_extra(extra);
+    }
+  });
+
+  path_database_query q{req->zoom_level(), feature_cache_.get()};
+  for (auto& r : resolved) {
+    if (r.index_.has_value()) {
+      q.add_sequence(*r.index_, std::move(r.segments_));
+    } else {
+      q.add_extra(r.extra_);
     }
   }
 
-  q.execute(*data.db_);
+  q.execute(*data.db_, true);
 
   message_creator mc;
   mc.create_and_finish(MsgContent_PathByTripIdBatchResponse,
                        q.write_batch(mc).Union());
+
+  MOTIS_STOP_TIMING(batch_timing);
+  batch_stats_->add(resolved.size(),
+                    static_cast<uint64_t>(MOTIS_TIMING_US(batch_timing)));
   return make_msg(mc);
 }
 
@@ -249,15 +327,17 @@ msg_ptr path::path_tiles(msg_ptr const& msg) const {
   auto tile = tiles::parse_tile_url(msg->get()->destination()->target()->str());
   utl::verify_ex(tile.has_value(), std::system_error{error::invalid_request});
 
-  tiles::null_perf_counter pc;
-  auto rendered_tile =
-      tiles::get_tile(*data.db_->db_handle_, *data.db_->pack_handle_,
-                      data.render_ctx_, *tile, pc);
+  auto const rendered_tile =
+      tile_cache_->get_or_render(tile->z_, tile->x_, tile->y_, [&]() {
+        tiles::null_perf_counter pc;
+        return tiles::get_tile(*data.db_->db_handle_, *data.db_->pack_handle_,
+                               data.render_ctx_, *tile, pc);
+      });
 
   message_creator mc;
   std::vector<Offset<HTTPHeader>> headers;
   Offset<String> payload;
-  if (rendered_tile) {
+  if (rendered_tile != nullptr) {
     headers.emplace_back(CreateHTTPHeader(
         mc, mc.CreateString("Content-Type"),
         mc.CreateString("application/vnd.mapbox-vector-tile")));
@@ -276,4 +356,17 @@ msg_ptr path::path_tiles(msg_ptr const& msg) const {
   return make_msg(mc);
 }
 
+msg_ptr path::stats() const {
+  message_creator mc;
+  std::vector<Offset<Statistics>> stats{
+      to_fbs(mc, tile_cache_->get_stats("path.tile_cache")),
+      to_fbs(mc, feature_cache_->get_stats("path.feature_cache")),
+      to_fbs(mc, batch_stats_->get_stats())};
+  mc.create_and_finish(
+      MsgContent_StatisticsResponse,
+      CreateStatisticsResponse(mc, mc.CreateVectorOfSortedTables(&stats))
+          .Union());
+  return make_msg(mc);
+}
+
 }  // namespace motis::path
@@ -13,8 +13,11 @@
 #include "tiles/fixed/convert.h"
 #include "tiles/get_tile.h"
 
+#include "motis/module/controller.h"
+
 #include "motis/path/path_database.h"
 #include "motis/path/path_database_query.h"
+#include "motis/path/path_feature_cache.h"
 #include "motis/path/prepare/db_builder.h"
 #include "geo/polyline_format.h"
 
@@ -595,3 +598,94 @@ TEST_F(path_database_query_test, batch_extra) {
   EXPECT_EQ(1, resp->extras()->Get(0));
   EXPECT_EQ(2, resp->extras()->Get(1));
 }
+
+TEST_F(path_database_query_test, parallel_equals_sequential) {
+  auto builder = std::make_unique<mp::db_builder>(db_fname(), kTestDbMaxSize);
+
+  // features far apart, every one in its own tile (= subquery)
+  constexpr auto const kSequences =
+      2 * mp::path_database_query::kMinParallelSubqueries;
+  constexpr auto const kSpacing = tiles::fixed_coord_t{1} << 16;
+  for (auto i = 0UL; i < kSequences; ++i) {
+    auto const x = static_cast<tiles::fixed_coord_t>(i) * kSpacing;
+    auto [id, h] = add_feature(*builder, {x, x + 1, x + 2});
+    add_seq(*builder, i, {{i % 2 == 0 ? id : -id}}, {{h}});
+  }
+
+  builder->finish();
+  builder.reset();
+
+  auto db = mp::make_path_database(db_fname(), true, false, kTestDbMaxSize);
+
+  auto const run = [&](bool const parallel) {
+    mp::path_database_query q;
+    for (auto i = 0UL; i < kSequences; ++i) {
+      q.add_sequence(i);
+    }
+    if (parallel) {
+      mm::controller c({});
+      c.run([&]() { q.execute(*db, true); }, {});
+    } else {
+      q.execute(*db);
+    }
+    EXPECT_LE(mp::path_database_query::kMinParallelSubqueries,
+              q.subqueries_.size());
+    return get_batch(q).first->to_json();
+  };
+
+  EXPECT_EQ(run(false), run(true));
+}
+
+TEST_F(path_database_query_test, feature_cache) {
+  auto builder = std::make_unique<mp::db_builder>(db_fname(), kTestDbMaxSize);
+
+  auto [id1, h1] = add_feature(*builder, {0, 1});
+  auto [id2, h2] = add_feature(*builder, {2, 3});
+
+  add_seq(*builder, 0UL, {{id1}}, {{h1}});
+  add_seq(*builder, 1UL, {{-id2}}, {{h2}});
+
+  builder->finish();
+  builder.reset();
+
+  auto db = mp::make_path_database(db_fname(), true, false, kTestDbMaxSize);
+
+  auto const query = [&](mp::path_feature_cache* cache) {
+    mp::path_database_query q{-1, cache};
+    q.add_sequence(0UL);
+    q.add_sequence(1UL);
+    q.execute(*db);
+    return get_batch(q).first->to_json();
+  };
+
+  mp::path_feature_cache cache{2U};
+  auto const uncached = query(nullptr);
+  EXPECT_EQ(uncached, query(&cache));  // fills the cache
+  EXPECT_NE(nullptr, cache.get(static_cast<uint64_t>(id1), -1));
+  EXPECT_NE(nullptr, cache.get(static_cast<uint64_t>(id2), -1));
+  EXPECT_EQ(uncached, query(&cache));  // served from the cache
+}
+
+TEST(path_feature_cache, evicts_least_recently_used) {
+  tiles::fixed_polyline line;
+  line.emplace_back();
+  line.back().emplace_back(tiles::fixed_xy{1, 2});
+
+  mp::path_feature_cache cache{2U};
+  EXPECT_EQ(nullptr, cache.get(1U, 10));
+
+  cache.put(1U, 10, line);
+  cache.put(1U, 11, line);  // same feature, other zoom level: own entry
+  ASSERT_NE(nullptr, cache.get(1U, 10));
+  EXPECT_TRUE(
+      mpark::holds_alternative<tiles::fixed_polyline>(*cache.get(1U, 10)));
+
+  cache.put(2U, 10, line);  // evicts (1, 11)
+  EXPECT_NE(nullptr, cache.get(1U, 10));
+  EXPECT_EQ(nullptr, cache.get(1U, 11));
+  EXPECT_NE(nullptr, cache.get(2U, 10));
+
+  mp::path_feature_cache disabled{0U};
+  disabled.put(1U, 10, line);
+  EXPECT_EQ(nullptr, disabled.get(1U, 10));
+}
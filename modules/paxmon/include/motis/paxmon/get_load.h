@@ -194,13 +194,24 @@ inline pax_pdf get_load_pdf(passenger_group_container const& pgc,
 #endif
 }
 
+pax_cdf get_cdf(pax_pdf const& pdf);
+
 template <typename Groups>
 inline pax_cdf get_load_cdf(passenger_group_container const& pgc,
                             Groups const& groups) {
   return get_cdf(get_load_pdf(pgc, groups));
 }
 
-pax_cdf get_cdf(pax_pdf const& pdf);
+// Cached versions: see load_pdf_cache_entry in pci_container.h.
+pax_pdf get_load_pdf(passenger_group_container const& pgc,
+                     pci_container const& pcis, pci_index idx);
+pax_pdf get_load_pdf(universe const& uv, pci_index idx);
+pax_cdf get_load_cdf(universe const& uv, pci_index idx);
+
+void add_group_to_load_pdf(pci_container& pcis, pci_index idx,
+                           passenger_group const* grp);
+void remove_group_from_load_pdf(pci_container& pcis, pci_index idx,
+                                passenger_group const* grp);
 
 template <typename Groups>
 inline std::uint16_t get_mean_load(passenger_group_container const& pgc,
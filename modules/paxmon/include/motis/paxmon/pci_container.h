@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <mutex>
+#include <vector>
 
 #include "utl/verify.h"
 
@@ -20,21 +22,59 @@ using pci_groups = dynamic_fws_multimap<passenger_group_index>::const_bucket;
 using mutable_pci_groups =
     dynamic_fws_multimap<passenger_group_index>::mutable_bucket;
 
+// Cached load distribution of a pci (see get_load.h).
+// Invalid entries are filled lazily by readers, valid entries are
+// updated incrementally when groups are added to or removed from the edge.
+struct load_pdf_cache_entry {
+  load_pdf_cache_entry() = default;
+  ~load_pdf_cache_entry() = default;
+
+  load_pdf_cache_entry(load_pdf_cache_entry const& o)
+      : pdf_{o.pdf_}, valid_{o.valid_.load()}, updates_{o.updates_} {}
+
+  load_pdf_cache_entry(load_pdf_cache_entry&& o) noexcept
+      : pdf_{std::move(o.pdf_)}, valid_{o.valid_.load()}, updates_{o.updates_} {}
+
+  load_pdf_cache_entry& operator=(load_pdf_cache_entry const& o) {
+    if (this != &o) {
+      pdf_ = o.pdf_;
+      valid_ = o.valid_.load();
+      updates_ = o.updates_;
+    }
+    return *this;
+  }
+
+  load_pdf_cache_entry& operator=(load_pdf_cache_entry&& o) noexcept {
+    pdf_ = std::move(o.pdf_);
+    valid_ = o.valid_.load();
+    updates_ = o.updates_;
+    return *this;
+  }
+
+  std::vector<float> pdf_;
+  std::atomic_bool valid_{false};
+  std::uint32_t updates_{};
+};
+
 struct pci_container {
   pci_container() = default;
   ~pci_container() = default;
 
   pci_container(pci_container const& c)
-      : groups_{c.groups_}, expected_load_{c.expected_load_} {}
+      : groups_{c.groups_},
+        expected_load_{c.expected_load_},
+        load_pdf_{c.load_pdf_} {}
 
   pci_container(pci_container&& c) noexcept
       : groups_{std::move(c.groups_)},
-        expected_load_{std::move(c.expected_load_)} {}
+        expected_load_{std::move(c.expected_load_)},
+        load_pdf_{std::move(c.load_pdf_)} {}
 
   pci_container& operator=(pci_container const& c) {
     if (this != &c) {
       groups_ = c.groups_;
       expected_load_ = c.expected_load_;
+      load_pdf_ = c.load_pdf_;
     }
     return *this;
   }
@@ -42,16 +82,24 @@ struct pci_container {
   pci_container& operator=(pci_container&& c) noexcept {
     groups_ = std::move(c.groups_);
     expected_load_ = std::move(c.expected_load_);
+    load_pdf_ = std::move(c.load_pdf_);
     return *this;
   }
 
   pci_index insert() {
     auto const idx = static_cast<pci_index>(expected_load_.size());
     expected_load_.push_back(0U);
+    load_pdf_.emplace_back();
     groups_[idx];
     return idx;
   }
 
+  void invalidate_load_pdf(pci_index const idx) {
+    if (idx < load_pdf_.size()) {
+      load_pdf_[idx].valid_ = false;
+    }
+  }
+
   void init_expected_load(passenger_group_container const& pgc,
                           pci_index const idx) {
     auto expected = std::uint16_t{};
@@ -81,6 +129,8 @@ struct pci_container {
 
   dynamic_fws_multimap<passenger_group_index> groups_;
   mcd::vector<std::uint16_t> expected_load_;
+  mutable std::vector<load_pdf_cache_entry> load_pdf_;
+  mutable std::mutex load_pdf_mutex_;
   std::mutex mutex_;
 };
 
@@ -73,6 +73,10 @@ struct tick_statistics {
   std::uint64_t t_fbs_events_{};
   std::uint64_t t_publish_{};
   std::uint64_t t_rt_updates_applied_total_{};
+
+  // monitoring event serialization
+  std::uint64_t fbs_workers_{};
+  std::uint64_t t_fbs_lock_wait_us_{};
 };
 
 struct graph_statistics {
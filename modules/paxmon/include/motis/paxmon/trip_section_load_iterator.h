@@ -64,10 +64,7 @@ struct trip_section_with_load {
   }
 
   pax_pdf load_pdf() const {
-    return edge_ != nullptr
-               ? get_load_pdf(uv_.passenger_groups_,
-                              uv_.pax_connection_info_.groups_[edge_->pci_])
-               : pax_pdf{};
+    return edge_ != nullptr ? get_load_pdf(uv_, edge_->pci_) : pax_pdf{};
   }
 
   pax_cdf load_cdf() const { return get_cdf(load_pdf()); }
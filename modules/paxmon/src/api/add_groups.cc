@@ -55,6 +55,10 @@ msg_ptr add_groups(paxmon_data& data, bool const allow_reuse,
                 uv.update_tracker_.before_group_reused(existing_pg);
                 existing_pg->probability_ = std::min(
                     1.F, existing_pg->probability_ + input_pg.probability_);
+                for (auto const& ei : existing_pg->edges_) {
+                  uv.pax_connection_info_.invalidate_load_pdf(
+                      ei.get(uv)->pci_);
+                }
                 ++reused_groups;
                 uv.update_tracker_.after_group_reused(existing_pg);
                 return existing_pg;
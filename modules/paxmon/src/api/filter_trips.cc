@@ -136,7 +136,7 @@ msg_ptr filter_trips(paxmon_data& data, msg_ptr const& msg) {
         continue;
       }
       auto const groups = uv.pax_connection_info_.groups_[e->pci_];
-      auto const pdf = get_load_pdf(uv.passenger_groups_, groups);
+      auto const pdf = get_load_pdf(uv, e->pci_);
       auto const cdf = get_cdf(pdf);
       auto const capacity = e->capacity();
       auto const pax_limits = get_pax_limits(uv.passenger_groups_, groups);
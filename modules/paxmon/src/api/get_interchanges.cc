@@ -106,8 +106,7 @@ msg_ptr get_interchanges(paxmon_data& data, msg_ptr const& msg) {
                   [](PaxMonGroupBaseInfo const& a,
                      PaxMonGroupBaseInfo const& b) { return a.id() < b.id(); });
       }
-      auto const pdf = get_load_pdf(
-          uv.passenger_groups_, uv.pax_connection_info_.groups_[ic_edge->pci_]);
+      auto const pdf = get_load_pdf(uv, ic_edge->pci_);
       auto const cdf = get_cdf(pdf);
 
       interchange_infos.emplace_back(CreatePaxMonInterchangeInfo(
@@ -3,6 +3,8 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
+#include <mutex>
 #include <numeric>
 
 #include "utl/enumerate.h"
@@ -73,6 +75,145 @@ pax_cdf get_cdf(pax_pdf const& pdf) {
   return cdf;
 }
 
+// Incremental updates accumulate rounding errors, recompute from scratch
+// after this many updates.
+constexpr auto const MAX_INCREMENTAL_LOAD_PDF_UPDATES = 256U;
+constexpr auto const MAX_LOAD_PDF_ERROR = 1E-4F;
+constexpr auto const MAX_LOAD_PDF_SUM_ERROR = 1E-3F;
+
+pax_pdf get_load_pdf(passenger_group_container const& pgc,
+                     pci_container const& pcis, pci_index const idx) {
+  if (idx >= pcis.load_pdf_.size()) {
+    return get_load_pdf(pgc, pcis.groups_[idx]);
+  }
+
+  auto& entry = pcis.load_pdf_[idx];
+  if (entry.valid_.load(std::memory_order_acquire)) {
+    return pax_pdf{entry.pdf_};
+  }
+
+  auto pdf = get_load_pdf(pgc, pcis.groups_[idx]);
+  std::lock_guard const lock{pcis.load_pdf_mutex_};
+  if (!entry.valid_.load(std::memory_order_relaxed)) {
+    entry.pdf_ = pdf.data_;
+    entry.updates_ = 0U;
+    entry.valid_.store(true, std::memory_order_release);
+  }
+  return pdf;
+}
+
+pax_pdf get_load_pdf(universe const& uv, pci_index const idx) {
+  return get_load_pdf(uv.passenger_groups_, uv.pax_connection_info_, idx);
+}
+
+pax_cdf get_load_cdf(universe const& uv, pci_index const idx) {
+  return get_cdf(get_load_pdf(uv, idx));
+}
+
+bool is_valid_pdf(std::vector<float> const& pdf) {
+  auto sum = 0.0F;
+  for (auto const prob : pdf) {
+    if (prob < -MAX_LOAD_PDF_ERROR) {
+      return false;
+    }
+    sum += prob;
+  }
+  return std::abs(sum - 1.0F) <= MAX_LOAD_PDF_SUM_ERROR;
+}
+
+// Inverse of convolve_base: pdf[x] = (1 - p) * old[x] + p * old[x - s].
+// Solved bottom-up for p <= 0.5 and top-down otherwise to avoid dividing
+// by small numbers.
+bool deconvolve(std::vector<float>& pdf, std::uint16_t const grp_size,
+                float const grp_prob) {
+  if (grp_size == 0U) {
+    return true;
+  }
+  if (pdf.size() <= grp_size) {
+    return false;
+  }
+  auto const old_size = pdf.size() - grp_size;
+  auto old_pdf = std::vector<float>(old_size);
+  if (grp_prob <= 0.5F) {
+    auto const inv_grp_prob = 1.0F - grp_prob;
+    for (auto x = 0ULL; x < old_size; ++x) {
+      auto prob = pdf[x];
+      if (x >= grp_size) {
+        prob -= grp_prob * old_pdf[x - grp_size];
+      }
+      old_pdf[x] = prob / inv_grp_prob;
+    }
+  } else {
+    auto const inv_grp_prob = 1.0F - grp_prob;
+    for (auto x = pdf.size() - 1; x >= grp_size; --x) {
+      auto prob = pdf[x];
+      if (x < old_size) {
+        prob -= inv_grp_prob * old_pdf[x];
+      }
+      old_pdf[x - grp_size] = prob / grp_prob;
+    }
+  }
+  if (!is_valid_pdf(old_pdf)) {
+    return false;
+  }
+  for (auto& prob : old_pdf) {
+    prob = std::max(prob, 0.0F);
+  }
+  pdf = std::move(old_pdf);
+  return true;
+}
+
+load_pdf_cache_entry* get_updatable_entry(pci_container& pcis,
+                                          pci_index const idx) {
+  if (idx >= pcis.load_pdf_.size()) {
+    return nullptr;
+  }
+  auto& entry = pcis.load_pdf_[idx];
+  if (!entry.valid_) {
+    return nullptr;
+  }
+  if (++entry.updates_ > MAX_INCREMENTAL_LOAD_PDF_UPDATES) {
+    entry.valid_ = false;
+    return nullptr;
+  }
+  return &entry;
+}
+
+void add_group_to_load_pdf(pci_container& pcis, pci_index const idx,
+                           passenger_group const* grp) {
+  auto* entry = get_updatable_entry(pcis, idx);
+  if (entry == nullptr || grp->probability_ == 0.0F) {
+    return;
+  }
+  auto& data = entry->pdf_;
+  if (grp->probability_ == 1.0F) {
+    data.insert(begin(data), grp->passengers_, 0.0F);
+  } else {
+    auto pdf = pax_pdf{std::move(data)};
+    pdf.data_.resize(pdf.data_.size() + grp->passengers_);
+    convolve_base(pdf, grp->passengers_, grp->probability_);
+    data = std::move(pdf.data_);
+  }
+}
+
+void remove_group_from_load_pdf(pci_container& pcis, pci_index const idx,
+                                passenger_group const* grp) {
+  auto* entry = get_updatable_entry(pcis, idx);
+  if (entry == nullptr || grp->probability_ == 0.0F) {
+    return;
+  }
+  auto& data = entry->pdf_;
+  if (grp->probability_ == 1.0F) {
+    if (data.size() > grp->passengers_) {
+      data.erase(begin(data), std::next(begin(data), grp->passengers_));
+    } else {
+      entry->valid_ = false;
+    }
+  } else if (!deconvolve(data, grp->passengers_, grp->probability_)) {
+    entry->valid_ = false;
+  }
+}
+
 template <typename T>
 lf_df_t to_load_factor_impl(T const& df, std::uint16_t capacity) {
   auto lf_df = std::map<float, float>{};
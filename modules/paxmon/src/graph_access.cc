@@ -21,6 +21,7 @@
 #include "motis/core/conv/trip_conv.h"
 
 #include "motis/paxmon/capacity.h"
+#include "motis/paxmon/get_load.h"
 #include "motis/paxmon/graph_index.h"
 #include "motis/paxmon/reroute.h"
 
@@ -298,6 +299,7 @@ void add_passenger_group_to_edge(universe& uv, edge* e, passenger_group* pg) {
   auto it = std::lower_bound(begin(groups), end(groups), pg->id_);
   if (it == end(groups) || *it != pg->id_) {
     groups.insert(it, pg->id_);
+    add_group_to_load_pdf(uv.pax_connection_info_, e->pci_, pg);
   }
 }
 
@@ -307,6 +309,7 @@ void remove_passenger_group_from_edge(universe& uv, edge* e,
   auto it = std::lower_bound(begin(groups), end(groups), pg->id_);
   if (it != end(groups) && *it == pg->id_) {
     groups.erase(it);
+    remove_group_from_load_pdf(uv.pax_connection_info_, e->pci_, pg);
   }
 }
 
@@ -202,6 +202,7 @@ std::set<passenger_group*> collect_passenger_groups(universe& uv,
       utl::erase(pg->edges_, tei);
     }
     groups.clear();
+    uv.pax_connection_info_.invalidate_load_pdf(te->pci_);
   }
   return affected_passenger_groups;
 }
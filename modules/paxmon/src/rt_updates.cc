@@ -1,7 +1,11 @@
 #include "motis/paxmon/rt_updates.h"
 
+#include <algorithm>
+#include <iterator>
+#include <mutex>
 #include <numeric>
 #include <set>
+#include <thread>
 
 #include "utl/verify.h"
 
@@ -175,116 +179,159 @@ std::vector<msg_ptr> update_affected_groups(universe& uv, schedule const& sched,
       uv.rt_update_ctx_.groups_affected_by_last_update_.size();
   uv.tick_stats_.affected_passengers_ = affected_passenger_count;
 
-  message_creator mc;
-  std::vector<flatbuffers::Offset<PaxMonEvent>> fbs_events;
+  // Each worker serializes its own events into a separate message creator,
+  // only the final merge of the worker results is synchronized.
+  struct update_worker {
+    void make_monitoring_msg(universe const& uv) {
+      if (fbs_events_.empty()) {
+        return;
+      }
+      mc_.create_and_finish(
+          MsgContent_PaxMonUpdate,
+          CreatePaxMonUpdate(mc_, uv.id_, mc_.CreateVector(fbs_events_))
+              .Union(),
+          "/paxmon/monitoring_update");
+      messages_.emplace_back(make_msg(mc_));
+      fbs_events_.clear();
+      mc_.Clear();
+    }
+
+    message_creator mc_;
+    std::vector<flatbuffers::Offset<PaxMonEvent>> fbs_events_;
+    std::vector<msg_ptr> messages_;
+    std::uint64_t events_{};
+    tick_statistics stats_;
+    std::uint64_t t_reachability_{}, t_localization_{}, t_update_load_{},
+        t_fbs_events_{};
+  };
+
+  auto const affected_groups = std::vector<passenger_group_index>(
+      begin(uv.rt_update_ctx_.groups_affected_by_last_update_),
+      end(uv.rt_update_ctx_.groups_affected_by_last_update_));
+  auto const max_workers =
+      std::size_t{4} * std::max(1U, std::thread::hardware_concurrency());
+  auto const worker_count =
+      std::clamp(affected_groups.size() / 256, std::size_t{1}, max_workers);
+  auto const chunk_size =
+      (affected_groups.size() + worker_count - 1) / worker_count;
+  auto workers = std::vector<std::size_t>(worker_count);
+  std::iota(begin(workers), end(workers), 0U);
+
+  std::mutex merge_mutex;
   std::vector<msg_ptr> messages;
+  auto total = update_worker{};
+  auto lock_wait = 0ULL;
 
-  std::mutex update_mutex;
-  auto total_reachability = 0ULL;
-  auto total_localization = 0ULL;
-  auto total_update_load = 0ULL;
-  auto total_fbs_events = 0ULL;
+  motis_parallel_for(workers, [&](auto const worker_idx) {
+    auto w = update_worker{};
+    auto const chunk_begin = worker_idx * chunk_size;
+    auto const chunk_end =
+        std::min(chunk_begin + chunk_size, affected_groups.size());
+    for (auto i = chunk_begin; i < chunk_end; ++i) {
+      auto const& pg = uv.passenger_groups_.at(affected_groups[i]);
+      MOTIS_START_TIMING(reachability);
+      auto const reachability =
+          get_reachability(uv, pg->compact_planned_journey_);
+      pg->ok_ = reachability.ok_;
+      if (reachability.ok_) {
+        pg->estimated_delay_ = static_cast<std::int16_t>(
+            static_cast<int>(
+                reachability.reachable_trips_.back().exit_real_time_) -
+            static_cast<int>(pg->planned_arrival_time_));
+      }
+      MOTIS_STOP_TIMING(reachability);
 
-  auto const print_timing = [&]() {
-    if (fbs_events.empty()) {
-      return;
-    }
-    LOG(info) << "update groups timing: reachability "
-              << (total_reachability / 1000) << "ms, localization "
-              << (total_localization / 1000) << "ms, update_load "
-              << (total_update_load / 1000) << "ms, fbs_events "
-              << (total_fbs_events / 1000) << "ms, " << fbs_events.size()
-              << " events";
-  };
+      MOTIS_START_TIMING(localization);
+      auto const localization = localize(sched, reachability, search_time);
+      MOTIS_STOP_TIMING(localization);
 
-  auto const make_monitoring_msg = [&]() {
-    if (fbs_events.empty()) {
-      return;
-    }
-    mc.create_and_finish(
-        MsgContent_PaxMonUpdate,
-        CreatePaxMonUpdate(mc, uv.id_, mc.CreateVector(fbs_events)).Union(),
-        "/paxmon/monitoring_update");
-    messages.emplace_back(make_msg(mc));
-    fbs_events.clear();
-    mc.Clear();
-  };
+      auto const event_type = get_monitoring_event_type(
+          pg, reachability, arrival_delay_threshold);
+      auto const expected_arrival_time =
+          event_type == monitoring_event_type::TRANSFER_BROKEN
+              ? INVALID_TIME
+              : reachability.reachable_trips_.back().exit_real_time_;
 
-  motis_parallel_for(
-      uv.rt_update_ctx_.groups_affected_by_last_update_, [&](auto const pgi) {
-        auto const& pg = uv.passenger_groups_.at(pgi);
-        MOTIS_START_TIMING(reachability);
-        auto const reachability =
-            get_reachability(uv, pg->compact_planned_journey_);
-        pg->ok_ = reachability.ok_;
-        if (reachability.ok_) {
-          pg->estimated_delay_ = static_cast<std::int16_t>(
-              static_cast<int>(
-                  reachability.reachable_trips_.back().exit_real_time_) -
-              static_cast<int>(pg->planned_arrival_time_));
-        }
-        MOTIS_STOP_TIMING(reachability);
-
-        MOTIS_START_TIMING(localization);
-        auto const localization = localize(sched, reachability, search_time);
-        MOTIS_STOP_TIMING(localization);
-
-        auto const event_type = get_monitoring_event_type(
-            pg, reachability, arrival_delay_threshold);
-        auto const expected_arrival_time =
-            event_type == monitoring_event_type::TRANSFER_BROKEN
-                ? INVALID_TIME
-                : reachability.reachable_trips_.back().exit_real_time_;
-
-        MOTIS_START_TIMING(update_load);
-        update_load(pg, reachability, localization, uv);
-        MOTIS_STOP_TIMING(update_load);
-
-        MOTIS_START_TIMING(fbs_events);
-        std::lock_guard guard{update_mutex};
-        fbs_events.emplace_back(to_fbs(
-            sched, mc,
-            monitoring_event{event_type, *pg, localization,
-                             reachability.status_, expected_arrival_time}));
-        if (fbs_events.size() >= 10'000) {
-          make_monitoring_msg();
-        }
-        MOTIS_STOP_TIMING(fbs_events);
+      MOTIS_START_TIMING(update_load);
+      update_load(pg, reachability, localization, uv);
+      MOTIS_STOP_TIMING(update_load);
 
-        total_reachability += MOTIS_TIMING_US(reachability);
-        total_localization += MOTIS_TIMING_US(localization);
-        total_update_load += MOTIS_TIMING_US(update_load);
-        total_fbs_events += MOTIS_TIMING_US(fbs_events);
+      MOTIS_START_TIMING(fbs_events);
+      w.fbs_events_.emplace_back(to_fbs(
+          sched, w.mc_,
+          monitoring_event{event_type, *pg, localization,
+                           reachability.status_, expected_arrival_time}));
+      ++w.events_;
+      if (w.fbs_events_.size() >= 10'000) {
+        w.make_monitoring_msg(uv);
+      }
+      MOTIS_STOP_TIMING(fbs_events);
 
-        if (fbs_events.size() % 10000 == 0) {
-          print_timing();
-        }
+      w.t_reachability_ += MOTIS_TIMING_US(reachability);
+      w.t_localization_ += MOTIS_TIMING_US(localization);
+      w.t_update_load_ += MOTIS_TIMING_US(update_load);
+      w.t_fbs_events_ += MOTIS_TIMING_US(fbs_events);
 
-        switch (event_type) {
-          case monitoring_event_type::NO_PROBLEM:
-            ++uv.tick_stats_.ok_groups_;
-            ++uv.system_stats_.groups_ok_count_;
-            break;
-          case monitoring_event_type::TRANSFER_BROKEN:
-            ++uv.tick_stats_.broken_groups_;
-            ++uv.system_stats_.groups_broken_count_;
-            uv.tick_stats_.broken_passengers_ += pg->passengers_;
-            break;
-          case monitoring_event_type::MAJOR_DELAY_EXPECTED:
-            ++uv.tick_stats_.major_delay_groups_;
-            ++uv.system_stats_.groups_major_delay_count_;
-            uv.tick_stats_.major_delay_passengers_ += pg->passengers_;
-            break;
-        }
-      });
+      switch (event_type) {
+        case monitoring_event_type::NO_PROBLEM: ++w.stats_.ok_groups_; break;
+        case monitoring_event_type::TRANSFER_BROKEN:
+          ++w.stats_.broken_groups_;
+          w.stats_.broken_passengers_ += pg->passengers_;
+          break;
+        case monitoring_event_type::MAJOR_DELAY_EXPECTED:
+          ++w.stats_.major_delay_groups_;
+          w.stats_.major_delay_passengers_ += pg->passengers_;
+          break;
+      }
+    }
+    w.make_monitoring_msg(uv);
+
+    MOTIS_START_TIMING(merge_wait);
+    std::lock_guard guard{merge_mutex};
+    MOTIS_STOP_TIMING(merge_wait);
+    lock_wait += MOTIS_TIMING_US(merge_wait);
+
+    std::move(begin(w.messages_), end(w.messages_),
+              std::back_inserter(messages));
+    total.events_ += w.events_;
+    total.stats_.ok_groups_ += w.stats_.ok_groups_;
+    total.stats_.broken_groups_ += w.stats_.broken_groups_;
+    total.stats_.broken_passengers_ += w.stats_.broken_passengers_;
+    total.stats_.major_delay_groups_ += w.stats_.major_delay_groups_;
+    total.stats_.major_delay_passengers_ += w.stats_.major_delay_passengers_;
+    total.t_reachability_ += w.t_reachability_;
+    total.t_localization_ += w.t_localization_;
+    total.t_update_load_ += w.t_update_load_;
+    total.t_fbs_events_ += w.t_fbs_events_;
+  });
+
+  if (total.events_ != 0U) {
+    LOG(info) << "update groups timing: reachability "
+              << (total.t_reachability_ / 1000) << "ms, localization "
+              << (total.t_localization_ / 1000) << "ms, update_load "
+              << (total.t_update_load_ / 1000) << "ms, fbs_events "
+              << (total.t_fbs_events_ / 1000) << "ms, " << total.events_
+              << " events, " << worker_count << " workers, lock wait "
+              << lock_wait << "us";
+  }
 
-  print_timing();
-  make_monitoring_msg();
+  uv.tick_stats_.ok_groups_ += total.stats_.ok_groups_;
+  uv.tick_stats_.broken_groups_ += total.stats_.broken_groups_;
+  uv.tick_stats_.broken_passengers_ += total.stats_.broken_passengers_;
+  uv.tick_stats_.major_delay_groups_ += total.stats_.major_delay_groups_;
+  uv.tick_stats_.major_delay_passengers_ +=
+      total.stats_.major_delay_passengers_;
+  uv.system_stats_.groups_ok_count_ += total.stats_.ok_groups_;
+  uv.system_stats_.groups_broken_count_ += total.stats_.broken_groups_;
+  uv.system_stats_.groups_major_delay_count_ +=
+      total.stats_.major_delay_groups_;
 
-  uv.tick_stats_.t_reachability_ = total_reachability / 1000;
-  uv.tick_stats_.t_localization_ = total_localization / 1000;
-  uv.tick_stats_.t_update_load_ = total_update_load / 1000;
-  uv.tick_stats_.t_fbs_events_ = total_fbs_events / 1000;
+  uv.tick_stats_.t_reachability_ = total.t_reachability_ / 1000;
+  uv.tick_stats_.t_localization_ = total.t_localization_ / 1000;
+  uv.tick_stats_.t_update_load_ = total.t_update_load_ / 1000;
+  uv.tick_stats_.t_fbs_events_ = total.t_fbs_events_ / 1000;
+  uv.tick_stats_.t_fbs_lock_wait_us_ = lock_wait;
+  uv.tick_stats_.fbs_workers_ = worker_count;
 
   return messages;
 }
@@ -46,6 +46,9 @@ void stats_writer::write_header() {
        << "t_publish"
        << "t_rt_updates_applied_total"
        //
+       << "fbs_workers"
+       << "t_fbs_lock_wait_us"
+       //
        << end_row;
 }
 
@@ -75,6 +78,8 @@ void stats_writer::write_tick(const tick_statistics& ts) {
        << ts.t_fbs_events_ << ts.t_publish_
        << ts.t_rt_updates_applied_total_
        //
+       << ts.fbs_workers_ << ts.t_fbs_lock_wait_us_
+       //
        << end_row;
 }
 
@@ -1,6 +1,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <initializer_list>
@@ -202,6 +203,50 @@ TEST(paxmon_get_load, two_groups) {
   EXPECT_EQ(get_median_load(get_cdf(pdf)), 10);
 }
 
+TEST(paxmon_get_load, incremental_pdf_cache) {
+  auto gen = std::mt19937{std::random_device{}()};
+  auto group_size_dist = std::uniform_int_distribution<std::uint16_t>{1, 8};
+  auto prob_dist = std::uniform_real_distribution<float>{0.0F, 1.0F};
+  auto certain_dist = std::bernoulli_distribution{0.3};
+
+  auto pgc = passenger_group_container{};
+  pgc.reserve(200);
+  for (auto grp = 0; grp < 200; ++grp) {
+    pgc.add(mk_pg(group_size_dist(gen),
+                  certain_dist(gen) ? 1.0F : prob_dist(gen)));
+  }
+
+  auto pcis = pci_container{};
+  auto const idx = pcis.insert();
+  auto groups = pcis.groups_[idx];
+  for (auto grp = 0U; grp < 100U; ++grp) {
+    groups.emplace_back(pgc[grp]->id_);
+  }
+
+  auto const check = [&]() {
+    auto const cached = get_load_pdf(pgc, pcis, idx);
+    auto const full = get_load_pdf_base(pgc, pcis.groups_[idx]);
+    ASSERT_THAT(cached.data_, Pointwise(FloatNear(1E-4F), full.data_));
+  };
+
+  check();
+  ASSERT_TRUE(pcis.load_pdf_[idx].valid_);
+
+  for (auto grp = 100U; grp < 200U; ++grp) {
+    auto const* pg = pgc[grp];
+    groups.emplace_back(pg->id_);
+    add_group_to_load_pdf(pcis, idx, pg);
+  }
+  check();
+
+  for (auto grp = 0U; grp < 150U; ++grp) {
+    auto const* pg = pgc[grp];
+    groups.erase(std::find(begin(groups), end(groups), pg->id_));
+    remove_group_from_load_pdf(pcis, idx, pg);
+  }
+  check();
+}
+
 #ifdef MOTIS_AVX2
 TEST(paxmon_get_load, base_eq_avx) {
   auto gen = std::mt19937{std::random_device{}()};
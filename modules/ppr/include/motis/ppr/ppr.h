@@ -1,12 +1,16 @@
 #pragma once
 
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "boost/filesystem/path.hpp"
+
 #include "motis/module/module.h"
 
 #include "motis/ppr/profile_info.h"
+#include "motis/ppr/rtree_state.h"
 
 namespace motis::ppr {
 
@@ -30,6 +34,13 @@ struct ppr : public motis::module::module {
 private:
   std::string graph_file() const;
 
+  std::vector<std::string> rtree_files() const;
+  boost::filesystem::path rtree_state_file() const;
+  rtree_state const& current_rtree_state() const;  // computed once
+  bool prebuilt_rtrees_available() const;
+  void remove_rtrees() const;
+  void build_rtrees() const;
+
   std::vector<std::string> profile_files_;
   std::size_t edge_rtree_max_size_{sizeof(void*) >= 8 ? 1024UL * 1024 * 1024 * 3
                                                       : 256 * 1024 * 124};
@@ -38,9 +49,14 @@ private:
   bool lock_rtrees_{false};
   bool prefetch_rtrees_{true};
   bool verify_graph_{false};
+  bool prebuilt_rtrees_{true};
+  std::size_t cache_size_{0U};  // bytes, off by default
+  double cache_snap_radius_{5.0};
 
   bool use_dem_{false};
 
+  mutable std::optional<rtree_state> current_rtree_state_;
+
   struct impl;
   std::unique_ptr<impl> impl_;
   bool import_successful_{false};
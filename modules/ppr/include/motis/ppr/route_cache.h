@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cinttypes>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ppr/routing/search.h"
+
+#include "motis/core/common/lru_cache.h"
+#include "motis/core/statistics/statistics.h"
+
+namespace motis::ppr {
+
+// Grid cell of a snapped coordinate: (lat cell << 32) | lng cell.
+using cell_t = uint64_t;
+
+struct route_cache_key {
+  friend bool operator==(route_cache_key const& a, route_cache_key const& b) {
+    return a.profile_ == b.profile_ && a.duration_limit_ == b.duration_limit_ &&
+           a.dir_ == b.dir_ && a.start_ == b.start_ &&
+           a.destinations_ == b.destinations_;
+  }
+
+  std::string profile_;
+  double duration_limit_{};
+  ::ppr::routing::search_direction dir_{};
+  cell_t start_{};
+  std::vector<cell_t> destinations_;  // request order
+};
+
+// LRU cache of foot routing results, bounded by their (estimated) size in
+// bytes. Start and destinations are snapped to a grid, i.e. nearby requests
+// (e.g. from intermodal and parking for the same station) share results.
+// This is an approximation: a hit returns the routes computed for the first
+// request of the grid cell unchanged (positions, distances and durations may
+// be off by up to the cell diagonal). Disabled by default (max_bytes = 0).
+struct route_cache {
+  using entry_ptr = std::shared_ptr<::ppr::routing::search_result const>;
+
+  route_cache(double snap_radius, std::size_t max_bytes);
+
+  route_cache_key make_key(std::string profile, double duration_limit,
+                           ::ppr::routing::search_direction,
+                           ::ppr::location const& start,
+                           std::vector<::ppr::location> const& destinations)
+      const;
+
+  entry_ptr get(route_cache_key const&);
+  void put(route_cache_key const&, entry_ptr);
+
+  bool enabled() const { return cache_.capacity() != 0U; }
+
+  stats_category get_stats() const;
+
+  cell_t snap(::ppr::location const&) const;
+
+  struct result_size {
+    std::size_t operator()(entry_ptr const&) const;
+  };
+
+private:
+  struct key_hash {
+    std::size_t operator()(route_cache_key const&) const;
+  };
+
+  double cell_size_deg_;
+  lru_cache<route_cache_key, entry_ptr, result_size, key_hash> cache_;
+};
+
+}  // namespace motis::ppr
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cinttypes>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "cista/hash.h"
+#include "cista/reflection/comparable.h"
+
+#include "motis/module/ini_io.h"
+
+namespace motis::ppr {
+
+// Prebuilt r-trees (memory mapped files next to the routing graph).
+struct rtree_state {
+  CISTA_COMPARABLE()
+  module::named<cista::hash_t, MOTIS_NAME("graph_hash")> graph_hash_;
+  module::named<std::size_t, MOTIS_NAME("graph_size")> graph_size_;
+  module::named<std::size_t, MOTIS_NAME("edge_rtree_max_size")>
+      edge_rtree_max_size_;
+  module::named<std::size_t, MOTIS_NAME("area_rtree_max_size")>
+      area_rtree_max_size_;
+};
+
+// Hash of the first 50MB and size of the routing graph file.
+std::pair<cista::hash_t, std::size_t> graph_file_hash(std::string const& path);
+
+// Prebuilt r-trees can be used if all r-tree files exist and the state
+// stored with them (rtrees.ini) matches the current state.
+bool rtrees_up_to_date(std::vector<std::string> const& rtree_files,
+                       boost::filesystem::path const& state_file,
+                       rtree_state const& current);
+
+}  // namespace motis::ppr
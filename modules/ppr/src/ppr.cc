@@ -1,13 +1,18 @@
 #include "motis/ppr/ppr.h"
 
+#include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <limits>
 #include <map>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 #include "boost/filesystem.hpp"
 
 #include "cista/hash.h"
-#include "cista/mmap.h"
 
 #include "utl/progress_tracker.h"
 #include "utl/to_vec.h"
@@ -21,12 +26,15 @@
 #include "ppr/serialization/reader.h"
 
 #include "motis/core/common/logging.h"
+#include "motis/core/common/timing.h"
 #include "motis/core/schedule/time.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/ini_io.h"
 
 #include "motis/ppr/error.h"
 #include "motis/ppr/profiles.h"
+#include "motis/ppr/route_cache.h"
+#include "motis/ppr/rtree_state.h"
 
 using namespace motis::module;
 using namespace motis::logging;
@@ -49,6 +57,17 @@ struct import_state {
   named<cista::hash_t, MOTIS_NAME("dem_hash")> dem_hash_;
 };
 
+std::size_t resident_memory() {
+#ifdef __linux__
+  auto pages = std::size_t{0U}, resident = std::size_t{0U};
+  std::ifstream statm{"/proc/self/statm"};
+  if (statm >> pages >> resident) {
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0U;
+}
+
 location to_location(Position const* pos) {
   return make_location(pos->lng(), pos->lat());
 }
@@ -133,8 +152,9 @@ struct ppr::impl {
                 std::map<std::string, profile_info>& profiles,
                 std::size_t edge_rtree_max_size,
                 std::size_t area_rtree_max_size, rtree_options rtree_opt,
-                bool verify_routing_graph)
-      : profiles_{profiles} {
+                bool verify_routing_graph, double cache_snap_radius,
+                std::size_t cache_bytes)
+      : profiles_{profiles}, cache_{cache_snap_radius, cache_bytes} {
     {
       scoped_timer timer("loading ppr routing graph");
       read_routing_graph(rg_, rg_path);
@@ -177,7 +197,38 @@ struct ppr::impl {
     return make_msg(fbb);
   }
 
+  msg_ptr cache_stats() const {
+    message_creator fbb;
+    auto stats = std::vector<Offset<Statistics>>{
+        to_fbs(fbb, cache_.get_stats())};
+    fbb.create_and_finish(
+        MsgContent_StatisticsResponse,
+        CreateStatisticsResponse(fbb, fbb.CreateVectorOfSortedTables(&stats))
+            .Union());
+    return make_msg(fbb);
+  }
+
 private:
+  route_cache::entry_ptr find_routes_cached(
+      std::string const& profile_name, search_profile const& profile,
+      location const& start, std::vector<location> const& destinations,
+      search_direction const dir) {
+    if (!cache_.enabled()) {
+      return std::make_shared<search_result const>(
+          find_routes(rg_, start, destinations, profile, dir));
+    }
+
+    auto const key = cache_.make_key(profile_name, profile.duration_limit_,
+                                     dir, start, destinations);
+    if (auto cached = cache_.get(key); cached != nullptr) {
+      return cached;
+    }
+    auto result = std::make_shared<search_result const>(
+        find_routes(rg_, start, destinations, profile, dir));
+    cache_.put(key, result);
+    return result;
+  }
+
   msg_ptr route_normal(msg_ptr const& msg) {
     auto const req = motis_content(FootRoutingRequest, msg);
 
@@ -192,7 +243,9 @@ private:
                          ? search_direction::FWD
                          : search_direction::BWD;
 
-    auto const result = find_routes(rg_, start, destinations, profile, dir);
+    auto const result =
+        find_routes_cached(req->search_options()->profile()->str(), profile,
+                           start, destinations, dir);
 
     message_creator fbb;
     auto const include_steps = req->include_steps();
@@ -202,7 +255,7 @@ private:
         MsgContent_FootRoutingResponse,
         CreateFootRoutingResponse(
             fbb, fbb.CreateVector(utl::to_vec(
-                     result.routes_,
+                     result->routes_,
                      [&](std::vector<struct route> const& rs) {
                        return write_routes(fbb, rs, include_steps,
                                            include_edges, include_path);
@@ -221,18 +274,18 @@ private:
     if (req->max_duration() != 0) {
       profile.duration_limit_ = req->max_duration();
     }
-    auto const result =
-        find_routes(rg_, start, destinations, profile, search_direction::FWD);
+    auto const result = find_routes_cached("", profile, start, destinations,
+                                           search_direction::FWD);
 
     message_creator fbb;
     auto const include_steps = req->include_steps();
     auto const include_edges = false;
     auto const include_path = req->include_path();
-    assert(result.routes_.size() == 1);
+    assert(result->routes_.size() == 1);
     fbb.create_and_finish(
         MsgContent_FootRoutingSimpleResponse,
         CreateFootRoutingSimpleResponse(
-            fbb, fbb.CreateVector(utl::to_vec(result.routes_[0],
+            fbb, fbb.CreateVector(utl::to_vec(result->routes_[0],
                                               [&](struct route const& r) {
                                                 return write_route(
                                                     fbb, r, include_steps,
@@ -258,6 +311,7 @@ private:
 
   routing_graph rg_;
   std::map<std::string, profile_info>& profiles_;
+  route_cache cache_;
 };
 
 ppr::ppr() : module("Foot Routing", "ppr") {
@@ -270,6 +324,14 @@ ppr::ppr() : module("Foot Routing", "ppr") {
   param(lock_rtrees_, "lock-rtrees", "Prefetch and lock r-trees in memory");
   param(prefetch_rtrees_, "prefetch-rtrees", "Prefetch r-trees");
   param(verify_graph_, "verify-graph", "Verify routing graph");
+  param(prebuilt_rtrees_, "prebuilt-rtrees",
+        "Build r-trees during import and map them at startup");
+  param(cache_size_, "cache-size",
+        "Max. size of cached foot routing results in bytes (0=off). Cached "
+        "routes are reused unchanged for all requests with start and "
+        "destinations in the same snapping grid cells");
+  param(cache_snap_radius_, "cache-snap-radius",
+        "Snapping grid size for cached foot routes (meters)");
 }
 
 ppr::~ppr() = default;
@@ -336,23 +398,25 @@ void ppr::import(import_dispatcher& reg) {
                       << "ms" << std::endl;
           };
 
+          current_rtree_state_.reset();  // graph is rewritten
           auto const result = pp::create_routing_data(opt, log);
           utl::verify(result.successful(), result.error_msg_);
           write_ini(dir / "import.ini", state);
         }
         import_successful_ = true;
 
-        progress_tracker->update(100);
-        auto graph_hash = cista::hash_t{};
-        auto graph_size = std::size_t{};
-        {
-          cista::mmap m{graph_file().c_str(), cista::mmap::protection::READ};
-          graph_hash = cista::hash(std::string_view{
-              reinterpret_cast<char const*>(m.begin()),
-              std::min(static_cast<std::size_t>(50 * 1024 * 1024), m.size())});
-          graph_size = m.size();
+        auto const& graph_state = current_rtree_state();
+        if (prebuilt_rtrees_ && !prebuilt_rtrees_available()) {
+          progress_tracker->status("R-Trees");
+          try {
+            build_rtrees();
+          } catch (std::exception const& e) {
+            LOG(logging::warn) << "ppr r-trees not prebuilt: " << e.what();
+          }
         }
 
+        progress_tracker->update(100);
+
         read_profile_files(profile_files_, profiles_);
         auto profiles_hash = cista::BASE_HASH;
         for (auto const& p : profiles_) {
@@ -364,7 +428,8 @@ void ppr::import(import_dispatcher& reg) {
         fbb.create_and_finish(
             MsgContent_PPREvent,
             motis::import::CreatePPREvent(
-                fbb, fbb.CreateString(graph_file()), graph_hash, graph_size,
+                fbb, fbb.CreateString(graph_file()),
+                graph_state.graph_hash_.val(), graph_state.graph_size_.val(),
                 fbb.CreateVector(utl::to_vec(
                     profiles_,
                     [&](auto const& p) {
@@ -395,13 +460,36 @@ void ppr::init(motis::module::registry& reg) {
                                                     : rtree_options::DEFAULT);
 
   try {
+    auto const prebuilt = prebuilt_rtrees_ && prebuilt_rtrees_available();
+    if (!prebuilt) {
+      remove_rtrees();  // stale or unwanted: rebuild from the graph
+    }
+
+    auto const rss_before = resident_memory();
+    MOTIS_START_TIMING(startup);
     impl_ =
         std::make_unique<impl>(graph_file(), profiles_, edge_rtree_max_size_,
-                               area_rtree_max_size_, rtree_opt, verify_graph_);
+                               area_rtree_max_size_, rtree_opt, verify_graph_,
+                               cache_snap_radius_, cache_size_);
+    MOTIS_STOP_TIMING(startup);
+    auto const rss_after = resident_memory();
+    LOG(info) << "ppr startup (" << (prebuilt ? "prebuilt" : "built")
+              << " r-trees): " << MOTIS_TIMING_MS(startup)
+              << "ms, resident memory: +"
+              << (rss_after > rss_before ? rss_after - rss_before : 0U) /
+                     (1024 * 1024)
+              << "MB";
+
+    if (prebuilt_rtrees_ && !prebuilt) {
+      write_ini(rtree_state_file(), current_rtree_state());
+    }
+
     reg.register_op("/ppr/route",
                     [this](msg_ptr const& msg) { return impl_->route(msg); });
     reg.register_op("/ppr/profiles",
                     [this](msg_ptr const&) { return impl_->get_profiles(); });
+    reg.register_op("/ppr/cache_stats",
+                    [this](msg_ptr const&) { return impl_->cache_stats(); });
   } catch (std::exception const& e) {
     LOG(logging::error) << "ppr module not initialized (" << e.what() << ")";
   }
@@ -411,4 +499,46 @@ std::string ppr::graph_file() const {
   return (get_data_directory() / "ppr" / "routing_graph.ppr").generic_string();
 }
 
+std::vector<std::string> ppr::rtree_files() const {
+  return {graph_file() + ".ert", graph_file() + ".art"};
+}
+
+fs::path ppr::rtree_state_file() const {
+  return get_data_directory() / "ppr" / "rtrees.ini";
+}
+
+rtree_state const& ppr::current_rtree_state() const {
+  if (!current_rtree_state_.has_value()) {
+    auto const [graph_hash, graph_size] = graph_file_hash(graph_file());
+    current_rtree_state_ = rtree_state{graph_hash, graph_size,
+                                       edge_rtree_max_size_,
+                                       area_rtree_max_size_};
+  }
+  return *current_rtree_state_;
+}
+
+bool ppr::prebuilt_rtrees_available() const {
+  return rtrees_up_to_date(rtree_files(), rtree_state_file(),
+                           current_rtree_state());
+}
+
+void ppr::remove_rtrees() const {
+  for (auto const& f : rtree_files()) {
+    fs::remove(f);
+  }
+  fs::remove(rtree_state_file());
+}
+
+void ppr::build_rtrees() const {
+  scoped_timer timer("building ppr r-trees");
+  remove_rtrees();
+  {
+    routing_graph rg;
+    read_routing_graph(rg, graph_file());
+    rg.prepare_for_routing(edge_rtree_max_size_, area_rtree_max_size_,
+                           rtree_options::DEFAULT);
+  }
+  write_ini(rtree_state_file(), current_rtree_state());
+}
+
 }  // namespace motis::ppr
@@ -0,0 +1,87 @@
+#include "motis/ppr/route_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cista/hash.h"
+
+namespace motis::ppr {
+
+constexpr auto const kMetersPerDegree = 111'320.0;
+constexpr auto const kMinCellSizeDeg = 1E-7;
+
+route_cache::route_cache(double const snap_radius, std::size_t const max_bytes)
+    : cell_size_deg_{std::max(snap_radius / kMetersPerDegree,
+                              kMinCellSizeDeg)},
+      cache_{max_bytes} {}
+
+std::size_t route_cache::result_size::operator()(
+    entry_ptr const& result) const {
+  if (result == nullptr) {
+    return 0U;
+  }
+  auto size = sizeof(::ppr::routing::search_result);
+  for (auto const& routes : result->routes_) {
+    size += sizeof(routes);
+    for (auto const& r : routes) {
+      size += sizeof(r);
+      for (auto const& e : r.edges_) {
+        size += sizeof(e) + e.path_.size() * sizeof(::ppr::location) +
+                e.name_.size();
+      }
+    }
+  }
+  return size;
+}
+
+cell_t route_cache::snap(::ppr::location const& loc) const {
+  auto const lat_cell =
+      static_cast<uint32_t>(std::floor((loc.lat() + 90.0) / cell_size_deg_));
+  auto const lng_cell =
+      static_cast<uint32_t>(std::floor((loc.lon() + 180.0) / cell_size_deg_));
+  return (static_cast<cell_t>(lat_cell) << 32U) | lng_cell;
+}
+
+route_cache_key route_cache::make_key(
+    std::string profile, double const duration_limit,
+    ::ppr::routing::search_direction const dir, ::ppr::location const& start,
+    std::vector<::ppr::location> const& destinations) const {
+  auto key = route_cache_key{std::move(profile), duration_limit, dir,
+                             snap(start), {}};
+  key.destinations_.reserve(destinations.size());
+  for (auto const& d : destinations) {
+    key.destinations_.emplace_back(snap(d));
+  }
+  return key;
+}
+
+std::size_t route_cache::key_hash::operator()(route_cache_key const& k) const {
+  auto h = cista::hash_combine(cista::hash(std::string_view{k.profile_}),
+                               std::hash<double>{}(k.duration_limit_),
+                               static_cast<unsigned>(k.dir_), k.start_);
+  for (auto const d : k.destinations_) {
+    h = cista::hash_combine(h, d);
+  }
+  return h;
+}
+
+route_cache::entry_ptr route_cache::get(route_cache_key const& key) {
+  return cache_.get(key).value_or(nullptr);
+}
+
+void route_cache::put(route_cache_key const& key, entry_ptr result) {
+  // keeps results computed concurrently by another request
+  cache_.put(key, std::move(result));
+}
+
+stats_category route_cache::get_stats() const {
+  auto const stats = cache_.stats();
+  return stats_category{"ppr.route_cache",
+                        {{"entries", stats.entries_},
+                         {"bytes", stats.size_},
+                         {"hits", stats.hits_},
+                         {"misses", stats.misses_},
+                         {"evictions", stats.evictions_}}};
+}
+
+}  // namespace motis::ppr
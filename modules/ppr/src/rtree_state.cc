@@ -0,0 +1,30 @@
+#include "motis/ppr/rtree_state.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "boost/filesystem.hpp"
+
+#include "cista/mmap.h"
+
+namespace fs = boost::filesystem;
+
+namespace motis::ppr {
+
+std::pair<cista::hash_t, std::size_t> graph_file_hash(std::string const& path) {
+  cista::mmap m{path.c_str(), cista::mmap::protection::READ};
+  return {cista::hash(std::string_view{
+              reinterpret_cast<char const*>(m.begin()),
+              std::min(static_cast<std::size_t>(50 * 1024 * 1024), m.size())}),
+          m.size()};
+}
+
+bool rtrees_up_to_date(std::vector<std::string> const& rtree_files,
+                       fs::path const& state_file,
+                       rtree_state const& current) {
+  return std::all_of(begin(rtree_files), end(rtree_files),
+                     [](auto const& f) { return fs::exists(f); }) &&
+         module::read_ini<rtree_state>(state_file) == current;
+}
+
+}  // namespace motis::ppr
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+#include "motis/ppr/route_cache.h"
+
+using namespace motis::ppr;
+using ::ppr::make_location;
+using ::ppr::routing::search_direction;
+using ::ppr::routing::search_result;
+
+namespace {
+
+route_cache::entry_ptr make_result(std::size_t const path_length) {
+  auto result = std::make_shared<search_result>();
+  result->routes_.resize(1U);
+  result->routes_[0].resize(1U);
+  result->routes_[0][0].edges_.resize(1U);
+  result->routes_[0][0].edges_[0].path_.resize(path_length,
+                                               make_location(8.0, 50.0));
+  return result;
+}
+
+}  // namespace
+
+TEST(ppr_route_cache, key_snapping) {
+  route_cache cache{10.0, 1024U * 1024U};
+  auto const a = make_location(8.0003, 50.0003);
+  auto const a_near = make_location(8.00031, 50.00031);  // ~1.3m
+  auto const b = make_location(8.01, 50.0);
+
+  EXPECT_EQ(cache.snap(a), cache.snap(a_near));
+  EXPECT_NE(cache.snap(a), cache.snap(b));
+
+  auto const key = cache.make_key("default", 900.0, search_direction::FWD, a,
+                                  {b, a_near});
+  EXPECT_EQ(key, cache.make_key("default", 900.0, search_direction::FWD,
+                                a_near, {b, a}));
+  EXPECT_FALSE(key == cache.make_key("wheelchair", 900.0,
+                                     search_direction::FWD, a, {b, a}));
+  EXPECT_FALSE(key == cache.make_key("default", 600.0, search_direction::FWD,
+                                     a, {b, a}));
+  EXPECT_FALSE(key == cache.make_key("default", 900.0, search_direction::BWD,
+                                     a, {b, a}));
+  EXPECT_FALSE(key == cache.make_key("default", 900.0, search_direction::FWD,
+                                     a, {a, b}));  // destination order
+}
+
+TEST(ppr_route_cache, hit_and_eviction) {
+  auto const size = route_cache::result_size{}(make_result(10U));
+  route_cache cache{5.0, 2U * size};
+  ASSERT_TRUE(cache.enabled());
+
+  auto const key = [&](double const lng) {
+    return cache.make_key("", 900.0, search_direction::FWD,
+                          make_location(lng, 50.0),
+                          {make_location(lng + 0.01, 50.0)});
+  };
+
+  EXPECT_EQ(nullptr, cache.get(key(8.0)));
+  auto const r1 = make_result(10U);
+  cache.put(key(8.0), r1);
+  EXPECT_EQ(r1, cache.get(key(8.0)));
+
+  cache.put(key(8.0), make_result(10U));  // keeps the existing result
+  EXPECT_EQ(r1, cache.get(key(8.0)));
+
+  cache.put(key(9.0), make_result(10U));
+  EXPECT_EQ(r1, cache.get(key(8.0)));
+  cache.put(key(10.0), make_result(10U));  // evicts 9.0 (least recently used)
+  EXPECT_EQ(nullptr, cache.get(key(9.0)));
+  EXPECT_NE(nullptr, cache.get(key(10.0)));
+
+  // larger than the whole cache: evicted immediately
+  cache.put(key(11.0), make_result(100U));
+  EXPECT_EQ(nullptr, cache.get(key(11.0)));
+}
+
+TEST(ppr_route_cache, disabled) {
+  route_cache cache{5.0, 0U};
+  EXPECT_FALSE(cache.enabled());
+  auto const key =
+      cache.make_key("", 900.0, search_direction::FWD, make_location(8.0, 50.0),
+                     {make_location(8.01, 50.0)});
+  cache.put(key, make_result(1U));
+  EXPECT_EQ(nullptr, cache.get(key));
+}
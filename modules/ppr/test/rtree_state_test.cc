@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+
+#include "motis/module/ini_io.h"
+
+#include "motis/ppr/rtree_state.h"
+
+namespace fs = boost::filesystem;
+
+using namespace motis::ppr;
+
+namespace {
+
+void write_file(fs::path const& p, std::string const& content) {
+  std::ofstream out{p.generic_string(), std::ios::binary};
+  out << content;
+}
+
+}  // namespace
+
+TEST(ppr_rtree_state, graph_file_hash) {
+  auto const dir = fs::temp_directory_path() / "motis_ppr_graph_file_hash";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto const graph = (dir / "routing_graph.ppr").generic_string();
+
+  write_file(graph, "abc");
+  auto const [h1, size1] = graph_file_hash(graph);
+  EXPECT_EQ(3U, size1);
+
+  write_file(graph, "abd");
+  EXPECT_NE(h1, graph_file_hash(graph).first);
+
+  fs::remove_all(dir);
+}
+
+TEST(ppr_rtree_state, rtrees_up_to_date) {
+  auto const dir = fs::temp_directory_path() / "motis_ppr_rtree_state";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+
+  auto const state_file = dir / "rtrees.ini";
+  auto const files = std::vector<std::string>{
+      (dir / "routing_graph.ppr.ert").generic_string(),
+      (dir / "routing_graph.ppr.art").generic_string()};
+  auto const state = rtree_state{1U, 2U, 3U, 4U};
+
+  // nothing prebuilt
+  EXPECT_FALSE(rtrees_up_to_date(files, state_file, state));
+
+  // r-trees without state file
+  for (auto const& f : files) {
+    write_file(f, "rtree");
+  }
+  EXPECT_FALSE(rtrees_up_to_date(files, state_file, state));
+
+  motis::module::write_ini(state_file, state);
+  EXPECT_TRUE(rtrees_up_to_date(files, state_file, state));
+
+  // graph changed, different r-tree sizes
+  for (auto const& changed :
+       {rtree_state{9U, 2U, 3U, 4U}, rtree_state{1U, 9U, 3U, 4U},
+        rtree_state{1U, 2U, 9U, 4U}, rtree_state{1U, 2U, 3U, 9U}}) {
+    EXPECT_FALSE(rtrees_up_to_date(files, state_file, changed));
+  }
+
+  // r-tree file missing
+  fs::remove(files.back());
+  EXPECT_FALSE(rtrees_up_to_date(files, state_file, state));
+
+  fs::remove_all(dir);
+}
@@ -7,10 +7,12 @@
 
 #include "motis/revise/section.h"
 #include "motis/revise/stop.h"
+#include "motis/revise/trip_lookup.h"
 
 namespace motis::revise {
 
 std::vector<section> get_sections(journey const& j);
-std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j);
+std::vector<stop_ptr> get_all_stops(schedule const& sched,
+                                    trip_lookup const& trips, journey const& j);
 
 }  // namespace motis::revise
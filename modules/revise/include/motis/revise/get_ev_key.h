@@ -10,10 +10,12 @@
 #include "motis/core/schedule/trip.h"
 #include "motis/core/journey/journey.h"
 
+#include "motis/revise/trip_lookup.h"
+
 namespace motis::revise {
 
-ev_key get_ev_key(schedule const& sched, journey const& j, unsigned stop_idx,
-                  event_type ev_type);
+ev_key get_ev_key(schedule const& sched, trip_lookup const& trips,
+                  journey const& j, unsigned stop_idx, event_type ev_type);
 
 ev_key get_ev_key_from_trip(schedule const& sched, trip const* trp,
                             std::string const& station_id,
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/schedule/trip.h"
+#include "motis/core/journey/extern_trip.h"
+#include "motis/core/journey/journey.h"
+
+namespace motis::revise {
+
+// Trips referenced by a batch of journeys, resolved once and shared by all
+// journeys of the batch. Read-only after construction.
+// Unknown trips fall back to get_trip (which reports the error).
+struct trip_lookup {
+  trip_lookup() = default;
+  trip_lookup(schedule const&, std::vector<extern_trip> const&);
+
+  trip const* get(schedule const&, extern_trip const&) const;
+
+  std::map<extern_trip, trip const*> trips_;
+};
+
+}  // namespace motis::revise
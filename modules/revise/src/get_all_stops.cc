@@ -293,10 +293,12 @@ struct walk_stop : public stop {
   timestamp_reason timestamp_reason_{timestamp_reason::SCHEDULE};
 };
 
-std::vector<ev_key> get_shortest_path(schedule const& sched, journey const& j,
-                                      int const from, int const to) {
+std::vector<ev_key> get_shortest_path(schedule const& sched,
+                                      trip_lookup const& trips,
+                                      journey const& j, int const from,
+                                      int const to) {
   auto const tgt = get_station_node(sched, j.stops_[to].eva_no_);
-  auto const start_k = get_ev_key(sched, j, from, event_type::DEP);
+  auto const start_k = get_ev_key(sched, trips, j, from, event_type::DEP);
   if (!start_k) {
     return {};
   }
@@ -383,10 +385,11 @@ std::vector<section> get_sections(journey const& j) {
   return sections;
 }
 
-std::vector<stop_ptr> get_trip_stops(schedule const& sched, journey const& j,
-                                     int from, int to) {
+std::vector<stop_ptr> get_trip_stops(schedule const& sched,
+                                     trip_lookup const& trips,
+                                     journey const& j, int from, int to) {
   std::vector<stop_ptr> stops;
-  for (auto const& k : get_shortest_path(sched, j, from, to)) {
+  for (auto const& k : get_shortest_path(sched, trips, j, from, to)) {
     if (stops.empty()) {
       stops.emplace_back(std::make_unique<trip_stop>(sched, ev_key{}, k, true,
                                                      true, journey::stop{}));
@@ -567,14 +570,17 @@ void generate_stops(schedule const& sched, std::vector<stop_ptr>& stops) {
   stops.back()->dep_sched_time_ = INVALID_TIME;
 }
 
-std::vector<stop_ptr> get_all_stops(schedule const& sched, journey const& j) {
+std::vector<stop_ptr> get_all_stops(schedule const& sched,
+                                    trip_lookup const& trips,
+                                    journey const& j) {
   std::vector<stop_ptr> stops;
   for (auto const& section : get_sections(j)) {
     if (section.from_ == section.to_) {
       continue;
     }
     if (section.type_ == section_type::TRIP) {
-      auto trip_stops = get_trip_stops(sched, j, section.from_, section.to_);
+      auto trip_stops =
+          get_trip_stops(sched, trips, j, section.from_, section.to_);
       stops.insert(end(stops), std::make_move_iterator(begin(trip_stops)),
                    std::make_move_iterator(trip_stops.end()));
 
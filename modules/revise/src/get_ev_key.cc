@@ -6,12 +6,12 @@
 
 #include "motis/core/access/realtime_access.h"
 #include "motis/core/access/station_access.h"
-#include "motis/core/access/trip_access.h"
 
 namespace motis::revise {
 
-ev_key get_ev_key(schedule const& sched, journey const& j,
-                  unsigned const stop_idx, event_type const ev_type) {
+ev_key get_ev_key(schedule const& sched, trip_lookup const& trips,
+                  journey const& j, unsigned const stop_idx,
+                  event_type const ev_type) {
   auto const is_arr = (ev_type == event_type::ARR);
   auto const journey_trp =
       std::find_if(begin(j.trips_), end(j.trips_), [&](journey::trip const& t) {
@@ -21,7 +21,7 @@ ev_key get_ev_key(schedule const& sched, journey const& j,
   utl::verify(journey_trp != end(j.trips_),
               "get ev key(trip): invalid journey");
 
-  auto const trp = get_trip(sched, journey_trp->extern_trip_);
+  auto const trp = trips.get(sched, journey_trp->extern_trip_);
   auto const& stop = j.stops_[stop_idx];
   auto const schedule_time = is_arr ? stop.arrival_.schedule_timestamp_
                                     : stop.departure_.schedule_timestamp_;
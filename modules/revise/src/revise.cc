@@ -1,9 +1,18 @@
 #include "motis/revise/revise.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "boost/program_options.hpp"
 
+#include "utl/to_vec.h"
+
+#include "motis/core/common/logging.h"
+#include "motis/core/conv/connection_status_conv.h"
 #include "motis/core/journey/journeys_to_message.h"
 #include "motis/core/journey/message_to_journeys.h"
+#include "motis/module/context/motis_parallel_for.h"
+#include "motis/revise/trip_lookup.h"
 #include "motis/revise/update_journey.h"
 
 using namespace motis::module;
@@ -36,16 +45,66 @@ msg_ptr revise::update(Connection const* con) {
 }
 
 msg_ptr revise::update(ReviseRequest const* req) {
+  auto const& sched = get_sched();
+  auto const journeys = utl::to_vec(*req->connections(),
+                                    [](Connection const* con) {
+                                      return convert(con);
+                                    });
+
+  // Resolve every referenced trip once for the whole batch.
+  std::vector<extern_trip> extern_trips;
+  for (auto const& j : journeys) {
+    for (auto const& t : j.trips_) {
+      extern_trips.emplace_back(t.extern_trip_);
+    }
+  }
+  std::sort(begin(extern_trips), end(extern_trips));
+  extern_trips.erase(std::unique(begin(extern_trips), end(extern_trips)),
+                     end(extern_trips));
+  auto const trips = trip_lookup{sched, extern_trips};
+
+  // Group journeys sharing their first trip: neighbouring tasks then walk
+  // the same parts of the graph.
+  std::vector<size_t> indices(journeys.size());
+  std::iota(begin(indices), end(indices), 0U);
+  std::stable_sort(begin(indices), end(indices), [&](size_t a, size_t b) {
+    auto const& ja = journeys[a];
+    auto const& jb = journeys[b];
+    if (ja.trips_.empty() || jb.trips_.empty()) {
+      return !ja.trips_.empty() && jb.trips_.empty();
+    }
+    return ja.trips_.front().extern_trip_ < jb.trips_.front().extern_trip_;
+  });
+
+  std::vector<journey> revised(journeys.size());
+  motis_parallel_for(indices, [&](size_t const i) {
+    try {
+      revised[i] = update_journey(sched, trips, journeys[i]);
+    } catch (std::exception const& e) {
+      LOG(logging::warn) << "revise: connection " << i << " failed: "
+                         << e.what();
+      revised[i] = journeys[i];
+      revised[i].status_ = journey::connection_status::INVALID;
+    }
+  });
+
   message_creator fbb;
+  auto const status_only = req->status_only();
   fbb.create_and_finish(
       MsgContent_ReviseResponse,
-      CreateReviseResponse(fbb, fbb.CreateVector(utl::to_vec(
-                                    *req->connections(),
-                                    [&](Connection const* con) {
-                                      return to_connection(
-                                          fbb, update_journey(get_sched(),
-                                                              convert(con)));
-                                    })))
+      CreateReviseResponse(
+          fbb,
+          fbb.CreateVector(status_only
+                               ? std::vector<flatbuffers::Offset<Connection>>{}
+                               : utl::to_vec(revised,
+                                             [&](journey const& j) {
+                                               return to_connection(fbb, j);
+                                             })),
+          fbb.CreateVector(utl::to_vec(revised,
+                                       [](journey const& j) {
+                                         return static_cast<int8_t>(
+                                             status_to_fbs(j.status_));
+                                       })))
           .Union());
   return make_msg(fbb);
 }
@@ -0,0 +1,30 @@
+#include "motis/revise/trip_lookup.h"
+
+#include <system_error>
+
+#include "motis/core/access/trip_access.h"
+
+namespace motis::revise {
+
+trip_lookup::trip_lookup(schedule const& sched,
+                         std::vector<extern_trip> const& trips) {
+  for (auto const& et : trips) {
+    if (trips_.find(et) != end(trips_)) {
+      continue;
+    }
+    try {
+      trips_.emplace(et, get_trip(sched, et));
+    } catch (std::system_error const&) {
+      trips_.emplace(et, nullptr);
+    }
+  }
+}
+
+trip const* trip_lookup::get(schedule const& sched,
+                             extern_trip const& et) const {
+  auto const it = trips_.find(et);
+  return it != end(trips_) && it->second != nullptr ? it->second
+                                                    : get_trip(sched, et);
+}
+
+}  // namespace motis::revise
@@ -77,12 +77,13 @@ void add_to_intervals(
 }
 
 void edges_to_journey(
-    schedule const& sched, journey const& j, journey& new_journey,
+    schedule const& sched, trip_lookup const& trips, journey const& j,
+    journey& new_journey,
     interval_map<free_text const*, free_text_cmp>& free_texts,
     interval_map<trip const*, trp_cmp>& trip_intervals,
     interval_map<connection_info const*, con_info_cmp>& transport_intervals,
     interval_map<attribute const*>& attribute_intervals) {
-  auto const stops = get_all_stops(sched, j);
+  auto const stops = get_all_stops(sched, trips, j);
   for (auto const& stop : stops) {
     auto& new_stop = new_journey.stops_.emplace_back(stop->get_stop(sched));
     auto const stop_size = new_journey.stops_.size() - 1;
@@ -119,7 +120,7 @@ void edges_to_journey(
       auto const stop_idx = std::distance(begin(j.stops_), stop_it);
       for (auto const& t : j.trips_) {
         if (stop_idx > t.from_ && stop_idx <= t.to_) {
-          trip_intervals.add_entry(from_extern_trip(sched, &t.extern_trip_),
+          trip_intervals.add_entry(trips.get(sched, t.extern_trip_),
                                    stop_size);
         }
       }
@@ -137,7 +138,7 @@ void edges_to_journey(
       auto const stop_idx = std::distance(begin(j.stops_), stop_it);
       for (auto const& t : j.trips_) {
         if (stop_idx >= t.from_ && stop_idx < t.to_) {
-          trip_intervals.add_entry(from_extern_trip(sched, &t.extern_trip_),
+          trip_intervals.add_entry(trips.get(sched, t.extern_trip_),
                                    stop_size);
         }
       }
@@ -166,6 +167,11 @@ int get_stop_idx(journey const& con, int const schedule_time,
 }
 
 journey update_journey(schedule const& sched, journey const& j) {
+  return update_journey(sched, trip_lookup{}, j);
+}
+
+journey update_journey(schedule const& sched, trip_lookup const& trips,
+                       journey const& j) {
   if (j.stops_.empty() ||
       std::none_of(begin(j.stops_), end(j.stops_),
                    [](journey::stop const& s) { return s.enter_; })) {
@@ -179,7 +185,7 @@ journey update_journey(schedule const& sched, journey const& j) {
   interval_map<attribute const*> attribute_intervals;
 
   // compute stations and intervals
-  edges_to_journey(sched, j, updated_journey, free_text_intervals,
+  edges_to_journey(sched, trips, j, updated_journey, free_text_intervals,
                    trip_intervals, transport_intervals, attribute_intervals);
 
   // compute free_texts
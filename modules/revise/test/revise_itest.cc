@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 
+#include "utl/to_vec.h"
+
 #include "motis/core/schedule/event_type.h"
+#include "motis/core/conv/connection_status_conv.h"
 #include "motis/core/journey/journeys_to_message.h"
 #include "motis/core/journey/message_to_journeys.h"
 #include "motis/module/message.h"
@@ -16,6 +19,8 @@ using namespace motis::module;
 using namespace motis::routing;
 using namespace motis::test;
 using namespace motis::test::schedule::update_journey;
+using motis::revise::CreateReviseRequest;
+using motis::revise::ReviseResponse;
 using motis::test::schedule::update_journey::dataset_opt;
 
 struct revise_itest : public motis_instance_test {
@@ -277,6 +282,126 @@ TEST_F(revise_itest, update_status_violated_interchange_time_without_walk) {
             journey::problem_type::INTERCHANGE_TIME_VIOLATED);
 }
 
+namespace {
+
+msg_ptr make_revise_request(std::vector<journey> const& journeys,
+                            bool const status_only) {
+  message_creator fbb;
+  fbb.create_and_finish(
+      MsgContent_ReviseRequest,
+      CreateReviseRequest(
+          fbb,
+          fbb.CreateVector(utl::to_vec(
+              journeys,
+              [&](journey const& j) { return to_connection(fbb, j); })),
+          status_only)
+          .Union(),
+      "/revise");
+  return make_msg(fbb);
+}
+
+void expect_same_journey(journey const& a, journey const& b) {
+  EXPECT_EQ(a.status_, b.status_);
+  EXPECT_EQ(a.problems_.size(), b.problems_.size());
+  ASSERT_EQ(a.stops_.size(), b.stops_.size());
+  for (auto i = 0U; i != a.stops_.size(); ++i) {
+    auto const& sa = a.stops_[i];
+    auto const& sb = b.stops_[i];
+    EXPECT_EQ(sa.eva_no_, sb.eva_no_);
+    EXPECT_EQ(sa.arrival_.timestamp_, sb.arrival_.timestamp_);
+    EXPECT_EQ(sa.arrival_.track_, sb.arrival_.track_);
+    EXPECT_EQ(sa.departure_.timestamp_, sb.departure_.timestamp_);
+    EXPECT_EQ(sa.departure_.track_, sb.departure_.track_);
+  }
+}
+
+}  // namespace
+
+TEST_F(revise_itest, batch_matches_single_requests) {
+  auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
+                                            "8002059", "8000156"));
+  auto const journeys =
+      message_to_journeys(motis_content(RoutingResponse, con));
+  ASSERT_EQ(journeys.size(), 1);
+
+  auto moved = journeys.front();
+  moved.stops_.at(0).departure_.timestamp_ = unix_time(2200);
+  moved.stops_.at(5).arrival_.track_ = "15";
+  auto const batch = std::vector<journey>{journeys.front(), moved};
+
+  auto const resp = call(make_revise_request(batch, false));
+  auto const revise_resp = motis_content(ReviseResponse, resp);
+  ASSERT_EQ(batch.size(), revise_resp->connections()->size());
+  ASSERT_EQ(batch.size(), revise_resp->status()->size());
+
+  for (auto i = 0U; i != batch.size(); ++i) {
+    message_creator fbb;
+    fbb.create_and_finish(MsgContent_Connection,
+                          to_connection(fbb, batch[i]).Union(), "/revise");
+    auto const single =
+        convert(motis_content(Connection, call(make_msg(fbb))));
+    auto const batched = convert(revise_resp->connections()->Get(i));
+    expect_same_journey(single, batched);
+    EXPECT_EQ(status_to_fbs(single.status_),
+              static_cast<ConnectionStatus>(revise_resp->status()->Get(i)));
+  }
+}
+
+TEST_F(revise_itest, batch_with_invalid_journey) {
+  auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
+                                            "8002059", "8000156"));
+  auto const journeys =
+      message_to_journeys(motis_content(RoutingResponse, con));
+  ASSERT_EQ(journeys.size(), 1);
+
+  auto invalid = journeys.front();
+  ASSERT_FALSE(invalid.trips_.empty());
+  invalid.trips_.front().extern_trip_.train_nr_ = 999999;  // unknown trip
+  auto const batch =
+      std::vector<journey>{journeys.front(), invalid, journeys.front()};
+
+  auto const resp = call(make_revise_request(batch, false));
+  auto const revise_resp = motis_content(ReviseResponse, resp);
+  ASSERT_EQ(3U, revise_resp->connections()->size());
+  ASSERT_EQ(3U, revise_resp->status()->size());
+
+  EXPECT_EQ(ConnectionStatus_OK,
+            static_cast<ConnectionStatus>(revise_resp->status()->Get(0)));
+  EXPECT_EQ(ConnectionStatus_INVALID,
+            static_cast<ConnectionStatus>(revise_resp->status()->Get(1)));
+  EXPECT_EQ(ConnectionStatus_OK,
+            static_cast<ConnectionStatus>(revise_resp->status()->Get(2)));
+
+  // the invalid journey is returned unchanged
+  auto const returned = convert(revise_resp->connections()->Get(1));
+  EXPECT_EQ(journey::connection_status::INVALID, returned.status_);
+  ASSERT_FALSE(returned.trips_.empty());
+  EXPECT_EQ(999999, returned.trips_.front().extern_trip_.train_nr_);
+  expect_same_journey(convert(revise_resp->connections()->Get(0)),
+                      convert(revise_resp->connections()->Get(2)));
+}
+
+TEST_F(revise_itest, batch_status_only) {
+  auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
+                                            "8002059", "8000156"));
+  auto const journeys =
+      message_to_journeys(motis_content(RoutingResponse, con));
+  ASSERT_EQ(journeys.size(), 1);
+
+  auto invalid = journeys.front();
+  invalid.trips_.front().extern_trip_.train_nr_ = 999999;
+  auto const batch = std::vector<journey>{journeys.front(), invalid};
+
+  auto const resp = call(make_revise_request(batch, true));
+  auto const revise_resp = motis_content(ReviseResponse, resp);
+  EXPECT_EQ(0U, revise_resp->connections()->size());
+  ASSERT_EQ(2U, revise_resp->status()->size());
+  EXPECT_EQ(ConnectionStatus_OK,
+            static_cast<ConnectionStatus>(revise_resp->status()->Get(0)));
+  EXPECT_EQ(ConnectionStatus_INVALID,
+            static_cast<ConnectionStatus>(revise_resp->status()->Get(1)));
+}
+
 TEST_F(revise_itest,
        DISABLED_update_status_violated_canceled_train_without_walk) {
   auto const con = call(get_routing_request(unix_time(1500), unix_time(1612),
@@ -17,7 +17,8 @@ struct label : public Data {  // NOLINT
 
   label() = default;  // NOLINT
 
-  label(edge const* e, label* pred, time now, lower_bounds& lb,
+  template <typename LowerBounds>
+  label(edge const* e, label* pred, time now, LowerBounds& lb,
         light_connection const* lcon = nullptr)
       : pred_(pred),
         edge_(e),
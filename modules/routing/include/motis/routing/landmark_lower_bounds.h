@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "motis/core/schedule/landmarks.h"
+#include "motis/core/schedule/schedule.h"
+
+namespace motis::routing {
+
+// ALT lower bounds (triangle inequality with the landmark distances of the
+// schedule). Only the goal distances are aggregated per query - no graph
+// search required. Transfers are not bounded (always 0).
+//
+// FWD (distance v -> goal t):
+//   d(v,t) >= d(v,l) - d(t,l)  and  d(v,t) >= d(l,t) - d(l,v)
+// BWD (distance goal t -> v): same with from/to swapped.
+//
+// Distances > landmarks::MAX_DIST are stored as INVALID_DIST: usable as
+// MAX_DIST where a lower estimate is required, skipped otherwise.
+// Stations without landmark distances (added by RT) get the bound 0.
+template <search_dir Dir>
+struct landmark_lower_bounds {
+  using dist_t = uint32_t;
+
+  struct travel_time_bounds {
+    inline dist_t operator[](node const* n) const {
+      return lbs_->get(n->get_station()->id_);
+    }
+    inline bool is_reachable(dist_t) const { return true; }
+    landmark_lower_bounds const* lbs_;
+  };
+
+  struct transfers_bounds {
+    inline dist_t operator[](node const*) const { return 0U; }
+    inline bool is_reachable(dist_t) const { return true; }
+  };
+
+  landmark_lower_bounds(schedule const& sched, std::vector<int> const& goals)
+      : lm_{sched.landmarks_},
+        goal_max_(lm_.count(), 0U),
+        goal_min_(lm_.count(), landmarks::MAX_DIST),
+        travel_time_{this} {
+    for (auto const goal : goals) {
+      if (static_cast<std::size_t>(goal) >= lm_.station_count()) {
+        // no distances for this goal: a and b terms are not usable
+        std::fill(begin(goal_max_), end(goal_max_), landmarks::INVALID_DIST);
+        std::fill(begin(goal_min_), end(goal_min_), duration{0U});
+        break;
+      }
+      for (auto i = 0U; i != lm_.count(); ++i) {
+        auto const a = dist_a(goal, i);
+        goal_max_[i] = a == landmarks::INVALID_DIST
+                           ? landmarks::INVALID_DIST
+                           : std::max(goal_max_[i], a);
+        goal_min_[i] = std::min(goal_min_[i], dist_b(goal, i));
+      }
+    }
+  }
+
+  landmark_lower_bounds(landmark_lower_bounds const&) = delete;
+  landmark_lower_bounds& operator=(landmark_lower_bounds const&) = delete;
+  landmark_lower_bounds(landmark_lower_bounds&&) = delete;
+  landmark_lower_bounds& operator=(landmark_lower_bounds&&) = delete;
+  ~landmark_lower_bounds() = default;
+
+  dist_t get(uint32_t const station_idx) const {
+    if (station_idx >= lm_.station_count()) {
+      return 0U;
+    }
+    auto lb = 0;
+    for (auto i = 0U; i != lm_.count(); ++i) {
+      if (goal_max_[i] != landmarks::INVALID_DIST) {
+        auto const a = std::min(dist_a(station_idx, i), landmarks::MAX_DIST);
+        lb = std::max(lb, a - goal_max_[i]);
+      }
+      if (auto const b = dist_b(station_idx, i); b != landmarks::INVALID_DIST) {
+        lb = std::max(lb, goal_min_[i] - b);
+      }
+    }
+    return static_cast<dist_t>(lb);
+  }
+
+private:
+  // a: distances towards the landmark for FWD, from the landmark for BWD
+  duration dist_a(uint32_t const station_idx, std::size_t const i) const {
+    return Dir == search_dir::FWD ? lm_.to_landmark(station_idx, i)
+                                  : lm_.from_landmark(station_idx, i);
+  }
+
+  duration dist_b(uint32_t const station_idx, std::size_t const i) const {
+    return Dir == search_dir::FWD ? lm_.from_landmark(station_idx, i)
+                                  : lm_.to_landmark(station_idx, i);
+  }
+
+  landmarks const& lm_;
+  std::vector<duration> goal_max_;  // max. a over all goals
+  std::vector<duration> goal_min_;  // min. b over all goals (capped)
+
+public:
+  travel_time_bounds travel_time_;
+  transfers_bounds transfers_;
+};
+
+}  // namespace motis::routing
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include "motis/hash_map.h"
+#include "motis/vector.h"
 
 #include "motis/core/schedule/constant_graph.h"
 #include "motis/core/schedule/schedule.h"
@@ -12,22 +17,103 @@
 
 namespace motis::routing {
 
+using lb_edges_t = mcd::hash_map<unsigned, std::vector<simple_edge>>;
+
+// Distances to the goals computed by constant_graph_dijkstra.
+struct lower_bounds_data {
+  mcd::vector<uint32_t> travel_time_;
+  mcd::vector<uint32_t> transfers_;
+  uint64_t travel_time_ms_{0U}, transfers_ms_{0U};  // computation time
+};
+
+template <typename MapNodeFn>
+struct lower_bound_view {
+  using dist_t = uint32_t;
+  enum : dist_t { UNREACHABLE = std::numeric_limits<dist_t>::max() };
+
+  lower_bound_view(mcd::vector<dist_t> const& dists, MapNodeFn map_node)
+      : dists_{dists.data()}, size_{dists.size()}, map_node_{map_node} {}
+
+  inline dist_t operator[](node const* n) const {
+    auto const idx = map_node_(n);
+    assert(idx < size_);
+    return dists_[idx];
+  }
+
+  inline bool is_reachable(dist_t const val) const {
+    return val != UNREACHABLE;
+  }
+
+  dist_t const* dists_;
+  std::size_t size_;
+  MapNodeFn map_node_;
+};
+
 struct lower_bounds {
-  lower_bounds(schedule const& sched,  //
-               constant_graph const& travel_time_graph,
-               constant_graph const& transfers_graph,  //
-               std::vector<int> const& goals,
-               mcd::hash_map<unsigned, std::vector<simple_edge>> const&
-                   additional_travel_time_edges,
-               mcd::hash_map<unsigned, std::vector<simple_edge>> const&
-                   additional_transfers_edges)
-      : travel_time_(travel_time_graph, goals, additional_travel_time_edges),
-        transfers_(transfers_graph, goals, additional_transfers_edges,
-                   map_interchange_graph_node(sched.non_station_node_offset_)) {
+  lower_bounds(schedule const& sched,
+               std::shared_ptr<lower_bounds_data const> data)
+      : data_{std::move(data)},
+        travel_time_{data_->travel_time_, map_station_graph_node{}},
+        transfers_{data_->transfers_,
+                   map_interchange_graph_node(sched.non_station_node_offset_)} {
   }
 
-  constant_graph_dijkstra<MAX_TRAVEL_TIME, map_station_graph_node> travel_time_;
-  constant_graph_dijkstra<MAX_TRANSFERS, map_interchange_graph_node> transfers_;
+  std::shared_ptr<lower_bounds_data const> data_;
+  lower_bound_view<map_station_graph_node> travel_time_;
+  lower_bound_view<map_interchange_graph_node> transfers_;
 };
 
+inline mcd::vector<uint32_t> compute_travel_time_lb(
+    constant_graph const& g, std::vector<int> const& goals,
+    lb_edges_t const& additional_edges) {
+  constant_graph_dijkstra<MAX_TRAVEL_TIME, map_station_graph_node> d{
+      g, goals, additional_edges};
+  d.run();
+  return std::move(d.dists_);
+}
+
+inline mcd::vector<uint32_t> compute_transfers_lb(
+    schedule const& sched, constant_graph const& g,
+    std::vector<int> const& goals, lb_edges_t const& additional_edges) {
+  constant_graph_dijkstra<MAX_TRANSFERS, map_interchange_graph_node> d{
+      g, goals, additional_edges,
+      map_interchange_graph_node(sched.non_station_node_offset_)};
+  d.run();
+  return std::move(d.dists_);
+}
+
+// Additional (query) edges can be applied to distances computed without them
+// if every edge leads to a sink, i.e. a node without outgoing edges in the
+// graph and in the additional edges (e.g. the dummy START station).
+// Distances of all other nodes are unaffected by such edges.
+inline bool is_patchable(constant_graph const& g,
+                         lb_edges_t const& additional_edges) {
+  for (auto const& [from, edges] : additional_edges) {
+    for (auto const& e : edges) {
+      if (e.to_ >= g.size() || !g[e.to_].empty() ||
+          additional_edges.find(e.to_) != end(additional_edges)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <uint32_t MaxValue>
+void patch_lower_bounds(mcd::vector<uint32_t>& dists,
+                        lb_edges_t const& additional_edges) {
+  for (auto const& [from, edges] : additional_edges) {
+    auto const dist = dists[from];
+    if (dist == std::numeric_limits<uint32_t>::max()) {
+      continue;
+    }
+    for (auto const& e : edges) {
+      auto const new_dist = dist + e.cost_;
+      if (new_dist < dists[e.to_] && new_dist <= MaxValue) {
+        dists[e.to_] = new_dist;
+      }
+    }
+  }
+}
+
 }  // namespace motis::routing
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "motis/core/common/lru_cache.h"
+#include "motis/core/schedule/schedule.h"
+#include "motis/core/statistics/statistics.h"
+
+#include "motis/routing/lower_bounds.h"
+
+namespace motis::routing {
+
+struct lower_bounds_key {
+  friend bool operator==(lower_bounds_key const& a, lower_bounds_key const& b) {
+    return a.sched_generation_ == b.sched_generation_ && a.dir_ == b.dir_ &&
+           a.goals_ == b.goals_;
+  }
+
+  uint64_t sched_generation_;  // schedule_data::generation_
+  search_dir dir_;
+  std::vector<int> goals_;  // sorted
+};
+
+// LRU cache of lower bounds computed without query edges, shared by all
+// queries. Has to be cleared whenever the lower bound graphs may change.
+struct lower_bounds_cache {
+  using entry_ptr = std::shared_ptr<lower_bounds_data const>;
+
+  explicit lower_bounds_cache(std::size_t max_entries);
+
+  entry_ptr get(lower_bounds_key const&);
+  void put(lower_bounds_key const&, entry_ptr);
+  void clear();
+
+  stats_category get_stats(char const* name) const;
+
+private:
+  struct key_hash {
+    std::size_t operator()(lower_bounds_key const&) const;
+  };
+
+  lru_cache<lower_bounds_key, entry_ptr, lru_entry_count, key_hash> cache_;
+  std::atomic_uint64_t invalidations_{0U}, saved_ms_{0U};
+};
+
+}  // namespace motis::routing
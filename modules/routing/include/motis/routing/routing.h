@@ -9,6 +9,7 @@
 namespace motis::routing {
 
 struct memory;
+struct lower_bounds_cache;
 
 struct routing : public motis::module::module {
   routing();
@@ -30,6 +31,10 @@ private:
 
   std::mutex mem_pool_mutex_;
   std::vector<std::unique_ptr<memory>> mem_pool_;
+
+  std::size_t lb_cache_size_{64U};
+  bool use_landmarks_{false};
+  std::unique_ptr<lower_bounds_cache> lb_cache_;
 };
 
 }  // namespace motis::routing
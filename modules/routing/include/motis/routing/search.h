@@ -1,14 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
 #include "utl/to_vec.h"
 
 #include "motis/hash_map.h"
 
 #include "motis/core/common/timing.h"
 #include "motis/core/schedule/schedule.h"
+#include "motis/routing/landmark_lower_bounds.h"
 #include "motis/routing/lower_bounds.h"
+#include "motis/routing/lower_bounds_cache.h"
 #include "motis/routing/output/labels_to_journey.h"
 #include "motis/routing/pareto_dijkstra.h"
+#include "motis/routing/start_label_generators/ontrip_gen.h"
 
 namespace motis::routing {
 
@@ -27,6 +34,9 @@ struct search_query {
   bool use_dest_metas_{false};
   bool use_start_footpaths_{false};
   light_connection const* lcon_{nullptr};
+  lower_bounds_cache* lb_cache_{nullptr};
+  uint64_t sched_generation_{0U};  // lb_cache_ key, see schedule_data
+  bool use_landmarks_{false};
 };
 
 struct search_result {
@@ -44,6 +54,12 @@ struct search_result {
   time interval_end_{INVALID_TIME};
 };
 
+template <typename StartLabelGenerator>
+struct is_ontrip_gen : std::false_type {};
+
+template <search_dir Dir, typename Label>
+struct is_ontrip_gen<ontrip_gen<Dir, Label>> : std::true_type {};
+
 template <search_dir Dir, typename StartLabelGenerator, typename Label>
 struct search {
   static search_result get_connections(search_query const& q) {
@@ -90,25 +106,99 @@ struct search {
       is_goal[q.to_->id_] = true;
     }
 
-    lower_bounds lbs(
-        *q.sched_,  //
+    if constexpr (is_ontrip_gen<StartLabelGenerator>::value) {
+      if (q.use_landmarks_ && q.query_edges_.empty() &&
+          !q.sched_->landmarks_.empty()) {
+        MOTIS_START_TIMING(landmark_lb_timing);
+        landmark_lower_bounds<Dir> lbs{*q.sched_, goal_ids};
+        MOTIS_STOP_TIMING(landmark_lb_timing);
+
+        auto res = search_with_lower_bounds(q, lbs, is_goal);
+        res.stats_.travel_time_lb_ = MOTIS_TIMING_MS(landmark_lb_timing);
+        res.stats_.landmark_lbs_ = 1U;
+        return res;
+      }
+    }
+
+    auto const& travel_time_graph =
         Dir == search_dir::FWD ? q.sched_->travel_time_lower_bounds_fwd_
-                               : q.sched_->travel_time_lower_bounds_bwd_,
+                               : q.sched_->travel_time_lower_bounds_bwd_;
+    auto const& transfers_graph =
         Dir == search_dir::FWD ? q.sched_->transfers_lower_bounds_fwd_
-                               : q.sched_->transfers_lower_bounds_bwd_,
-        goal_ids, travel_time_lb_graph_edges, transfers_lb_graph_edges);
+                               : q.sched_->transfers_lower_bounds_bwd_;
+
+    auto const use_lb_cache =
+        q.lb_cache_ != nullptr &&
+        is_patchable(travel_time_graph, travel_time_lb_graph_edges) &&
+        is_patchable(transfers_graph, transfers_lb_graph_edges);
+    auto lb_key = lower_bounds_key{q.sched_generation_, Dir, goal_ids};
+    std::sort(begin(lb_key.goals_), end(lb_key.goals_));
+
+    auto lb_data = use_lb_cache ? q.lb_cache_->get(lb_key)
+                                : lower_bounds_cache::entry_ptr{};
+    auto const lb_cache_hit = lb_data != nullptr;
+    if (!lb_cache_hit) {
+      auto const no_edges = lb_edges_t{};
+      auto const& tt_edges =
+          use_lb_cache ? no_edges : travel_time_lb_graph_edges;
+      auto const& ic_edges = use_lb_cache ? no_edges : transfers_lb_graph_edges;
+      auto computed = std::make_shared<lower_bounds_data>();
+
+      MOTIS_START_TIMING(travel_time_lb_timing);
+      computed->travel_time_ =
+          compute_travel_time_lb(travel_time_graph, goal_ids, tt_edges);
+      MOTIS_STOP_TIMING(travel_time_lb_timing);
+      computed->travel_time_ms_ = MOTIS_TIMING_MS(travel_time_lb_timing);
+
+      if (!use_lb_cache &&
+          computed->travel_time_[q.from_->get_station()->id_] ==
+              lower_bound_view<map_station_graph_node>::UNREACHABLE) {
+        return search_result(computed->travel_time_ms_);
+      }
 
-    MOTIS_START_TIMING(travel_time_lb_timing);
-    lbs.travel_time_.run();
-    MOTIS_STOP_TIMING(travel_time_lb_timing);
+      MOTIS_START_TIMING(transfers_lb_timing);
+      computed->transfers_ =
+          compute_transfers_lb(*q.sched_, transfers_graph, goal_ids, ic_edges);
+      MOTIS_STOP_TIMING(transfers_lb_timing);
+      computed->transfers_ms_ = MOTIS_TIMING_MS(transfers_lb_timing);
 
-    if (!lbs.travel_time_.is_reachable(lbs.travel_time_[q.from_])) {
-      return search_result(MOTIS_TIMING_MS(travel_time_lb_timing));
+      if (use_lb_cache) {
+        q.lb_cache_->put(lb_key, computed);
+      }
+      lb_data = std::move(computed);
+    }
+
+    if (use_lb_cache && !q.query_edges_.empty()) {
+      auto patched = std::make_shared<lower_bounds_data>(*lb_data);
+      patch_lower_bounds<MAX_TRAVEL_TIME>(patched->travel_time_,
+                                          travel_time_lb_graph_edges);
+      patch_lower_bounds<MAX_TRANSFERS>(patched->transfers_,
+                                        transfers_lb_graph_edges);
+      lb_data = std::move(patched);
+    }
+
+    auto const travel_time_lb_ms = lb_cache_hit ? 0U : lb_data->travel_time_ms_;
+    auto const transfers_lb_ms = lb_cache_hit ? 0U : lb_data->transfers_ms_;
+    auto lbs = lower_bounds{*q.sched_, lb_data};
+
+    auto res = search_with_lower_bounds(q, lbs, is_goal);
+    res.stats_.travel_time_lb_ = travel_time_lb_ms;
+    res.stats_.transfers_lb_ = transfers_lb_ms;
+    if (lb_cache_hit) {
+      res.stats_.lb_cache_hits_ = 1U;
+      res.stats_.lb_cache_saved_time_ =
+          lb_data->travel_time_ms_ + lb_data->transfers_ms_;
     }
+    return res;
+  }
 
-    MOTIS_START_TIMING(transfers_lb_timing);
-    lbs.transfers_.run();
-    MOTIS_STOP_TIMING(transfers_lb_timing);
+  template <typename LowerBounds>
+  static search_result search_with_lower_bounds(
+      search_query const& q, LowerBounds& lbs,
+      boost::container::vector<bool> const& is_goal) {
+    if (!lbs.travel_time_.is_reachable(lbs.travel_time_[q.from_])) {
+      return search_result{};
+    }
 
     auto const create_start_edge = [&](node* to) {
       return Dir == search_dir::FWD ? make_foot_edge(nullptr, to)
@@ -121,11 +211,11 @@ struct search {
     if (q.from_->is_route_node() ||
         q.from_ == q.sched_->station_nodes_.at(0).get()) {
       if (!lbs.travel_time_.is_reachable(lbs.travel_time_[q.from_])) {
-        return search_result(MOTIS_TIMING_MS(travel_time_lb_timing));
+        return search_result{};
       }
     } else if (!q.use_start_metas_) {
       if (!lbs.travel_time_.is_reachable(lbs.travel_time_[q.from_])) {
-        return search_result(MOTIS_TIMING_MS(travel_time_lb_timing));
+        return search_result{};
       }
       meta_edges.push_back(start_edge);
     } else {
@@ -137,7 +227,7 @@ struct search {
                             lbs.travel_time_[q.sched_->station_nodes_[s->index_]
                                                  .get()]);
                       })) {
-        return search_result(MOTIS_TIMING_MS(travel_time_lb_timing));
+        return search_result{};
       }
       for (auto const& meta_from : meta_froms) {
         auto meta_edge = create_start_edge(
@@ -151,7 +241,7 @@ struct search {
       additional_edges[e.get_source<Dir>()].push_back(e);
     }
 
-    pareto_dijkstra<Dir, Label, lower_bounds> pd(
+    pareto_dijkstra<Dir, Label, LowerBounds> pd(
         q.sched_->next_node_id_, q.sched_->stations_.size(), is_goal,
         std::move(additional_edges), lbs, *q.mem_);
 
@@ -228,8 +318,6 @@ struct search {
     MOTIS_STOP_TIMING(pareto_dijkstra_timing);
 
     auto stats = pd.get_statistics();
-    stats.travel_time_lb_ = MOTIS_TIMING_MS(travel_time_lb_timing);
-    stats.transfers_lb_ = MOTIS_TIMING_MS(transfers_lb_timing);
     stats.pareto_dijkstra_ = MOTIS_TIMING_MS(pareto_dijkstra_timing);
     stats.interval_extensions_ = search_iterations - 1;
 
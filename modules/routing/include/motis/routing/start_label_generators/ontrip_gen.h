@@ -12,8 +12,9 @@ namespace motis::routing {
 
 template <search_dir Dir, typename Label>
 struct ontrip_gen {
+  template <typename LowerBounds>
   static std::vector<Label*> generate(schedule const& sched, mem_manager& mem,
-                                      lower_bounds& lbs, edge const* start_edge,
+                                      LowerBounds& lbs, edge const* start_edge,
                                       std::vector<edge> const&,
                                       std::vector<edge> const& query_edges,
                                       time interval_begin,
@@ -36,8 +37,9 @@ struct ontrip_gen {
     return labels;
   }
 
+  template <typename LowerBounds>
   static void generate_intermodal_starts(
-      schedule const& sched, mem_manager& mem, lower_bounds& lbs,
+      schedule const& sched, mem_manager& mem, LowerBounds& lbs,
       edge const* start_edge, std::vector<edge> const& query_edges,
       time start_time, bool starting_footpaths, std::vector<Label*>& labels) {
     auto const start = sched.station_nodes_.at(0).get();
@@ -59,8 +61,9 @@ struct ontrip_gen {
     }
   }
 
+  template <typename LowerBounds>
   static void generate_station_starts(schedule const& sched, mem_manager& mem,
-                                      lower_bounds& lbs, edge const* start_edge,
+                                      LowerBounds& lbs, edge const* start_edge,
                                       time start_time, bool starting_footpaths,
                                       light_connection const* lcon,
                                       std::vector<Label*>& labels) {
@@ -69,16 +72,18 @@ struct ontrip_gen {
                                    labels);
   }
 
+  template <typename LowerBounds>
   static void generate_train_start(schedule const&, mem_manager& mem,
-                                   lower_bounds& lbs, edge const* start_edge,
+                                   LowerBounds& lbs, edge const* start_edge,
                                    time start_time,
                                    light_connection const* lcon,
                                    std::vector<Label*>& labels) {
     generate_start_label(mem, lbs, {{start_edge, 0}}, start_time, lcon, labels);
   }
 
+  template <typename LowerBounds>
   static void generate_labels_at_route_nodes(
-      schedule const& sched, mem_manager& mem, lower_bounds& lbs,
+      schedule const& sched, mem_manager& mem, LowerBounds& lbs,
       std::vector<std::pair<edge const*, int>> const& initial_path,
       time start_time, bool starting_footpaths, bool add_first_interchange_time,
       light_connection const* lcon, std::vector<Label*>& labels) {
@@ -90,8 +95,9 @@ struct ontrip_gen {
         });
   }
 
+  template <typename LowerBounds>
   static void generate_start_label(
-      mem_manager& mem, lower_bounds& lbs,
+      mem_manager& mem, LowerBounds& lbs,
       std::vector<std::pair<edge const*, int>> const& path, time start_time,
       light_connection const* lcon, std::vector<Label*>& labels) {
     Label* l = nullptr;
@@ -35,6 +35,9 @@ struct statistics {
   uint64_t num_bytes_in_use_{};
   uint64_t labels_to_journey_{};
   uint64_t interval_extensions_{};
+  uint64_t lb_cache_hits_{};
+  uint64_t lb_cache_saved_time_{};
+  uint64_t landmark_lbs_{};
 
   friend flatbuffers::Offset<Statistics> to_fbs(
       flatbuffers::FlatBufferBuilder& fbb, char const* category,
@@ -71,6 +74,9 @@ struct statistics {
     add_entry("transfers_lb", s.transfers_lb_);
     add_entry("travel_time_lb", s.travel_time_lb_);
     add_entry("interval_extensions", s.interval_extensions_);
+    add_entry("lb_cache_hits", s.lb_cache_hits_);
+    add_entry("lb_cache_saved_time", s.lb_cache_saved_time_);
+    add_entry("landmark_lbs", s.landmark_lbs_);
 
     return CreateStatistics(fbb, fbb.CreateString(category),
                             fbb.CreateVectorOfSortedTables(&stats));
@@ -102,7 +108,10 @@ struct statistics {
          {"total_calculation_time", s.total_calculation_time_},
          {"transfers_lb", s.transfers_lb_},
          {"travel_time_lb", s.travel_time_lb_},
-         {"interval_extensions", s.interval_extensions_}}};
+         {"interval_extensions", s.interval_extensions_},
+         {"lb_cache_hits", s.lb_cache_hits_},
+         {"lb_cache_saved_time", s.lb_cache_saved_time_},
+         {"landmark_lbs", s.landmark_lbs_}}};
   }
 };
 
@@ -0,0 +1,51 @@
+#include "motis/routing/lower_bounds_cache.h"
+
+#include "cista/hash.h"
+
+namespace motis::routing {
+
+lower_bounds_cache::lower_bounds_cache(std::size_t const max_entries)
+    : cache_{max_entries} {}
+
+std::size_t lower_bounds_cache::key_hash::operator()(
+    lower_bounds_key const& k) const {
+  auto h = cista::hash_combine(cista::BASE_HASH, k.sched_generation_,
+                               static_cast<unsigned>(k.dir_));
+  for (auto const goal : k.goals_) {
+    h = cista::hash_combine(h, goal);
+  }
+  return h;
+}
+
+lower_bounds_cache::entry_ptr lower_bounds_cache::get(
+    lower_bounds_key const& key) {
+  auto data = cache_.get(key);
+  if (!data.has_value()) {
+    return nullptr;
+  }
+  saved_ms_ += (*data)->travel_time_ms_ + (*data)->transfers_ms_;
+  return *data;
+}
+
+void lower_bounds_cache::put(lower_bounds_key const& key, entry_ptr data) {
+  // keeps entries computed concurrently by another query
+  cache_.put(key, std::move(data));
+}
+
+void lower_bounds_cache::clear() {
+  cache_.clear();
+  ++invalidations_;
+}
+
+stats_category lower_bounds_cache::get_stats(char const* name) const {
+  auto const stats = cache_.stats();
+  return stats_category{name,
+                        {{"entries", stats.entries_},
+                         {"hits", stats.hits_},
+                         {"misses", stats.misses_},
+                         {"evictions", stats.evictions_},
+                         {"invalidations", invalidations_.load()},
+                         {"saved_time", saved_ms_.load()}}};
+}
+
+}  // namespace motis::routing
@@ -18,6 +18,7 @@
 #include "motis/routing/error.h"
 #include "motis/routing/eval/commands.h"
 #include "motis/routing/label/configs.h"
+#include "motis/routing/lower_bounds_cache.h"
 #include "motis/routing/mem_manager.h"
 #include "motis/routing/mem_retriever.h"
 #include "motis/routing/search.h"
@@ -33,7 +34,13 @@ using namespace motis::module;
 
 namespace motis::routing {
 
-routing::routing() : module("Routing", "routing") {}
+routing::routing() : module("Routing", "routing") {
+  param(lb_cache_size_, "lb_cache_size",
+        "number of cached lower bounds (per goal set), 0 = disabled");
+  param(use_landmarks_, "landmarks",
+        "use landmark (ALT) lower bounds for ontrip station queries "
+        "(requires dataset.landmark_count or dataset.landmarks)");
+}
 
 routing::~routing() = default;
 
@@ -47,8 +54,17 @@ void routing::reg_subc(motis::module::subc_reg& r) {
 }
 
 void routing::init(motis::module::registry& reg) {
+  lb_cache_ = std::make_unique<lower_bounds_cache>(lb_cache_size_);
+
   reg.register_op("/routing", [this](msg_ptr const& msg) { return route(msg); },
                   {});
+  reg.subscribe(
+      "/rt/graph_updated",
+      [this](msg_ptr const&) -> msg_ptr {
+        lb_cache_->clear();
+        return nullptr;
+      },
+      {});
   reg.register_op("/trip_to_connection", [this](msg_ptr const& msg) {
     return trip_to_connection(msg);
   });
@@ -60,13 +76,17 @@ msg_ptr routing::route(msg_ptr const& msg) {
       req->schedule() == 0U ? to_res_id(global_res_id::SCHEDULE)
                             : static_cast<ctx::res_id_t>(req->schedule());
   auto res_lock = lock_resources({{schedule_res_id, ctx::access_t::READ}});
-  auto const& sched = *res_lock.get<schedule_data>(schedule_res_id).schedule_;
+  auto const& sched_data = res_lock.get<schedule_data>(schedule_res_id);
+  auto const& sched = *sched_data.schedule_;
 
   MOTIS_START_TIMING(routing_timing);
   auto query = build_query(sched, req);
 
   mem_retriever mem(mem_pool_mutex_, mem_pool_, LABEL_STORE_START_SIZE);
   query.mem_ = &mem.get();
+  query.lb_cache_ = lb_cache_.get();
+  query.sched_generation_ = sched_data.generation_;
+  query.use_landmarks_ = use_landmarks_;
 
   auto res = search_dispatch(query, req->start_type(), req->search_type(),
                              req->search_dir());
@@ -78,7 +98,8 @@ msg_ptr routing::route(msg_ptr const& msg) {
 
   message_creator fbb;
   std::vector<flatbuffers::Offset<Statistics>> stats{
-      to_fbs(fbb, "routing", res.stats_)};
+      to_fbs(fbb, "routing", res.stats_),
+      to_fbs(fbb, lb_cache_->get_stats("routing_lb_cache"))};
   fbb.create_and_finish(
       MsgContent_RoutingResponse,
       CreateRoutingResponse(
@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+
+#include "motis/routing/landmark_lower_bounds.h"
+
+using namespace motis;
+using namespace motis::routing;
+
+TEST(routing_landmark_lower_bounds, line) {
+  // A --10-- B --20-- C --5-- D, landmarks: A, D
+  auto const pos = std::vector<duration>{0U, 10U, 30U, 35U};
+  auto const dist = [&](std::size_t const a, std::size_t const b) {
+    return static_cast<duration>(pos[a] > pos[b] ? pos[a] - pos[b]
+                                                 : pos[b] - pos[a]);
+  };
+
+  schedule sched;
+  sched.landmarks_.stations_ = {0U, 3U};
+  for (auto s = 0U; s != pos.size(); ++s) {
+    for (auto const l : sched.landmarks_.stations_) {
+      sched.landmarks_.to_landmark_.push_back(dist(s, l));
+      sched.landmarks_.from_landmark_.push_back(dist(l, s));
+    }
+  }
+
+  landmark_lower_bounds<search_dir::FWD> fwd{sched, {2}};
+  landmark_lower_bounds<search_dir::BWD> bwd{sched, {2}};
+  for (auto s = 0U; s != pos.size(); ++s) {
+    EXPECT_EQ(dist(s, 2), fwd.get(s));
+    EXPECT_EQ(dist(2, s), bwd.get(s));
+  }
+
+  // multiple goals: bounded by the nearest goal
+  landmark_lower_bounds<search_dir::FWD> multi{sched, {1, 3}};
+  for (auto s = 0U; s != pos.size(); ++s) {
+    EXPECT_LE(multi.get(s), std::min(dist(s, 1), dist(s, 3)));
+  }
+  EXPECT_EQ(0U, multi.get(1));
+  EXPECT_EQ(0U, multi.get(3));
+}
+
+TEST(routing_landmark_lower_bounds, stations_without_distances) {
+  schedule sched;
+  sched.landmarks_.stations_ = {0U};
+  sched.landmarks_.to_landmark_ = {0U, 10U};
+  sched.landmarks_.from_landmark_ = {0U, 10U};
+  ASSERT_EQ(2U, sched.landmarks_.station_count());
+
+  // station 2 was added after the landmarks were computed (RT)
+  landmark_lower_bounds<search_dir::FWD> to_known{sched, {1}};
+  EXPECT_EQ(10U, to_known.get(0));
+  EXPECT_EQ(0U, to_known.get(2));
+
+  landmark_lower_bounds<search_dir::FWD> to_new{sched, {1, 2}};
+  EXPECT_EQ(0U, to_new.get(0));
+  EXPECT_EQ(0U, to_new.get(1));
+
+  sched.landmarks_.invalidate();
+  EXPECT_TRUE(sched.landmarks_.empty());
+  EXPECT_EQ(0U, sched.landmarks_.station_count());
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "motis/routing/lower_bounds.h"
+#include "motis/routing/lower_bounds_cache.h"
+
+using namespace motis;
+using namespace motis::routing;
+
+namespace {
+
+using dijkstra_t =
+    constant_graph_dijkstra<MAX_TRAVEL_TIME, map_station_graph_node>;
+
+mcd::vector<uint32_t> run(constant_graph const& g, lb_edges_t const& edges) {
+  dijkstra_t d{g, {2}, edges};
+  d.run();
+  return d.dists_;
+}
+
+}  // namespace
+
+TEST(routing_lower_bounds_cache, patch_query_edges) {
+  // 0: dummy start (no edges), goal: 2, 2 -> 3 -> 4, 2 -> 4
+  constant_graph g(5);
+  g[2].push_back(simple_edge{3, 10});
+  g[3].push_back(simple_edge{4, 5});
+  g[2].push_back(simple_edge{4, 20});
+
+  // query edges: start (0) reachable from 3 and 4
+  lb_edges_t query_edges;
+  query_edges[3].push_back(simple_edge{0, 7});
+  query_edges[4].push_back(simple_edge{0, 1});
+
+  ASSERT_TRUE(is_patchable(g, query_edges));
+  auto patched = run(g, {});
+  patch_lower_bounds<MAX_TRAVEL_TIME>(patched, query_edges);
+  EXPECT_EQ(run(g, query_edges), patched);
+  EXPECT_EQ(16U, patched[0]);
+
+  // edges leading into the graph change other distances: not patchable
+  lb_edges_t dest_edges;
+  dest_edges[2].push_back(simple_edge{4, 1});
+  EXPECT_FALSE(is_patchable(g, dest_edges));
+}
+
+TEST(routing_lower_bounds_cache, lru) {
+  lower_bounds_cache cache{2};
+  auto const key = [](int goal) {
+    return lower_bounds_key{1U, search_dir::FWD, {goal}};
+  };
+  auto const data = [](uint64_t ms) {
+    auto d = std::make_shared<lower_bounds_data>();
+    d->travel_time_ms_ = ms;
+    return d;
+  };
+
+  EXPECT_EQ(nullptr, cache.get(key(1)));
+  cache.put(key(1), data(10));
+  cache.put(key(2), data(20));
+  EXPECT_NE(nullptr, cache.get(key(1)));
+  cache.put(key(3), data(30));  // evicts 2 (least recently used)
+  EXPECT_EQ(nullptr, cache.get(key(2)));
+  EXPECT_NE(nullptr, cache.get(key(3)));
+
+  auto const stats = cache.get_stats("lb_cache");
+  auto const get = [&](char const* name) {
+    for (auto const& e : stats.entries_) {
+      if (e.key_ == name) {
+        return e.value_;
+      }
+    }
+    return uint64_t{0U};
+  };
+  EXPECT_EQ(2U, get("hits"));
+  EXPECT_EQ(2U, get("misses"));
+  EXPECT_EQ(1U, get("evictions"));
+  EXPECT_EQ(40U, get("saved_time"));
+
+  cache.clear();
+  EXPECT_EQ(nullptr, cache.get(key(1)));
+}
+
+TEST(routing_lower_bounds_cache, schedule_generation) {
+  lower_bounds_cache cache{4};
+  auto const key = [](uint64_t generation) {
+    return lower_bounds_key{generation, search_dir::FWD, {1}};
+  };
+
+  cache.put(key(1U), std::make_shared<lower_bounds_data>());
+  EXPECT_NE(nullptr, cache.get(key(1U)));
+  // different schedule instance (e.g. a fork at a reused address)
+  EXPECT_EQ(nullptr, cache.get(key(2U)));
+
+  EXPECT_NE(schedule_data::next_generation(),
+            schedule_data::next_generation());
+}
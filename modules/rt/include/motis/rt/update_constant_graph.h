@@ -60,11 +60,15 @@ inline void constant_graph_add_route_edge(schedule& sched,
     assert(from < cg.size() && to < cg.size());
     for (auto& se : cg[from]) {
       if (se.to_ == to) {
-        se.cost_ = std::min(se.cost_, min_cost.time_);
+        if (min_cost.time_ < se.cost_) {
+          se.cost_ = min_cost.time_;
+          sched.landmarks_.invalidate();
+        }
         return;
       }
     }
     cg[from].emplace_back(to, min_cost.time_);
+    sched.landmarks_.invalidate();
   };
 
   auto const from_station_id = route_edge->from_->get_station()->id_;
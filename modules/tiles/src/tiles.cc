@@ -22,9 +22,13 @@
 #include "tiles/parse_tile_url.h"
 #include "tiles/perf_counter.h"
 
+#include "utl/parallel_for.h"
 #include "utl/progress_tracker.h"
+#include "utl/to_vec.h"
 #include "utl/verify.h"
 
+#include "motis/core/common/logging.h"
+#include "motis/core/common/tile_cache.h"
 #include "motis/module/event_collector.h"
 #include "motis/module/ini_io.h"
 
@@ -52,16 +56,37 @@ struct import_state {
 };
 
 struct tiles::data {
-  explicit data(std::string const& path, size_t const db_size)
+  explicit data(std::string const& path, size_t const db_size,
+                size_t const cache_size)
       : db_env_{::tiles::make_tile_database(path.c_str(), db_size)},
         db_handle_{db_env_},
         render_ctx_{::tiles::make_render_ctx(db_handle_)},
-        pack_handle_{path.c_str()} {}
+        pack_handle_{path.c_str()},
+        cache_{cache_size} {}
+
+  motis::tile_cache::tile_ptr get_tile(geo::tile const& tile) {
+    return cache_.get_or_render(tile.z_, tile.x_, tile.y_, [&]() {
+      ::tiles::null_perf_counter pc;
+      return ::tiles::get_tile(db_handle_, pack_handle_, render_ctx_, tile,
+                               pc);
+    });
+  }
+
+  void prerender(uint32_t const max_z) {
+    for (auto z = 0U; z <= max_z; ++z) {
+      auto const dim = 1U << z;
+      utl::parallel_for_run(dim * dim, [&](auto const i) {
+        get_tile(geo::tile{static_cast<uint32_t>(i % dim),
+                           static_cast<uint32_t>(i / dim), z});
+      });
+    }
+  }
 
   lmdb::env db_env_;
   ::tiles::tile_db_handle db_handle_;
   ::tiles::render_ctx render_ctx_;
   ::tiles::pack_handle pack_handle_;
+  motis::tile_cache cache_;
 };
 
 tiles::tiles() : mm::module("Tiles", "tiles") {
@@ -70,6 +95,9 @@ tiles::tiles() : mm::module("Tiles", "tiles") {
   param(flush_threshold_, "import.flush_threshold",
         "shared metadata max queue size");
   param(db_size_, "db_size", "database size");
+  param(cache_size_, "cache_size", "rendered tile cache size in bytes");
+  param(prerender_max_z_, "prerender_max_z",
+        "pre-render tiles up to this zoom level at startup (-1 = off)");
 }
 
 tiles::~tiles() = default;
@@ -145,7 +173,7 @@ void tiles::import(mm::import_dispatcher& reg) {
         }
 
         mm::write_ini(dir / "import.ini", state);
-        data_ = std::make_unique<data>(path, db_size_);
+        data_ = std::make_unique<data>(path, db_size_, cache_size_);
       });
   collector->require("OSM", [](mm::msg_ptr const& msg) {
     return msg->get()->content_type() == MsgContent_OSMEvent;
@@ -158,6 +186,11 @@ void tiles::import(mm::import_dispatcher& reg) {
 }
 
 void tiles::init(mm::registry& reg) {
+  if (data_ != nullptr && prerender_max_z_ >= 0) {
+    logging::scoped_timer timer{"tiles: pre-render"};
+    data_->prerender(static_cast<uint32_t>(prerender_max_z_));
+  }
+
   reg.register_op("/tiles", [&](auto const& msg) {
     auto tile =
         ::tiles::parse_tile_url(msg->get()->destination()->target()->str());
@@ -165,14 +198,12 @@ void tiles::init(mm::registry& reg) {
       throw std::system_error(error::invalid_request);
     }
 
-    ::tiles::null_perf_counter pc;
-    auto rendered_tile = ::tiles::get_tile(
-        data_->db_handle_, data_->pack_handle_, data_->render_ctx_, *tile, pc);
+    auto const rendered_tile = data_->get_tile(*tile);
 
     mm::message_creator mc;
     std::vector<fb::Offset<HTTPHeader>> headers;
     fb::Offset<fb::String> payload;
-    if (rendered_tile) {
+    if (rendered_tile != nullptr) {
       headers.emplace_back(CreateHTTPHeader(
           mc, mc.CreateString("Content-Type"),
           mc.CreateString("application/vnd.mapbox-vector-tile")));
@@ -191,6 +222,19 @@ void tiles::init(mm::registry& reg) {
     return make_msg(mc);
   });
 
+  reg.register_op("/tiles/stats", [&](auto const&) {
+    mm::message_creator mc;
+    std::vector<fb::Offset<Statistics>> stats;
+    if (data_ != nullptr) {
+      stats.emplace_back(to_fbs(mc, data_->cache_.get_stats("tiles.cache")));
+    }
+    mc.create_and_finish(
+        MsgContent_StatisticsResponse,
+        CreateStatisticsResponse(mc, mc.CreateVectorOfSortedTables(&stats))
+            .Union());
+    return make_msg(mc);
+  });
+
   reg.register_op("/tiles/glyphs", [&](auto const& msg) {
     std::string decoded;
     net::url_decode(msg->get()->destination()->target()->str(), decoded);
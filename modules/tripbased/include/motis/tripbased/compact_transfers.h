@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "motis/vector.h"
+
+namespace motis::tripbased {
+
+namespace detail {
+
+inline void write_varint(mcd::vector<uint8_t>& out, uint64_t v) {
+  while (v >= 0x80U) {
+    out.push_back(static_cast<uint8_t>(v | 0x80U));
+    v >>= 7U;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+inline uint64_t read_varint(uint8_t const*& ptr) {
+  auto v = uint64_t{0U};
+  for (auto shift = 0U;; shift += 7U) {
+    auto const b = *ptr++;
+    v |= static_cast<uint64_t>(b & 0x7FU) << shift;
+    if ((b & 0x80U) == 0U) {
+      return v;
+    }
+  }
+}
+
+inline uint64_t zigzag_encode(int64_t const v) {
+  return (static_cast<uint64_t>(v) << 1U) ^ static_cast<uint64_t>(v >> 63U);
+}
+
+inline int64_t zigzag_decode(uint64_t const v) {
+  return static_cast<int64_t>(v >> 1U) ^ -static_cast<int64_t>(v & 1U);
+}
+
+}  // namespace detail
+
+// Transfers of every (trip, stop index) pair, indexed like a
+// nested_fws_multimap. Each list is sorted by the other trip and stored as
+// varints: the other trip as zigzag delta to the previous trip of the list
+// (the first one relative to the trip itself), followed by the other stop
+// index. Lists are decoded on the fly while iterating.
+//
+// Transfer has to provide other_trip(), other_stop_idx() and
+// Transfer::make(other_trip, other_stop_idx, stop_idx).
+template <typename Transfer, typename Index = uint64_t>
+struct compact_transfers {
+  struct iterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Transfer;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Transfer const*;
+    using reference = Transfer const&;
+
+    iterator(uint8_t const* pos, uint8_t const* end, uint32_t const trip,
+             uint16_t const stop_idx)
+        : pos_{pos}, next_{pos}, end_{end}, trip_{trip}, stop_idx_{stop_idx} {
+      decode();
+    }
+
+    Transfer const& operator*() const { return current_; }
+    Transfer const* operator->() const { return &current_; }
+
+    iterator& operator++() {
+      pos_ = next_;
+      decode();
+      return *this;
+    }
+
+    bool operator==(iterator const& o) const { return pos_ == o.pos_; }
+    bool operator!=(iterator const& o) const { return pos_ != o.pos_; }
+
+  private:
+    void decode() {
+      if (pos_ == end_) {
+        return;
+      }
+      auto ptr = pos_;
+      auto const delta = detail::zigzag_decode(detail::read_varint(ptr));
+      trip_ = static_cast<uint32_t>(static_cast<int64_t>(trip_) + delta);
+      auto const other_stop_idx =
+          static_cast<uint16_t>(detail::read_varint(ptr));
+      current_ = Transfer::make(trip_, other_stop_idx, stop_idx_);
+      next_ = ptr;
+    }
+
+    uint8_t const* pos_;
+    uint8_t const* next_;
+    uint8_t const* end_;
+    uint32_t trip_;
+    uint16_t stop_idx_;
+    Transfer current_{};
+  };
+
+  struct range {
+    iterator begin() const { return {begin_, end_, trip_, stop_idx_}; }
+    iterator end() const { return {end_, end_, trip_, stop_idx_}; }
+    bool empty() const { return begin_ == end_; }
+    std::size_t size() const {
+      return static_cast<std::size_t>(std::distance(begin(), end()));
+    }
+
+    uint8_t const* begin_;
+    uint8_t const* end_;
+    uint32_t trip_;
+    uint16_t stop_idx_;
+  };
+
+  explicit compact_transfers(mcd::vector<Index> const& base_index)
+      : base_index_(base_index) {}
+
+  // Has to be called for every (trip, stop index) pair in index order.
+  void push_back(uint32_t const trip, std::vector<Transfer> transfers) {
+    assert(!complete_);
+    index_.push_back(static_cast<Index>(data_.size()));
+    std::sort(begin(transfers), end(transfers),
+              [](Transfer const& a, Transfer const& b) {
+                return a.other_trip() < b.other_trip() ||
+                       (a.other_trip() == b.other_trip() &&
+                        a.other_stop_idx() < b.other_stop_idx());
+              });
+    auto prev_trip = static_cast<int64_t>(trip);
+    for (auto const& t : transfers) {
+      auto const other_trip = static_cast<int64_t>(t.other_trip());
+      detail::write_varint(data_,
+                           detail::zigzag_encode(other_trip - prev_trip));
+      detail::write_varint(data_, t.other_stop_idx());
+      prev_trip = other_trip;
+    }
+    count_ += transfers.size();
+  }
+
+  void finish_map() {
+    assert(!complete_);
+    index_.push_back(static_cast<Index>(data_.size()));
+    complete_ = true;
+  }
+
+  void reserve_index(std::size_t size) { index_.reserve(size + 1); }
+  void reserve_data(std::size_t size) { data_.reserve(size); }
+
+  range at(Index const outer_index, Index const inner_index) const {
+    assert(static_cast<std::size_t>(outer_index) < base_index_.size() - 1);
+    auto const idx = base_index_[outer_index] + inner_index;
+    auto const data = data_.data();
+    return {data + index_[idx], data + index_[idx + 1],
+            static_cast<uint32_t>(outer_index),
+            static_cast<uint16_t>(inner_index)};
+  }
+
+  std::size_t index_size() const { return index_.size(); }
+  std::size_t transfer_count() const { return count_; }
+  std::size_t byte_size() const {
+    return data_.size() + index_.size() * sizeof(Index);
+  }
+  bool finished() const { return complete_; }
+
+  mcd::vector<Index> const& base_index_;
+  mcd::vector<Index> index_;
+  mcd::vector<uint8_t> data_;
+  uint64_t count_{0U};
+  bool complete_{false};
+};
+
+}  // namespace motis::tripbased
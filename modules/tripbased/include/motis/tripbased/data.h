@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "cista/mmap.h"
+
 #include "motis/vector.h"
 
 #include "motis/core/common/fws_multimap.h"
@@ -13,6 +17,8 @@
 #include "motis/core/schedule/time.h"
 #include "motis/core/schedule/trip.h"
 
+#include "motis/tripbased/compact_transfers.h"
+
 namespace motis::tripbased {
 
 using trip_id = uint32_t;
@@ -51,10 +57,18 @@ struct tb_transfer {
   tb_transfer(trip_id to_trip, stop_idx_t to_stop_idx)
       : to_trip_(to_trip), to_stop_idx_(to_stop_idx) {}
 
+  static tb_transfer make(trip_id to_trip, stop_idx_t to_stop_idx,
+                          stop_idx_t /* from_stop_idx */) {
+    return {to_trip, to_stop_idx};
+  }
+
   bool valid() const {
     return to_stop_idx_ != std::numeric_limits<stop_idx_t>::max();
   }
 
+  trip_id other_trip() const { return to_trip_; }
+  stop_idx_t other_stop_idx() const { return to_stop_idx_; }
+
   trip_id to_trip_{};
   stop_idx_t to_stop_idx_{std::numeric_limits<stop_idx_t>::max()};
   uint8_t padding_[1]{};
@@ -68,10 +82,18 @@ struct tb_reverse_transfer {
         from_stop_idx_(from_stop_idx),
         to_stop_idx_(to_stop_idx) {}
 
+  static tb_reverse_transfer make(trip_id from_trip, stop_idx_t from_stop_idx,
+                                  stop_idx_t to_stop_idx) {
+    return {from_trip, from_stop_idx, to_stop_idx};
+  }
+
   bool valid() const {
     return from_stop_idx_ != std::numeric_limits<stop_idx_t>::max();
   }
 
+  trip_id other_trip() const { return from_trip_; }
+  stop_idx_t other_stop_idx() const { return from_stop_idx_; }
+
   trip_id from_trip_{};
   stop_idx_t from_stop_idx_{std::numeric_limits<stop_idx_t>::max()};
   stop_idx_t to_stop_idx_{std::numeric_limits<stop_idx_t>::max()};
@@ -81,14 +103,13 @@ struct tb_data {
   std::optional<std::pair<trip_id, time>> first_reachable_trip(
       line_id line, stop_idx_t stop_idx, time earliest_departure) const {
     assert(line < line_count_);
-    for (auto trip = line_to_first_trip_[line];
-         trip < trip_count_ && trip_to_line_[trip] == line; ++trip) {
-      auto const dep_time = departure_times_[trip][stop_idx];
-      if (dep_time >= earliest_departure) {
-        return std::make_pair(trip, dep_time);
-      }
+    auto const [col, n] = departure_column(line, stop_idx);
+    auto const it = std::lower_bound(col, col + n, earliest_departure);
+    if (it == col + n) {
+      return {};
     }
-    return {};
+    return std::make_pair(
+        static_cast<trip_id>(line_to_first_trip_[line] + (it - col)), *it);
   }
 
   std::pair<std::optional<std::pair<trip_id, time>>,
@@ -97,34 +118,30 @@ struct tb_data {
                                     time earliest_departure) const {
     assert(line < line_count_);
     auto const first_trip_in_line = line_to_first_trip_[line];
-    auto const last_trip_in_line = line_to_last_trip_[line];
-    for (auto trip = first_trip_in_line; trip <= last_trip_in_line; ++trip) {
-      auto const dep_time = departure_times_[trip][stop_idx];
-      if (dep_time >= earliest_departure) {
-        if (trip != first_trip_in_line) {
-          return {{{trip, dep_time}},
-                  {{trip - 1, departure_times_[trip - 1][stop_idx]}}};
-        } else {
-          return {{{trip, dep_time}}, {}};
-        }
-      }
+    auto const [col, n] = departure_column(line, stop_idx);
+    auto const idx = static_cast<trip_id>(
+        std::lower_bound(col, col + n, earliest_departure) - col);
+    if (idx == n) {
+      return {{}, {{first_trip_in_line + idx - 1, col[idx - 1]}}};
+    } else if (idx != 0) {
+      return {{{first_trip_in_line + idx, col[idx]}},
+              {{first_trip_in_line + idx - 1, col[idx - 1]}}};
+    } else {
+      return {{{first_trip_in_line, col[0]}}, {}};
     }
-    return {
-        {},
-        {{last_trip_in_line, departure_times_[last_trip_in_line][stop_idx]}}};
   }
 
   std::optional<std::pair<trip_id, time>> last_reachable_trip(
       line_id line, stop_idx_t stop_idx, time latest_arrival) const {
     assert(line < line_count_);
-    for (auto trip = static_cast<int>(line_to_last_trip_[line]);
-         trip >= 0 && trip_to_line_[trip] == line; --trip) {
-      auto const arr_time = arrival_times_[trip][stop_idx];
-      if (arr_time <= latest_arrival) {
-        return std::make_pair(trip, arr_time);
-      }
+    auto const [col, n] = arrival_column(line, stop_idx);
+    auto const it = std::upper_bound(col, col + n, latest_arrival);
+    if (it == col) {
+      return {};
     }
-    return {};
+    return std::make_pair(
+        static_cast<trip_id>(line_to_first_trip_[line] + (it - col - 1)),
+        *(it - 1));
   }
 
   std::pair<std::optional<std::pair<trip_id, time>>,
@@ -133,22 +150,33 @@ struct tb_data {
                                time latest_arrival) const {
     assert(line < line_count_);
     auto const first_trip_in_line = line_to_first_trip_[line];
-    auto const last_trip_in_line = line_to_last_trip_[line];
-    for (auto trip = static_cast<int>(line_to_last_trip_[line]);
-         trip >= static_cast<int>(first_trip_in_line); --trip) {
-      auto const arr_time = arrival_times_[trip][stop_idx];
-      if (arr_time <= latest_arrival) {
-        if (trip != last_trip_in_line) {
-          return {{{trip, arr_time}},
-                  {{trip + 1, arrival_times_[trip + 1][stop_idx]}}};
-        } else {
-          return {{{trip, arr_time}}, {}};
-        }
-      }
+    auto const [col, n] = arrival_column(line, stop_idx);
+    auto const idx = static_cast<trip_id>(
+        std::upper_bound(col, col + n, latest_arrival) - col);
+    if (idx == 0) {
+      return {{}, {{first_trip_in_line, col[0]}}};
+    } else if (idx != n) {
+      return {{{first_trip_in_line + idx - 1, col[idx - 1]}},
+              {{first_trip_in_line + idx, col[idx]}}};
+    } else {
+      return {{{first_trip_in_line + idx - 1, col[idx - 1]}}, {}};
     }
-    return {
-        {},
-        {{first_trip_in_line, arrival_times_[first_trip_in_line][stop_idx]}}};
+  }
+
+  trip_id line_trip_count(line_id const line) const {
+    return line_to_last_trip_[line] - line_to_first_trip_[line] + 1;
+  }
+
+  std::pair<time const*, trip_id> departure_column(
+      line_id const line, stop_idx_t const stop_idx) const {
+    auto const n = line_trip_count(line);
+    return {departure_columns_.data() + line_columns_[line] + stop_idx * n, n};
+  }
+
+  std::pair<time const*, trip_id> arrival_column(
+      line_id const line, stop_idx_t const stop_idx) const {
+    auto const n = line_trip_count(line);
+    return {arrival_columns_.data() + line_columns_[line] + stop_idx * n, n};
   }
 
   uint64_t trip_count_{};
@@ -166,8 +194,8 @@ struct tb_data {
 
   fws_multimap<motis::time> arrival_times_{};
   shared_idx_fws_multimap<motis::time> departure_times_{arrival_times_.index_};
-  nested_fws_multimap<tb_transfer> transfers_{arrival_times_.index_};
-  nested_fws_multimap<tb_reverse_transfer> reverse_transfers_{
+  compact_transfers<tb_transfer> transfers_{arrival_times_.index_};
+  compact_transfers<tb_reverse_transfer> reverse_transfers_{
       arrival_times_.index_};
 
   shared_idx_fws_multimap<uint8_t, line_id> in_allowed_{stops_on_line_.index_};
@@ -176,6 +204,17 @@ struct tb_data {
       stops_on_line_.index_};
   shared_idx_fws_multimap<uint16_t, line_id> departure_platform_{
       stops_on_line_.index_};
+
+  // Transposed copies of arrival_times_ / departure_times_: the times of all
+  // trips of a line at one stop are stored contiguously (sorted, as trips of
+  // a line do not overtake each other). The column of (line, stop_idx)
+  // starts at line_columns_[line] + stop_idx * line_trip_count(line).
+  mcd::vector<uint64_t> line_columns_;
+  mcd::vector<motis::time> arrival_columns_;
+  mcd::vector<motis::time> departure_columns_;
+
+  // set if the arrays above point into a memory-mapped data file
+  std::unique_ptr<cista::mmap> mapped_file_;
 };
 
 }  // namespace motis::tripbased
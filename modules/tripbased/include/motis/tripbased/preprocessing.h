@@ -1,15 +1,29 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 #include "motis/core/schedule/schedule.h"
 
 #include "motis/tripbased/data.h"
 
 namespace motis::tripbased {
 
-std::unique_ptr<tb_data> build_data(schedule const& sched);
+// Drops transfers (indexed by the stop index of the trip) that are dominated
+// by a transfer into an earlier or equal trip of the same line from the same
+// or a later stop. Returns the number of dropped transfers.
+std::size_t reduce_transfers(std::vector<std::vector<tb_transfer>>& transfers,
+                             mcd::vector<line_id> const& trip_to_line);
+
+std::size_t reduce_reverse_transfers(
+    std::vector<std::vector<tb_reverse_transfer>>& transfers,
+    mcd::vector<line_id> const& trip_to_line);
+
+std::unique_ptr<tb_data> build_data(schedule const& sched, bool reduce = true);
 
 std::unique_ptr<tb_data> load_data(schedule const& sched,
-                                   std::string const& filename);
+                                   std::string const& filename,
+                                   bool use_mmap);
 
 void update_data_file(schedule const& sched, std::string const& filename,
                       bool force_update);
@@ -36,6 +36,8 @@ struct header {
 
   uint64_t trip_count_{};
   uint64_t line_count_{};
+  uint64_t transfer_count_{};
+  uint64_t reverse_transfer_count_{};
 
   // offsets
   array_offset line_to_first_trip_{};
@@ -57,6 +59,10 @@ struct header {
   array_offset out_allowed_data_{};
   array_offset arrival_platform_data_{};
   array_offset departure_platform_data_{};
+
+  array_offset line_columns_{};
+  array_offset arrival_columns_{};
+  array_offset departure_columns_{};
 };
 
 void write_data(tb_data const& data, std::string const& filename,
@@ -67,4 +73,9 @@ bool data_okay_for_schedule(std::string const& filename, schedule const& sched);
 std::unique_ptr<tb_data> read_data(std::string const& filename,
                                    schedule const& sched);
 
+// Maps the data file into memory and uses the arrays in place.
+// The returned tb_data keeps the mapping alive and must not be modified.
+std::unique_ptr<tb_data> map_data(std::string const& filename,
+                                  schedule const& sched);
+
 }  // namespace motis::tripbased::serialization
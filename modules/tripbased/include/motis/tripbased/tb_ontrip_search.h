@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <map>
 #include <optional>
 #include <queue>
@@ -16,6 +17,7 @@
 #include "motis/tripbased/limits.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_search_common.h"
+#include "motis/tripbased/tb_search_workspace.h"
 #include "motis/tripbased/tb_statistics.h"
 
 namespace motis::tripbased {
@@ -35,11 +37,24 @@ struct tb_ontrip_search {
         count_initial_transfer_time_(count_initial_transfer_time),
         count_final_transfer_time_(count_final_transfer_time),
         destination_mode_(dest_mode),
-        destination_arrivals_(data.line_count_),
-        first_reachable_stop_(data.trip_count_,
-                              Dir == search_dir::FWD
-                                  ? std::numeric_limits<stop_idx_t>::max()
-                                  : std::numeric_limits<stop_idx_t>::min()) {}
+        setup_start_(std::chrono::steady_clock::now()),
+        workspace_(acquire_workspace<workspace_t>()),
+        destination_arrivals_((*workspace_).destination_arrivals_),
+        journeys_((*workspace_).journeys_),
+        earliest_arrival_((*workspace_).earliest_arrival_),
+        queues_((*workspace_).queues_),
+        first_reachable_stop_((*workspace_).first_reachable_stop_) {
+    (*workspace_)
+        .reset(data, sched.stations_.size(),
+               Dir == search_dir::FWD ? std::numeric_limits<stop_idx_t>::max()
+                                      : std::numeric_limits<stop_idx_t>::min(),
+               INVALID);
+    stats_.workspace_reused_ = workspace_.reused_ ? 1U : 0U;
+    stats_.workspace_setup_duration_us_ = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - setup_start_)
+            .count());
+  }
 
   void add_start(station_id stop_id, time initial_duration,
                  bool allow_footpaths = true) {
@@ -69,6 +84,7 @@ struct tb_ontrip_search {
   void add_destination(station_id stop_id, bool allow_footpaths = true) {
     assert(stop_id < sched_.stations_.size());
     destination_stations_.push_back(stop_id);
+    (*workspace_).destination_stations_.push_back(stop_id);
     add_destination(
         {stop_id, stop_id,
          count_final_transfer_time_
@@ -86,9 +102,6 @@ struct tb_ontrip_search {
   }
 
   void search() {
-    journeys_.resize(sched_.stations_.size());
-    earliest_arrival_.resize(sched_.stations_.size(), INVALID);
-
     add_direct_walks();
 
     for (auto transfers = 0U; transfers < MAX_TRANSFERS; ++transfers) {
@@ -174,7 +187,7 @@ private:
       if (allowed == 0U) {
         continue;
       }
-      destination_arrivals_[line].emplace_back(line, stop_idx, fp);
+      (*workspace_).add_destination_arrival({line, stop_idx, fp});
     }
   }
 
@@ -430,21 +443,25 @@ private:
                                      : start_time - start_times_[station]);
   }
 
+  using workspace_t = tb_search_workspace<stop_idx_t, time>;
+
   tb_data const& data_;
   schedule const& sched_;
   time const start_time;
   bool count_initial_transfer_time_;
   bool count_final_transfer_time_;
   destination_mode destination_mode_;
+  std::chrono::steady_clock::time_point setup_start_;
+  workspace_lease<workspace_t> workspace_;
   std::vector<station_id> start_stations_;
   std::vector<station_id> destination_stations_;
   std::map<station_id, time> start_times_;
-  std::vector<std::vector<destination_arrival>> destination_arrivals_;
-  std::vector<std::vector<tb_journey>> journeys_;
-  std::vector<time> earliest_arrival_;
+  std::vector<std::vector<destination_arrival>>& destination_arrivals_;
+  std::vector<std::vector<tb_journey>>& journeys_;
+  epoch_vector<time>& earliest_arrival_;
   time total_earliest_arrival_{INVALID};
-  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
-  std::vector<stop_idx_t> first_reachable_stop_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1>& queues_;
+  epoch_vector<stop_idx_t>& first_reachable_stop_;
   tb_statistics stats_{};
 };
 
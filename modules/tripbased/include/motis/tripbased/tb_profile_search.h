@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <map>
 #include <optional>
 #include <queue>
@@ -18,6 +19,7 @@
 #include "motis/tripbased/data.h"
 #include "motis/tripbased/tb_journey.h"
 #include "motis/tripbased/tb_search_common.h"
+#include "motis/tripbased/tb_search_workspace.h"
 #include "motis/tripbased/tb_statistics.h"
 
 #include "motis/tripbased/limits.h"
@@ -58,15 +60,28 @@ struct tb_profile_search {
         count_initial_transfer_time_(count_initial_transfer_time),
         count_final_transfer_time_(count_final_transfer_time),
         destination_mode_(dest_mode),
-        destination_arrivals_(data.line_count_),
+        setup_start_(std::chrono::steady_clock::now()),
+        workspace_(acquire_workspace<workspace_t>()),
+        destination_arrivals_((*workspace_).destination_arrivals_),
+        journeys_((*workspace_).journeys_),
+        earliest_arrival_((*workspace_).earliest_arrival_),
         total_earliest_arrival_(
             array_maker<time, MAX_TRANSFERS + 1>::make_array(INVALID)),
-        first_reachable_stop_(
-            data.trip_count_,
-            array_maker<stop_idx_t, MAX_TRANSFERS + 1>::make_array(
-                Dir == search_dir::FWD
-                    ? std::numeric_limits<stop_idx_t>::max()
-                    : std::numeric_limits<stop_idx_t>::min())) {}
+        queues_((*workspace_).queues_),
+        first_reachable_stop_((*workspace_).first_reachable_stop_) {
+    (*workspace_)
+        .reset(data, sched.stations_.size(),
+               array_maker<stop_idx_t, MAX_TRANSFERS + 1>::make_array(
+                   Dir == search_dir::FWD
+                       ? std::numeric_limits<stop_idx_t>::max()
+                       : std::numeric_limits<stop_idx_t>::min()),
+               array_maker<time, MAX_TRANSFERS + 1>::make_array(INVALID));
+    stats_.workspace_reused_ = workspace_.reused_ ? 1U : 0U;
+    stats_.workspace_setup_duration_us_ = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - setup_start_)
+            .count());
+  }
 
   void add_start(station_id stop_id, time initial_duration,
                  bool allow_footpaths = true) {
@@ -78,6 +93,7 @@ struct tb_profile_search {
   void add_destination(station_id stop_id, bool allow_footpaths = true) {
     assert(stop_id < sched_.stations_.size());
     destination_stations_.push_back(stop_id);
+    (*workspace_).destination_stations_.push_back(stop_id);
     add_destination(
         {stop_id, stop_id,
          count_final_transfer_time_
@@ -95,10 +111,6 @@ struct tb_profile_search {
   }
 
   void search() {
-    earliest_arrival_.resize(
-        sched_.stations_.size(),
-        array_maker<time, MAX_TRANSFERS + 1>::make_array(INVALID));
-    journeys_.resize(sched_.stations_.size());
     if (Dir == search_dir::FWD) {
       for (start_time_ = static_cast<time>(interval_end_ + 1);
            start_time_ >= interval_begin_;
@@ -229,7 +241,7 @@ private:
       if (allowed == 0U) {
         continue;
       }
-      destination_arrivals_[line].emplace_back(line, stop_idx, fp);
+      (*workspace_).add_destination_arrival({line, stop_idx, fp});
     }
   }
 
@@ -542,6 +554,10 @@ private:
     }
   }
 
+  using workspace_t =
+      tb_search_workspace<std::array<stop_idx_t, MAX_TRANSFERS + 1>,
+                          std::array<time, MAX_TRANSFERS + 1>>;
+
   tb_data const& data_;
   schedule const& sched_;
   time interval_begin_, interval_end_;
@@ -550,17 +566,20 @@ private:
   time start_time_{INVALID_TIME};
   time next_iteration_start_time_{INVALID_TIME};
   destination_mode destination_mode_;
+  std::chrono::steady_clock::time_point setup_start_;
+  workspace_lease<workspace_t> workspace_;
   std::vector<std::tuple<station_id, time, bool>> start_stations_;
   std::vector<station_id> destination_stations_;
   std::map<station_id, time> start_times_;
-  std::vector<std::vector<destination_arrival>> destination_arrivals_;
-  std::vector<std::vector<tb_journey>> journeys_;
+  std::vector<std::vector<destination_arrival>>& destination_arrivals_;
+  std::vector<std::vector<tb_journey>>& journeys_;
   std::map<station_id, std::vector<tb_journey>> results_;
   unsigned result_count_{0};
-  std::vector<std::array<time, MAX_TRANSFERS + 1>> earliest_arrival_;
+  epoch_vector<std::array<time, MAX_TRANSFERS + 1>>& earliest_arrival_;
   std::array<time, MAX_TRANSFERS + 1> total_earliest_arrival_;
-  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
-  std::vector<std::array<stop_idx_t, MAX_TRANSFERS + 1>> first_reachable_stop_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1>& queues_;
+  epoch_vector<std::array<stop_idx_t, MAX_TRANSFERS + 1>>&
+      first_reachable_stop_;
   tb_statistics stats_{};
 };
 
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "motis/tripbased/data.h"
+#include "motis/tripbased/limits.h"
+#include "motis/tripbased/tb_journey.h"
+#include "motis/tripbased/tb_search_common.h"
+
+namespace motis::tripbased {
+
+// Vector whose entries are reset lazily: reset() only increments the epoch,
+// entries with an outdated epoch are reinitialized on first access.
+template <typename T>
+struct epoch_vector {
+  void reset(std::size_t const size, T const& default_value) {
+    default_ = default_value;
+    if (values_.size() != size) {
+      values_.resize(size);
+      epochs_.assign(size, 0U);
+      epoch_ = 0U;
+    }
+    if (++epoch_ == 0U) {
+      std::fill(begin(epochs_), end(epochs_), 0U);
+      epoch_ = 1U;
+    }
+  }
+
+  T& operator[](std::size_t const idx) {
+    if (epochs_[idx] != epoch_) {
+      epochs_[idx] = epoch_;
+      values_[idx] = default_;
+    }
+    return values_[idx];
+  }
+
+  std::size_t size() const { return values_.size(); }
+
+  std::vector<T> values_;
+  std::vector<std::uint32_t> epochs_;
+  std::uint32_t epoch_{0U};
+  T default_{};
+};
+
+// Per-query state of the trip-based searches. Workspaces are kept in a
+// thread-local pool and reused by subsequent queries on the same thread.
+template <typename FirstReachable, typename Arrival>
+struct tb_search_workspace {
+  void reset(tb_data const& data, std::size_t const station_count,
+             FirstReachable const& first_reachable, Arrival const& arrival) {
+    first_reachable_stop_.reset(data.trip_count_, first_reachable);
+    earliest_arrival_.reset(station_count, arrival);
+    for (auto& q : queues_) {
+      q.clear();
+    }
+
+    if (destination_arrivals_.size() != data.line_count_) {
+      destination_arrivals_.clear();
+      destination_arrivals_.resize(data.line_count_);
+    } else {
+      for (auto const line : destination_lines_) {
+        destination_arrivals_[line].clear();
+      }
+    }
+    destination_lines_.clear();
+
+    if (journeys_.size() != station_count) {
+      journeys_.clear();
+      journeys_.resize(station_count);
+    } else {
+      for (auto const station : destination_stations_) {
+        journeys_[station].clear();
+      }
+    }
+    destination_stations_.clear();
+  }
+
+  void add_destination_arrival(destination_arrival const& da) {
+    auto& arrivals = destination_arrivals_[da.line_];
+    if (arrivals.empty()) {
+      destination_lines_.push_back(da.line_);
+    }
+    arrivals.push_back(da);
+  }
+
+  epoch_vector<FirstReachable> first_reachable_stop_;
+  epoch_vector<Arrival> earliest_arrival_;
+  std::array<std::vector<queue_entry>, MAX_TRANSFERS + 1> queues_;
+  std::vector<std::vector<destination_arrival>> destination_arrivals_;
+  std::vector<line_id> destination_lines_;
+  std::vector<std::vector<tb_journey>> journeys_;
+  std::vector<station_id> destination_stations_;
+  std::atomic_bool in_use_{false};
+};
+
+template <typename Workspace>
+struct workspace_lease {
+  explicit workspace_lease(Workspace* ws, bool reused)
+      : ws_{ws}, reused_{reused} {}
+  ~workspace_lease() {
+    if (ws_ != nullptr) {
+      ws_->in_use_ = false;
+    }
+  }
+
+  workspace_lease(workspace_lease const&) = delete;
+  workspace_lease& operator=(workspace_lease const&) = delete;
+  workspace_lease(workspace_lease&& o) noexcept
+      : ws_{o.ws_}, reused_{o.reused_} {
+    o.ws_ = nullptr;
+  }
+  workspace_lease& operator=(workspace_lease&&) = delete;
+
+  Workspace& operator*() const { return *ws_; }
+
+  Workspace* ws_;
+  bool reused_;
+};
+
+template <typename Workspace>
+workspace_lease<Workspace> acquire_workspace() {
+  thread_local std::vector<std::unique_ptr<Workspace>> pool;
+  for (auto& ws : pool) {
+    if (!ws->in_use_) {
+      ws->in_use_ = true;
+      return workspace_lease<Workspace>{ws.get(), true};
+    }
+  }
+  auto& ws = pool.emplace_back(std::make_unique<Workspace>());
+  ws->in_use_ = true;
+  return workspace_lease<Workspace>{ws.get(), false};
+}
+
+}  // namespace motis::tripbased
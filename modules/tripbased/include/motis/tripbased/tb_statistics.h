@@ -27,6 +27,8 @@ struct tb_statistics {
   uint64_t all_destinations_reached_{};
   uint64_t total_earliest_arrival_updates_{};
   uint64_t lower_bounds_duration_;
+  uint64_t workspace_setup_duration_us_{};
+  uint64_t workspace_reused_{};
 };
 
 inline stats_category to_stats_category(char const* name,
@@ -58,7 +60,9 @@ inline stats_category to_stats_category(char const* name,
        {"pruned_by_earliest_arrival", s.pruned_by_earliest_arrival_},
        {"all_destinations_reached", s.all_destinations_reached_},
        {"total_earliest_arrival_updates", s.total_earliest_arrival_updates_},
-       {"lower_bounds_duration", s.lower_bounds_duration_}}};
+       {"lower_bounds_duration", s.lower_bounds_duration_},
+       {"workspace_setup_duration_us", s.workspace_setup_duration_us_},
+       {"workspace_reused", s.workspace_reused_}}};
 }
 
 }  // namespace motis::tripbased
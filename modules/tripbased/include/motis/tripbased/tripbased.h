@@ -26,6 +26,7 @@ struct tripbased : public motis::module::module {
 
 private:
   bool use_data_file_{true};
+  bool mmap_data_file_{true};
 
   bool import_successful_{false};
 
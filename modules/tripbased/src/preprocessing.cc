@@ -6,6 +6,8 @@
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "utl/progress_tracker.h"
@@ -73,10 +75,84 @@ edge const* get_incoming_route_edge(node const* route_node) {
   return nullptr;
 }
 
+std::size_t reduce_transfers(std::vector<std::vector<tb_transfer>>& transfers,
+                             mcd::vector<line_id> const& trip_to_line) {
+  // A transfer (trip, i) -> (u, j) is dominated by a transfer
+  // (trip, i') -> (u', j') with i' >= i, u' on the same line as u, j' <= j
+  // and u' <= u: staying on the trip until i' and boarding u' at j' reaches
+  // every stop of u after j no later than u (lines do not overtake).
+  auto dropped = std::size_t{0U};
+  std::unordered_map<line_id, std::vector<tb_transfer>> kept;
+  for (auto i = static_cast<int>(transfers.size()) - 1; i >= 0; --i) {
+    auto& stop_transfers = transfers[i];
+    std::sort(begin(stop_transfers), end(stop_transfers),
+              [&](tb_transfer const& a, tb_transfer const& b) {
+                return std::make_tuple(trip_to_line[a.to_trip_],
+                                       a.to_stop_idx_, a.to_trip_) <
+                       std::make_tuple(trip_to_line[b.to_trip_],
+                                       b.to_stop_idx_, b.to_trip_);
+              });
+    std::vector<tb_transfer> reduced;
+    reduced.reserve(stop_transfers.size());
+    for (auto const& t : stop_transfers) {
+      auto& line_kept = kept[trip_to_line[t.to_trip_]];
+      if (std::any_of(begin(line_kept), end(line_kept),
+                      [&](tb_transfer const& o) {
+                        return o.to_stop_idx_ <= t.to_stop_idx_ &&
+                               o.to_trip_ <= t.to_trip_;
+                      })) {
+        ++dropped;
+        continue;
+      }
+      line_kept.push_back(t);
+      reduced.push_back(t);
+    }
+    stop_transfers = std::move(reduced);
+  }
+  return dropped;
+}
+
+std::size_t reduce_reverse_transfers(
+    std::vector<std::vector<tb_reverse_transfer>>& transfers,
+    mcd::vector<line_id> const& trip_to_line) {
+  // Mirror image of reduce_transfers: (u, j) -> (trip, i) is dominated by
+  // (u', j') -> (trip, i') with i' <= i, u' on the same line as u, j' >= j
+  // and u' >= u.
+  auto dropped = std::size_t{0U};
+  std::unordered_map<line_id, std::vector<tb_reverse_transfer>> kept;
+  for (auto& stop_transfers : transfers) {
+    std::sort(begin(stop_transfers), end(stop_transfers),
+              [&](tb_reverse_transfer const& a, tb_reverse_transfer const& b) {
+                return std::make_tuple(trip_to_line[a.from_trip_],
+                                       b.from_stop_idx_, b.from_trip_) <
+                       std::make_tuple(trip_to_line[b.from_trip_],
+                                       a.from_stop_idx_, a.from_trip_);
+              });
+    std::vector<tb_reverse_transfer> reduced;
+    reduced.reserve(stop_transfers.size());
+    for (auto const& t : stop_transfers) {
+      auto& line_kept = kept[trip_to_line[t.from_trip_]];
+      if (std::any_of(begin(line_kept), end(line_kept),
+                      [&](tb_reverse_transfer const& o) {
+                        return o.from_stop_idx_ >= t.from_stop_idx_ &&
+                               o.from_trip_ >= t.from_trip_;
+                      })) {
+        ++dropped;
+        continue;
+      }
+      line_kept.push_back(t);
+      reduced.push_back(t);
+    }
+    stop_transfers = std::move(reduced);
+  }
+  return dropped;
+}
+
 struct preprocessing {
-  preprocessing(schedule const& sched, tb_data& data)
+  preprocessing(schedule const& sched, tb_data& data, bool const reduce)
       : sched_(sched),
         data_(data),
+        reduce_{reduce},
         progress_tracker_{
             utl::get_active_progress_tracker_or_activate("tripbased")} {}
 
@@ -257,9 +333,39 @@ struct preprocessing {
     utl::verify(data_.lines_at_stop_.finished(), "lines at stop not finished");
     utl::verify(data_.stops_on_line_.finished(), "stops on line not finished");
     utl::verify(data_.arrival_times_.finished(), "arrival times not finished");
+
+    build_time_columns();
     std::cout.imbue(prev_locale);
   }
 
+  void build_time_columns() {
+    scoped_timer timer{"trip-based preprocessing: time columns"};
+    progress_tracker_->status("Init: Time Columns");
+
+    data_.line_columns_.reserve(data_.line_count_ + 1);
+    data_.arrival_columns_.reserve(data_.arrival_times_.data_size());
+    data_.departure_columns_.reserve(data_.departure_times_.data_size());
+    for (line_id line = 0U; line < data_.line_count_; ++line) {
+      data_.line_columns_.push_back(data_.arrival_columns_.size());
+      auto const first_trip = data_.line_to_first_trip_[line];
+      auto const last_trip = data_.line_to_last_trip_[line];
+      for (stop_idx_t stop_idx = 0U; stop_idx < data_.line_stop_count_[line];
+           ++stop_idx) {
+        for (auto trip = first_trip; trip <= last_trip; ++trip) {
+          auto const arr = data_.arrival_times_[trip][stop_idx];
+          auto const dep = data_.departure_times_[trip][stop_idx];
+          utl::verify(trip == first_trip ||
+                          (data_.arrival_columns_.back() <= arr &&
+                           data_.departure_columns_.back() <= dep),
+                      "trips of line {} overtake at stop {}", line, stop_idx);
+          data_.arrival_columns_.push_back(arr);
+          data_.departure_columns_.push_back(dep);
+        }
+      }
+    }
+    data_.line_columns_.push_back(data_.arrival_columns_.size());
+  }
+
   void precompute() {
     precompute_transfers();
     precompute_reverse_transfers();
@@ -296,9 +402,14 @@ struct preprocessing {
     }
     data_.transfers_.finish_map();
 
-    LOG(info) << data_.transfers_.data_size() << " transfers - "
-              << (uturns_ + no_improvements_) << " ignored (" << uturns_
-              << " u-turns + " << no_improvements_ << " no improvements)";
+    LOG(info) << data_.transfers_.transfer_count() << " transfers - "
+              << (uturns_ + no_improvements_ + dominated_) << " ignored ("
+              << uturns_ << " u-turns + " << no_improvements_
+              << " no improvements + " << dominated_ << " dominated)";
+    LOG(info) << "transfers: " << data_.transfers_.byte_size()
+              << " bytes compact, "
+              << data_.transfers_.transfer_count() * sizeof(tb_transfer)
+              << " bytes uncompressed";
     assert(data_.transfers_.finished());
     std::cout.imbue(prev_locale);
   }
@@ -311,6 +422,7 @@ struct preprocessing {
     expected_trip_id_ = 0;
     uturns_ = 0;
     no_improvements_ = 0;
+    dominated_ = 0;
     auto const prev_locale =
         std::cout.imbue(std::locale(std::locale::classic(), new thousands_sep));
     LOG(info) << "precompute reverse transfers: " << data_.trip_count_
@@ -319,7 +431,7 @@ struct preprocessing {
     last_progress_update_ =
         std::chrono::steady_clock::now() - std::chrono::minutes(1);
 
-    data_.reverse_transfers_.reserve_data(data_.transfers_.data_size());
+    data_.reverse_transfers_.reserve_data(data_.transfers_.data_.size());
 
     auto const thread_count = std::thread::hardware_concurrency();
     if (data_.trip_count_ > thread_count) {
@@ -340,9 +452,16 @@ struct preprocessing {
     }
     data_.reverse_transfers_.finish_map();
 
-    LOG(info) << data_.reverse_transfers_.data_size() << " reverse transfers - "
-              << (uturns_ + no_improvements_) << " ignored (" << uturns_
-              << " u-turns + " << no_improvements_ << " no improvements)";
+    LOG(info) << data_.reverse_transfers_.transfer_count()
+              << " reverse transfers - "
+              << (uturns_ + no_improvements_ + dominated_) << " ignored ("
+              << uturns_ << " u-turns + " << no_improvements_
+              << " no improvements + " << dominated_ << " dominated)";
+    LOG(info) << "reverse transfers: " << data_.reverse_transfers_.byte_size()
+              << " bytes compact, "
+              << data_.reverse_transfers_.transfer_count() *
+                     sizeof(tb_reverse_transfer)
+              << " bytes uncompressed";
     assert(data_.reverse_transfers_.finished());
     std::cout.imbue(prev_locale);
   }
@@ -444,6 +563,9 @@ private:
         });
       }
 
+      if (reduce_) {
+        dominated_ += reduce_transfers(transfers, data_.trip_to_line_);
+      }
       add_transfers(trip_idx, std::move(transfers));
     }
   }
@@ -548,6 +670,10 @@ private:
       }
 
       assert(transfers.size() == line_stop_count);
+      if (reduce_) {
+        dominated_ +=
+            reduce_reverse_transfers(transfers, data_.trip_to_line_);
+      }
       add_reverse_transfers(trip_idx, std::move(transfers));
     }
   }
@@ -560,13 +686,9 @@ private:
         [&](trip_id trip,
             std::vector<std::vector<tb_transfer>> const& transfers) {
           for (auto const& stop_transfers : transfers) {
-            for (auto const& t : stop_transfers) {
-              data_.transfers_.push_back(t);
-            }
-            data_.transfers_.finish_nested_key();
+            data_.transfers_.push_back(trip, stop_transfers);
           }
-          data_.transfers_.finish_base_key();
-          update_progress(trip, data_.transfers_.data_size());
+          update_progress(trip, data_.transfers_.transfer_count());
         };
 
     if (trip_idx == expected_trip_id_) {
@@ -593,14 +715,10 @@ private:
         [&](trip_id trip,
             std::vector<std::vector<tb_reverse_transfer>> const& transfers) {
           for (auto const& stop_transfers : transfers) {
-            for (auto const& t : stop_transfers) {
-              data_.reverse_transfers_.push_back(t);
-            }
-            data_.reverse_transfers_.finish_nested_key();
+            data_.reverse_transfers_.push_back(trip, stop_transfers);
           }
-          data_.reverse_transfers_.finish_base_key();
 
-          update_progress(trip, data_.reverse_transfers_.data_size());
+          update_progress(trip, data_.reverse_transfers_.transfer_count());
         };
 
     if (trip_idx == expected_trip_id_) {
@@ -768,9 +886,11 @@ private:
 
   schedule const& sched_;
   tb_data& data_;
+  bool reduce_;
   utl::progress_tracker_ptr progress_tracker_;
   std::atomic<uint64_t> uturns_{0};
   std::atomic<uint64_t> no_improvements_{0};
+  std::atomic<uint64_t> dominated_{0};
   std::mutex transfers_mutex_;
   trip_id expected_trip_id_{0};
   std::map<trip_id, std::vector<std::vector<tb_transfer>>> transfers_queue_;
@@ -781,25 +901,32 @@ private:
   std::chrono::time_point<std::chrono::steady_clock> last_progress_update_;
 };
 
-std::unique_ptr<tb_data> build_data(schedule const& sched) {
+std::unique_ptr<tb_data> build_data(schedule const& sched, bool const reduce) {
   auto data = std::make_unique<tb_data>();
-  preprocessing pp(sched, *data);
+  preprocessing pp(sched, *data, reduce);
   pp.init();
   pp.precompute();
   LOG(info) << "trip-based preprocessing complete:";
   LOG(info) << data->line_count_ << " lines";
   LOG(info) << data->trip_count_ << " trips";
-  LOG(info) << data->transfers_.data_size() << " transfers";
-  LOG(info) << data->reverse_transfers_.data_size() << " reverse transfers";
+  LOG(info) << data->transfers_.transfer_count() << " transfers ("
+            << data->transfers_.byte_size() << " bytes)";
+  LOG(info) << data->reverse_transfers_.transfer_count()
+            << " reverse transfers (" << data->reverse_transfers_.byte_size()
+            << " bytes)";
   return data;
 }
 
 std::unique_ptr<tb_data> load_data(schedule const& sched,
-                                   std::string const& filename) {
+                                   std::string const& filename,
+                                   bool const use_mmap) {
   utl::verify(!filename.empty(), "update_data_file: filename empty");
   utl::verify(fs::exists(filename), "update_data_file: file does not exist {}",
               filename);
-  return serialization::read_data(filename, sched);
+  scoped_timer load_timer{use_mmap ? "trip-based data mapping"
+                                   : "trip-based deserialization"};
+  return use_mmap ? serialization::map_data(filename, sched)
+                  : serialization::read_data(filename, sched);
 }
 
 void update_data_file(schedule const& sched, std::string const& filename,
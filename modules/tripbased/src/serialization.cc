@@ -1,10 +1,13 @@
 #include "motis/tripbased/serialization.h"
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 
 #include "boost/filesystem.hpp"
 
+#include "cista/mmap.h"
+
 #include "utl/enumerate.h"
 #include "utl/to_vec.h"
 #include "utl/verify.h"
@@ -17,7 +20,15 @@ using namespace motis::logging;
 
 namespace motis::tripbased::serialization {
 
-constexpr uint64_t CURRENT_VERSION = 12;
+constexpr uint64_t CURRENT_VERSION = 15;
+
+// All arrays start at a multiple of this so that they can be used in place
+// when the file is memory-mapped.
+constexpr uint64_t ARRAY_ALIGNMENT = 8;
+
+inline uint64_t align(uint64_t const offset) {
+  return (offset + ARRAY_ALIGNMENT - 1) & ~(ARRAY_ALIGNMENT - 1);
+}
 
 struct file {
   file(char const* path, char const* mode) : f_(std::fopen(path, mode)) {
@@ -84,9 +95,10 @@ std::string serialize_schedule_names(schedule const& sched) {
 template <typename T>
 void set_array_offset(uint64_t& current_offset, array_offset& off,
                       mcd::vector<T> const& data) {
-  off.start_ = current_offset;
+  static_assert(alignof(T) <= ARRAY_ALIGNMENT);
+  off.start_ = align(current_offset);
   off.length_ = data.size() * sizeof(T);
-  current_offset += off.length_;
+  current_offset = off.start_ + off.length_;
 }
 
 template <typename T, typename Index>
@@ -98,28 +110,40 @@ void set_fws_multimap_offset(uint64_t& current_offset, fws_multimap_offset& off,
 
 template <typename T, typename Index>
 void set_fws_multimap_offset(uint64_t& current_offset, fws_multimap_offset& off,
-                             nested_fws_multimap<T, Index> const& map) {
+                             compact_transfers<T, Index> const& map) {
   set_array_offset(current_offset, off.index_, map.index_);
   set_array_offset(current_offset, off.data_, map.data_);
 }
 
 template <typename T>
-void write_array(file& f, mcd::vector<T> const& data) {
+void write_array(file& f, uint64_t& current_offset, array_offset const& off,
+                 mcd::vector<T> const& data) {
+  static constexpr char const padding[ARRAY_ALIGNMENT] = {};
+  assert(off.start_ >= current_offset &&
+         off.start_ - current_offset < ARRAY_ALIGNMENT);
+  if (off.start_ != current_offset) {
+    f.write(padding, off.start_ - current_offset);
+  }
   if (!data.empty()) {
     f.write(data.data(), data.size() * sizeof(T));
   }
+  current_offset = off.start_ + off.length_;
 }
 
 template <typename T, typename Index>
-void write_fws_multimap(file& f, fws_multimap<T, Index> const& map) {
-  write_array(f, map.index_);
-  write_array(f, map.data_);
+void write_fws_multimap(file& f, uint64_t& current_offset,
+                        fws_multimap_offset const& off,
+                        fws_multimap<T, Index> const& map) {
+  write_array(f, current_offset, off.index_, map.index_);
+  write_array(f, current_offset, off.data_, map.data_);
 }
 
 template <typename T, typename Index>
-void write_fws_multimap(file& f, nested_fws_multimap<T, Index> const& map) {
-  write_array(f, map.index_);
-  write_array(f, map.data_);
+void write_fws_multimap(file& f, uint64_t& current_offset,
+                        fws_multimap_offset const& off,
+                        compact_transfers<T, Index> const& map) {
+  write_array(f, current_offset, off.index_, map.index_);
+  write_array(f, current_offset, off.data_, map.data_);
 }
 
 void write_data(tb_data const& data, std::string const& filename,
@@ -140,6 +164,8 @@ void write_data(tb_data const& data, std::string const& filename,
   h.schedule_end_ = static_cast<int64_t>(sched.schedule_end_);
   h.trip_count_ = data.trip_count_;
   h.line_count_ = data.line_count_;
+  h.transfer_count_ = data.transfers_.count_;
+  h.reverse_transfer_count_ = data.reverse_transfers_.count_;
 
   uint64_t offset = sizeof(header);
 
@@ -168,27 +194,38 @@ void write_data(tb_data const& data, std::string const& filename,
   set_array_offset(offset, h.departure_platform_data_,
                    data.departure_platform_.data_);
 
-  f.write(&h, sizeof(header));
+  set_array_offset(offset, h.line_columns_, data.line_columns_);
+  set_array_offset(offset, h.arrival_columns_, data.arrival_columns_);
+  set_array_offset(offset, h.departure_columns_, data.departure_columns_);
 
-  write_array(f, data.line_to_first_trip_);
-  write_array(f, data.line_to_last_trip_);
-  write_array(f, data.trip_to_line_);
-  write_array(f, data.line_stop_count_);
-
-  write_fws_multimap(f, data.footpaths_);
-  write_fws_multimap(f, data.reverse_footpaths_);
-  write_fws_multimap(f, data.lines_at_stop_);
-  write_fws_multimap(f, data.stops_on_line_);
-
-  write_fws_multimap(f, data.arrival_times_);
-  write_array(f, data.departure_times_.data_);
-  write_fws_multimap(f, data.transfers_);
-  write_fws_multimap(f, data.reverse_transfers_);
-
-  write_array(f, data.in_allowed_.data_);
-  write_array(f, data.out_allowed_.data_);
-  write_array(f, data.arrival_platform_.data_);
-  write_array(f, data.departure_platform_.data_);
+  f.write(&h, sizeof(header));
+  offset = sizeof(header);
+
+  write_array(f, offset, h.line_to_first_trip_, data.line_to_first_trip_);
+  write_array(f, offset, h.line_to_last_trip_, data.line_to_last_trip_);
+  write_array(f, offset, h.trip_to_line_, data.trip_to_line_);
+  write_array(f, offset, h.line_stop_count_, data.line_stop_count_);
+
+  write_fws_multimap(f, offset, h.footpaths_, data.footpaths_);
+  write_fws_multimap(f, offset, h.reverse_footpaths_, data.reverse_footpaths_);
+  write_fws_multimap(f, offset, h.lines_at_stop_, data.lines_at_stop_);
+  write_fws_multimap(f, offset, h.stops_on_line_, data.stops_on_line_);
+
+  write_fws_multimap(f, offset, h.arrival_times_, data.arrival_times_);
+  write_array(f, offset, h.departure_times_data_, data.departure_times_.data_);
+  write_fws_multimap(f, offset, h.transfers_, data.transfers_);
+  write_fws_multimap(f, offset, h.reverse_transfers_, data.reverse_transfers_);
+
+  write_array(f, offset, h.in_allowed_data_, data.in_allowed_.data_);
+  write_array(f, offset, h.out_allowed_data_, data.out_allowed_.data_);
+  write_array(f, offset, h.arrival_platform_data_,
+              data.arrival_platform_.data_);
+  write_array(f, offset, h.departure_platform_data_,
+              data.departure_platform_.data_);
+
+  write_array(f, offset, h.line_columns_, data.line_columns_);
+  write_array(f, offset, h.arrival_columns_, data.arrival_columns_);
+  write_array(f, offset, h.departure_columns_, data.departure_columns_);
 }
 
 template <typename T>
@@ -207,11 +244,41 @@ void read_fws_multimap(file& f, fws_multimap_offset const& off,
 
 template <typename T, typename Index>
 void read_fws_multimap(file& f, fws_multimap_offset const& off,
-                       nested_fws_multimap<T, Index>& map) {
+                       compact_transfers<T, Index>& map) {
   read_array(f, off.index_, map.index_);
   read_array(f, off.data_, map.data_);
 }
 
+template <typename T>
+void map_array(cista::mmap const& mem, array_offset const& off,
+               mcd::vector<T>& data) {
+  utl::verify(off.length_ % sizeof(T) == 0 &&
+                  off.start_ + off.length_ <= mem.size(),
+              "trip-based data file: array out of bounds");
+  auto const ptr = mem.data() + off.start_;
+  utl::verify(reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) == 0,
+              "trip-based data file: misaligned array");
+  data.el_ = reinterpret_cast<T*>(const_cast<char*>(ptr));  // NOLINT
+  data.used_size_ = static_cast<decltype(data.used_size_)>(off.length_ /
+                                                           sizeof(T));
+  data.allocated_size_ = data.used_size_;
+  data.self_allocated_ = false;
+}
+
+template <typename T, typename Index>
+void map_fws_multimap(cista::mmap const& mem, fws_multimap_offset const& off,
+                      fws_multimap<T, Index>& map) {
+  map_array(mem, off.index_, map.index_);
+  map_array(mem, off.data_, map.data_);
+}
+
+template <typename T, typename Index>
+void map_fws_multimap(cista::mmap const& mem, fws_multimap_offset const& off,
+                      compact_transfers<T, Index>& map) {
+  map_array(mem, off.index_, map.index_);
+  map_array(mem, off.data_, map.data_);
+}
+
 bool data_okay_for_schedule(header const& h, schedule const& sched) {
   if (h.version_ != CURRENT_VERSION) {
     LOG(info) << "trip-based data file is old version (" << h.version_
@@ -283,6 +350,8 @@ std::unique_ptr<tb_data> read_data(std::string const& filename,
 
   data->trip_count_ = h.trip_count_;
   data->line_count_ = h.line_count_;
+  data->transfers_.count_ = h.transfer_count_;
+  data->reverse_transfers_.count_ = h.reverse_transfer_count_;
 
   read_array(f, h.line_to_first_trip_, data->line_to_first_trip_);
   read_array(f, h.line_to_last_trip_, data->line_to_last_trip_);
@@ -304,6 +373,59 @@ std::unique_ptr<tb_data> read_data(std::string const& filename,
   read_array(f, h.arrival_platform_data_, data->arrival_platform_.data_);
   read_array(f, h.departure_platform_data_, data->departure_platform_.data_);
 
+  read_array(f, h.line_columns_, data->line_columns_);
+  read_array(f, h.arrival_columns_, data->arrival_columns_);
+  read_array(f, h.departure_columns_, data->departure_columns_);
+
+  return data;
+}
+
+std::unique_ptr<tb_data> map_data(std::string const& filename,
+                                  schedule const& sched) {
+  utl::verify(fs::exists(filename), "map_data: does not exist: {}", filename);
+
+  auto mem = std::make_unique<cista::mmap>(filename.c_str(),
+                                           cista::mmap::protection::READ);
+  utl::verify(mem->size() >= sizeof(header),
+              "trip-based data file does not contain header");
+
+  header h{};
+  std::memcpy(&h, mem->data(), sizeof(header));
+  utl::verify(data_okay_for_schedule(h, sched),
+              "trip-based data file not valid for schedule");
+
+  auto data = std::make_unique<tb_data>();
+
+  data->trip_count_ = h.trip_count_;
+  data->line_count_ = h.line_count_;
+  data->transfers_.count_ = h.transfer_count_;
+  data->reverse_transfers_.count_ = h.reverse_transfer_count_;
+
+  map_array(*mem, h.line_to_first_trip_, data->line_to_first_trip_);
+  map_array(*mem, h.line_to_last_trip_, data->line_to_last_trip_);
+  map_array(*mem, h.trip_to_line_, data->trip_to_line_);
+  map_array(*mem, h.line_stop_count_, data->line_stop_count_);
+
+  map_fws_multimap(*mem, h.footpaths_, data->footpaths_);
+  map_fws_multimap(*mem, h.reverse_footpaths_, data->reverse_footpaths_);
+  map_fws_multimap(*mem, h.lines_at_stop_, data->lines_at_stop_);
+  map_fws_multimap(*mem, h.stops_on_line_, data->stops_on_line_);
+
+  map_fws_multimap(*mem, h.arrival_times_, data->arrival_times_);
+  map_array(*mem, h.departure_times_data_, data->departure_times_.data_);
+  map_fws_multimap(*mem, h.transfers_, data->transfers_);
+  map_fws_multimap(*mem, h.reverse_transfers_, data->reverse_transfers_);
+
+  map_array(*mem, h.in_allowed_data_, data->in_allowed_.data_);
+  map_array(*mem, h.out_allowed_data_, data->out_allowed_.data_);
+  map_array(*mem, h.arrival_platform_data_, data->arrival_platform_.data_);
+  map_array(*mem, h.departure_platform_data_, data->departure_platform_.data_);
+
+  map_array(*mem, h.line_columns_, data->line_columns_);
+  map_array(*mem, h.arrival_columns_, data->arrival_columns_);
+  map_array(*mem, h.departure_columns_, data->departure_columns_);
+
+  data->mapped_file_ = std::move(mem);
   return data;
 }
 
@@ -251,6 +251,14 @@ struct tripbased::impl {
     auto const query = build_tb_query(req, sched_);
 
     auto res = route_dispatch(query, sched_);
+    res.stats_.emplace_back(stats_category{
+        "tripbased.transfers",
+        {{"transfer_count", tb_data_->transfers_.transfer_count()},
+         {"transfer_bytes", tb_data_->transfers_.byte_size()},
+         {"reverse_transfer_count",
+          tb_data_->reverse_transfers_.transfer_count()},
+         {"reverse_transfer_bytes",
+          tb_data_->reverse_transfers_.byte_size()}}});
 
     message_creator fbb;
     auto stats =
@@ -425,8 +433,10 @@ struct tripbased::impl {
       res.interval_end_ = q.interval_end_;
     }
 
+    auto total_workspace_setup_duration = uint64_t{0};
     for (auto& tbs : tb_stats) {
       tbs.lower_bounds_duration_ = lower_bounds_duration;
+      total_workspace_setup_duration += tbs.workspace_setup_duration_us_;
     }
 
     res.stats_.emplace_back(to_stats_category("tripbased", tb_stats.back()));
@@ -440,7 +450,9 @@ struct tripbased::impl {
           static_cast<uint64_t>(extended_initial_interval)},
          {"results_outside_of_interval", results_outside_of_interval},
          {"results_in_query_interval",
-          static_cast<uint64_t>(results_in_query_interval)}}});
+          static_cast<uint64_t>(results_in_query_interval)},
+         {"total_workspace_setup_duration_us",
+          total_workspace_setup_duration}}});
 
     return res;
   }
@@ -637,6 +649,9 @@ struct import_state {
 tripbased::tripbased() : module("Trip-Based Routing Options", "tripbased") {
   param(use_data_file_, "use_data_file",
         "create a data_file to speed up subsequent loading");
+  param(mmap_data_file_, "mmap_data_file",
+        "memory-map the data_file instead of reading it (shared between "
+        "processes)");
 }
 
 tripbased::~tripbased() = default;
@@ -679,7 +694,8 @@ void tripbased::init(motis::module::registry& reg) {
       auto const filename =
           get_data_directory() / "tripbased" / "tripbased.bin";
       impl_ = std::make_unique<impl>(
-          get_sched(), load_data(get_sched(), filename.generic_string()));
+          get_sched(), load_data(get_sched(), filename.generic_string(),
+                                  mmap_data_file_));
     } else {
       impl_ = std::make_unique<impl>(get_sched(), build_data(get_sched()));
     }
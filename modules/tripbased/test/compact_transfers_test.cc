@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "motis/tripbased/data.h"
+
+using namespace motis;
+using namespace motis::tripbased;
+
+TEST(tripbased_compact_transfers, roundtrip) {
+  // two trips: trip 0 with 3 stops, trip 1 with 2 stops
+  mcd::vector<uint64_t> base_index{0U, 3U, 5U};
+  compact_transfers<tb_transfer> transfers{base_index};
+
+  transfers.push_back(0U, {});
+  transfers.push_back(0U, {{1000U, 2U}, {1U, 0U}, {1000U, 1U}});
+  transfers.push_back(0U, {{0U, 5U}});
+  transfers.push_back(1U, {{0U, 300U}});
+  transfers.push_back(1U, {});
+  transfers.finish_map();
+
+  EXPECT_EQ(5U, transfers.transfer_count());
+  EXPECT_TRUE(transfers.at(0U, 0U).empty());
+  EXPECT_TRUE(transfers.at(1U, 1U).empty());
+
+  std::vector<std::pair<trip_id, stop_idx_t>> decoded;
+  for (auto const& t : transfers.at(0U, 1U)) {
+    decoded.emplace_back(t.to_trip_, t.to_stop_idx_);
+  }
+  EXPECT_EQ((std::vector<std::pair<trip_id, stop_idx_t>>{
+                {1U, 0U}, {1000U, 1U}, {1000U, 2U}}),
+            decoded);
+
+  ASSERT_EQ(1U, transfers.at(1U, 0U).size());
+  auto const t = *transfers.at(1U, 0U).begin();
+  EXPECT_EQ(0U, t.to_trip_);
+  EXPECT_EQ(300U, t.to_stop_idx_);
+}
+
+TEST(tripbased_compact_transfers, reverse) {
+  mcd::vector<uint64_t> base_index{0U, 2U};
+  compact_transfers<tb_reverse_transfer> transfers{base_index};
+
+  transfers.push_back(0U, {});
+  transfers.push_back(0U, {{7U, 3U, 1U}});
+  transfers.finish_map();
+
+  auto const t = *transfers.at(0U, 1U).begin();
+  EXPECT_EQ(7U, t.from_trip_);
+  EXPECT_EQ(3U, t.from_stop_idx_);
+  EXPECT_EQ(1U, t.to_stop_idx_);
+}
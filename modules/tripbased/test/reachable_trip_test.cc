@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "motis/core/common/timing.h"
+
+#include "motis/tripbased/data.h"
+
+using namespace motis;
+using namespace motis::tripbased;
+
+namespace {
+
+using trip_time = std::optional<std::pair<trip_id, motis::time>>;
+
+// Row-major times ([trip][stop_idx]) of all lines and the transposed columns
+// in tb_data. Line 0 has 3 trips, line 1 has trip_count trips.
+struct synthetic_lines {
+  synthetic_lines(trip_id const trip_count, stop_idx_t const stop_count) {
+    auto const add_line = [&](trip_id const n, motis::time const first_dep,
+                              motis::time const headway) {
+      auto const first_trip = static_cast<trip_id>(arr_.size());
+      data_.line_to_first_trip_.push_back(first_trip);
+      data_.line_to_last_trip_.push_back(first_trip + n - 1);
+      data_.line_stop_count_.push_back(stop_count);
+      for (auto i = trip_id{0U}; i != n; ++i) {
+        arr_.emplace_back();
+        dep_.emplace_back();
+        for (auto s = stop_idx_t{0U}; s != stop_count; ++s) {
+          auto const t = static_cast<motis::time>(first_dep + i * headway +
+                                                  s * 5U);
+          arr_.back().push_back(t);
+          dep_.back().push_back(static_cast<motis::time>(t + 1U));
+        }
+      }
+      data_.line_columns_.push_back(data_.arrival_columns_.size());
+      for (auto s = stop_idx_t{0U}; s != stop_count; ++s) {
+        for (auto trip = first_trip; trip != first_trip + n; ++trip) {
+          data_.arrival_columns_.push_back(arr_[trip][s]);
+          data_.departure_columns_.push_back(dep_[trip][s]);
+        }
+      }
+    };
+
+    add_line(3U, 100U, 60U);
+    add_line(trip_count, 200U, 10U);
+    data_.line_columns_.push_back(data_.arrival_columns_.size());
+    data_.line_count_ = 2U;
+    data_.trip_count_ = arr_.size();
+  }
+
+  // Linear scans over the trips of the line (lookup before the time columns).
+  trip_time first_reachable_scan(line_id const line, stop_idx_t const stop_idx,
+                                 motis::time const earliest_departure) const {
+    for (auto trip = data_.line_to_first_trip_[line];
+         trip <= data_.line_to_last_trip_[line]; ++trip) {
+      if (dep_[trip][stop_idx] >= earliest_departure) {
+        return {{trip, dep_[trip][stop_idx]}};
+      }
+    }
+    return {};
+  }
+
+  trip_time last_reachable_scan(line_id const line, stop_idx_t const stop_idx,
+                                motis::time const latest_arrival) const {
+    for (auto trip = static_cast<int64_t>(data_.line_to_last_trip_[line]);
+         trip >= static_cast<int64_t>(data_.line_to_first_trip_[line]);
+         --trip) {
+      if (arr_[trip][stop_idx] <= latest_arrival) {
+        return {{static_cast<trip_id>(trip), arr_[trip][stop_idx]}};
+      }
+    }
+    return {};
+  }
+
+  tb_data data_;
+  std::vector<std::vector<motis::time>> arr_, dep_;
+};
+
+// Time of the trip at the stop, if the trip belongs to the line.
+trip_time trip_at(synthetic_lines const& l, line_id const line,
+                  int64_t const trip, stop_idx_t const stop_idx,
+                  bool const departure) {
+  if (trip < l.data_.line_to_first_trip_[line] ||
+      trip > l.data_.line_to_last_trip_[line]) {
+    return {};
+  }
+  auto const& times = departure ? l.dep_ : l.arr_;
+  return {{static_cast<trip_id>(trip), times[trip][stop_idx]}};
+}
+
+}  // namespace
+
+TEST(tripbased_reachable_trip, matches_linear_scan) {
+  auto const l = synthetic_lines{50U, 4U};
+  for (auto line = line_id{0U}; line != 2U; ++line) {
+    for (auto s = stop_idx_t{0U}; s != 4U; ++s) {
+      for (auto t = motis::time{0U}; t != 1000U; ++t) {
+        auto const first = l.first_reachable_scan(line, s, t);
+        EXPECT_EQ(first, l.data_.first_reachable_trip(line, s, t));
+
+        auto const [first2, prev] =
+            l.data_.first_and_previous_reachable_trip(line, s, t);
+        EXPECT_EQ(first, first2);
+        auto const prev_trip =
+            first ? int64_t{first->first} - 1
+                  : int64_t{l.data_.line_to_last_trip_[line]};
+        EXPECT_EQ(trip_at(l, line, prev_trip, s, true), prev);
+
+        auto const last = l.last_reachable_scan(line, s, t);
+        EXPECT_EQ(last, l.data_.last_reachable_trip(line, s, t));
+
+        auto const [last2, next] =
+            l.data_.last_and_next_reachable_trip(line, s, t);
+        EXPECT_EQ(last, last2);
+        auto const next_trip =
+            last ? int64_t{last->first} + 1
+                 : int64_t{l.data_.line_to_first_trip_[line]};
+        EXPECT_EQ(trip_at(l, line, next_trip, s, false), next);
+      }
+    }
+  }
+}
+
+// Compares the binary search to the linear scan.
+TEST(tripbased_reachable_trip, DISABLED_timing) {
+  constexpr auto const kTrips = trip_id{4000U};
+  constexpr auto const kStops = stop_idx_t{10U};
+  constexpr auto const kQueries = 200'000U;
+
+  auto const l = synthetic_lines{kTrips, kStops};
+
+  std::mt19937 gen{42U};
+  std::uniform_int_distribution<unsigned> stop_dist{0U, kStops - 1U};
+  std::uniform_int_distribution<unsigned> time_dist{0U, 200U + kTrips * 10U};
+  std::vector<std::pair<stop_idx_t, motis::time>> queries(kQueries);
+  for (auto& [s, t] : queries) {
+    s = static_cast<stop_idx_t>(stop_dist(gen));
+    t = static_cast<motis::time>(time_dist(gen));
+  }
+
+  auto scan_sum = uint64_t{0U};
+  MOTIS_START_TIMING(scan_timing);
+  for (auto const& [s, t] : queries) {
+    if (auto const r = l.first_reachable_scan(1U, s, t); r) {
+      scan_sum += r->first;
+    }
+  }
+  MOTIS_STOP_TIMING(scan_timing);
+
+  auto search_sum = uint64_t{0U};
+  MOTIS_START_TIMING(search_timing);
+  for (auto const& [s, t] : queries) {
+    if (auto const r = l.data_.first_reachable_trip(1U, s, t); r) {
+      search_sum += r->first;
+    }
+  }
+  MOTIS_STOP_TIMING(search_timing);
+
+  EXPECT_EQ(scan_sum, search_sum);
+  RecordProperty("linear_scan_ms",
+                 static_cast<int>(MOTIS_TIMING_MS(scan_timing)));
+  RecordProperty("binary_search_ms",
+                 static_cast<int>(MOTIS_TIMING_MS(search_timing)));
+}
@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "motis/core/access/time_access.h"
+
+#include "motis/tripbased/data.h"
+#include "motis/tripbased/preprocessing.h"
+#include "motis/tripbased/tb_ontrip_search.h"
+
+#include "motis/test/motis_instance_test.h"
+
+using namespace motis;
+using namespace motis::test;
+using namespace motis::tripbased;
+
+namespace {
+
+using transfer_list = std::vector<std::pair<trip_id, stop_idx_t>>;
+
+// destination, start time, arrival time, transfers
+using result_list =
+    std::vector<std::tuple<station_id, motis::time, motis::time, unsigned>>;
+
+template <typename Range>
+transfer_list to_list(Range const& transfers) {
+  transfer_list l;
+  for (auto const& t : transfers) {
+    l.emplace_back(t.other_trip(), t.other_stop_idx());
+  }
+  std::sort(begin(l), end(l));
+  return l;
+}
+
+}  // namespace
+
+TEST(tripbased_transfer_reduction, dominated_transfers) {
+  // trip 0 (line 0) with 3 stops, trips 1 and 2 on line 1, trip 3 on line 2
+  mcd::vector<line_id> trip_to_line{0U, 1U, 1U, 2U};
+  std::vector<std::vector<tb_transfer>> transfers{
+      {{2U, 1U}, {1U, 2U}, {3U, 0U}}, {{1U, 1U}}, {}};
+
+  // (2, 1) and (1, 2) at stop 0 are dominated by (1, 1) at stop 1
+  EXPECT_EQ(2U, reduce_transfers(transfers, trip_to_line));
+  EXPECT_EQ((transfer_list{{3U, 0U}}), to_list(transfers[0]));
+  EXPECT_EQ((transfer_list{{1U, 1U}}), to_list(transfers[1]));
+  EXPECT_TRUE(transfers[2].empty());
+
+  // same stop: an earlier trip boarded at an earlier stop wins
+  std::vector<std::vector<tb_transfer>> same_stop{{{2U, 2U}, {1U, 1U}}};
+  EXPECT_EQ(1U, reduce_transfers(same_stop, trip_to_line));
+  EXPECT_EQ((transfer_list{{1U, 1U}}), to_list(same_stop[0]));
+
+  // neither dominates the other: later trip, but earlier stop
+  std::vector<std::vector<tb_transfer>> incomparable{{{2U, 0U}}, {{1U, 1U}}};
+  EXPECT_EQ(0U, reduce_transfers(incomparable, trip_to_line));
+  EXPECT_EQ((transfer_list{{2U, 0U}}), to_list(incomparable[0]));
+}
+
+TEST(tripbased_transfer_reduction, dominated_reverse_transfers) {
+  mcd::vector<line_id> trip_to_line{0U, 1U, 1U, 2U};
+  std::vector<std::vector<tb_reverse_transfer>> transfers{
+      {}, {{2U, 1U, 1U}}, {{1U, 0U, 2U}, {2U, 0U, 2U}, {3U, 4U, 2U}}};
+
+  // (1, 0) and (2, 0) at stop 2 are dominated by (2, 1) at stop 1
+  EXPECT_EQ(2U, reduce_reverse_transfers(transfers, trip_to_line));
+  EXPECT_TRUE(transfers[0].empty());
+  EXPECT_EQ((transfer_list{{2U, 1U}}), to_list(transfers[1]));
+  EXPECT_EQ((transfer_list{{3U, 4U}}), to_list(transfers[2]));
+}
+
+struct tripbased_transfer_reduction_schedule : public motis_instance_test {
+  tripbased_transfer_reduction_schedule()
+      : motis::test::motis_instance_test(loader::loader_options{
+            .dataset_ = {"modules/tripbased/test_resources/schedule"},
+            .schedule_begin_ = "20151121"}) {}
+
+  template <search_dir Dir>
+  result_list route(tb_data const& data, station_id const from,
+                    motis::time const start) {
+    tb_ontrip_search<Dir> tbs(data, sched(), start, false, false,
+                              destination_mode::ALL);
+    tbs.add_start(from, 0);
+    for (auto to = 0U; to != sched().stations_.size(); ++to) {
+      if (to != from) {
+        tbs.add_destination(to);
+      }
+    }
+    tbs.search();
+
+    result_list results;
+    for (auto to = 0U; to != sched().stations_.size(); ++to) {
+      if (to == from) {
+        continue;
+      }
+      for (auto const& j : tbs.get_results(to, false)) {
+        results.emplace_back(to, j.start_time_, j.arrival_time_,
+                             j.transfers_);
+      }
+    }
+    std::sort(begin(results), end(results));
+    return results;
+  }
+};
+
+TEST_F(tripbased_transfer_reduction_schedule, query_results_unchanged) {
+  auto const full = build_data(sched(), false);
+  auto const reduced = build_data(sched(), true);
+
+  ASSERT_EQ(full->trip_count_, reduced->trip_count_);
+  EXPECT_LE(reduced->transfers_.transfer_count(),
+            full->transfers_.transfer_count());
+  EXPECT_LE(reduced->reverse_transfers_.transfer_count(),
+            full->reverse_transfers_.transfer_count());
+
+  // reduction only drops transfers
+  for (auto trip = trip_id{0U}; trip != full->trip_count_; ++trip) {
+    auto const stop_count = full->line_stop_count_[full->trip_to_line_[trip]];
+    for (auto stop_idx = stop_idx_t{0U}; stop_idx != stop_count; ++stop_idx) {
+      auto const full_transfers = to_list(full->transfers_.at(trip, stop_idx));
+      for (auto const& t : to_list(reduced->transfers_.at(trip, stop_idx))) {
+        EXPECT_TRUE(std::binary_search(begin(full_transfers),
+                                       end(full_transfers), t));
+      }
+      auto const full_reverse =
+          to_list(full->reverse_transfers_.at(trip, stop_idx));
+      for (auto const& t :
+           to_list(reduced->reverse_transfers_.at(trip, stop_idx))) {
+        EXPECT_TRUE(
+            std::binary_search(begin(full_reverse), end(full_reverse), t));
+      }
+    }
+  }
+
+  for (auto from = 0U; from != sched().stations_.size(); ++from) {
+    for (auto hhmm = 1400; hhmm <= 2000; hhmm += 100) {
+      auto const start = unix_to_motistime(sched(), unix_time(hhmm));
+      EXPECT_EQ(route<search_dir::FWD>(*full, from, start),
+                route<search_dir::FWD>(*reduced, from, start));
+      EXPECT_EQ(route<search_dir::BWD>(*full, from, start),
+                route<search_dir::BWD>(*reduced, from, start));
+    }
+  }
+}